@@ -1,6 +1,11 @@
+#include <string.h>
 #include "AST.h"
 int indentValue = 2;
 
+#define AST_POOL_INITIAL_CAPACITY 1024
+
+ASTPool astPool = {NULL, 0, 0};
+
 void printIndent(int level)
 {
     for (int i = 0; i < level - 1; i++)
@@ -9,8 +14,9 @@ void printIndent(int level)
     }
 }
 
-void traverseAST(ASTNode *node, int level)
+void traverseAST(NodeIndex index, int level)
 {
+    ASTNode *node = getNode(index);
     if (!node)
     {
         printf("Nothing to traverse\n");
@@ -31,36 +37,33 @@ void traverseAST(ASTNode *node, int level)
     case NodeType_VarDeclList:
         printIndent(level);
         printf("VarDeclList\n");
-        traverseAST(node->varDeclList.varDecl, level + 1);
-        traverseAST(node->varDeclList.varDeclList, level + 1);
+        for (int i = 0; i < node->varDeclList.count; i++)
+        {
+            traverseAST(node->varDeclList.items[i], level + 1);
+        }
         break;
     case NodeType_VarDecl:
         printIndent(level);
-        printf("VarDecl: %s %s\n", node->varDecl.varType, node->varDecl.varName);
+        printf("VarDecl: %s %s\n", dataTypeName(node->dataType), node->varDecl.varName);
         break;
     case NodeType_SimpleExpr:
         printIndent(level);
-        if (node->simpleExpr.isFloat)
+        if (node->dataType == DataType_Float)
             printf("SimpleExpr (float): %f\n", node->simpleExpr.floatValue);
         else
             printf("SimpleExpr (int): %d\n", node->simpleExpr.number);
         break;
     case NodeType_SimpleID:
         printIndent(level);
-        printf("SimpleID: %d\n", node->simpleID.name);
-        printf("%s\n", node->simpleID.name);
-        break;
-    case NodeType_Expr:
-        printIndent(level);
-        printf("Expr: %c\n", node->expr.operator);
-        traverseAST(node->expr.left, level + 1);
-        traverseAST(node->expr.right, level + 1);
+        printf("SimpleID: %s\n", node->simpleID.name);
         break;
     case NodeType_StmtList:
         printIndent(level);
         printf("StmtList\n");
-        traverseAST(node->stmtList.stmt, level + 1);
-        traverseAST(node->stmtList.stmtList, level + 1);
+        for (int i = 0; i < node->stmtList.count; i++)
+        {
+            traverseAST(node->stmtList.items[i], level + 1);
+        }
         break;
     case NodeType_AssignStmt:
         printIndent(level);
@@ -111,7 +114,7 @@ void traverseAST(ASTNode *node, int level)
         traverseAST(node->block.stmtList, level + 1);
         break;
     case NodeType_ArrayDecl:
-        printf("ArrayDecl: %s %s[%d]\n", node->arrayDecl.varType, node->arrayDecl.varName, node->arrayDecl.size);
+        printf("ArrayDecl: %s %s[%d]\n", dataTypeName(node->dataType), node->arrayDecl.varName, node->arrayDecl.size);
         break;
     case NodeType_ArrayAssign:
         printf("ArrayAssign: %s[...]=...\n", node->arrayAssign.arrayName);
@@ -125,185 +128,89 @@ void traverseAST(ASTNode *node, int level)
     }
 }
 
-void freeAST(ASTNode *node)
+// Drop every node created at or after mark so the pool slots are reused;
+// streaming mode does this once a top-level statement is compiled
+void releaseNodesFrom(NodeIndex mark)
 {
-    if (!node)
-        return;
-
-    switch (node->type)
+    // Names are interned and children are pool indices, so only the list
+    // vectors and the pool itself own memory
+    for (uint32_t i = mark > 0 ? mark : 1; i < astPool.count; i++)
     {
-    case NodeType_Program:
-        freeAST(node->program.varDeclList);
-        freeAST(node->program.block);
-        break;
-    case NodeType_VarDeclList:
-        freeAST(node->varDeclList.varDecl);
-        freeAST(node->varDeclList.varDeclList);
-        break;
-    case NodeType_VarDecl:
-        free(node->varDecl.varType); // Free the dynamically allocated string
-        free(node->varDecl.varName); // Free the dynamically allocated string
-        break;
-    case NodeType_SimpleExpr:
-        // No dynamic allocation, nothing to free
-        break;
-    case NodeType_SimpleID:
-        free(node->simpleID.name); // Free the dynamically allocated string
-        break;
-    case NodeType_Expr:
-        freeAST(node->expr.left);
-        freeAST(node->expr.right);
-        break;
-    case NodeType_StmtList:
-        freeAST(node->stmtList.stmt);
-        freeAST(node->stmtList.stmtList);
-        break;
-    case NodeType_AssignStmt:
-        free(node->assignStmt.varName);  // Free the dynamically allocated string
-        free(node->assignStmt.operator); // Free the dynamically allocated string
-        freeAST(node->assignStmt.expr);
-        break;
-    case NodeType_BinOp:
-        freeAST(node->binOp.left);
-        freeAST(node->binOp.right);
-        break;
-    case NodeType_LogicalOp:
-        free(node->logicalOp.logicalOp); // Free the dynamically allocated string
-        freeAST(node->logicalOp.left);
-        freeAST(node->logicalOp.right);
-        break;
-    case NodeType_WriteStmt:
-        freeAST(node->writeStmt.expr);
-        break;
-    case NodeType_IfStmt:
-        freeAST(node->ifStmt.condition);
-        freeAST(node->ifStmt.thenBlock);
-        freeAST(node->ifStmt.elseBlock);
-        break;
-    case NodeType_WhileStmt:
-        freeAST(node->whileStmt.condition);
-        freeAST(node->whileStmt.block);
-        break;
-    case NodeType_ReturnStmt:
-        freeAST(node->returnStmt.expr);
-        break;
-    case NodeType_Block:
-        freeAST(node->block.stmtList);
-        break;
-    case NodeType_ArrayDecl:
-        free(node->arrayDecl.varType);
-        free(node->arrayDecl.varName);
-        break;
-    case NodeType_ArrayAssign:
-        free(node->arrayAssign.arrayName);
-        freeAST(node->arrayAssign.index);
-        freeAST(node->arrayAssign.expr);
-        break;
-    case NodeType_ArrayAccess:
-        free(node->arrayAccess.arrayName);
-        freeAST(node->arrayAccess.index);
-        break;
+        ASTNode *node = &astPool.nodes[i];
+        if (node->type == NodeType_VarDeclList)
+            free(node->varDeclList.items);
+        else if (node->type == NodeType_StmtList)
+            free(node->stmtList.items);
     }
+    if (mark < astPool.count)
+        astPool.count = mark > 0 ? mark : 1;
+}
 
-    free(node); // Free the current node itself
+void freeAST()
+{
+    releaseNodesFrom(1);
+
+    free(astPool.nodes);
+    astPool.nodes = NULL;
+    astPool.count = 0;
+    astPool.capacity = 0;
 }
 
-ASTNode *createNode(NodeType type)
+NodeIndex createNode(NodeType type)
 {
-    ASTNode *newNode = (ASTNode *)malloc(sizeof(ASTNode));
-    if (newNode == NULL)
+    if (astPool.count == astPool.capacity)
     {
-        // Handle memory allocation failure if needed
-        printf("Memory allocation failed for AST node\n");
-        exit(1);
-        // return NULL;
+        uint32_t capacity = astPool.capacity ? astPool.capacity * 2 : AST_POOL_INITIAL_CAPACITY;
+        ASTNode *nodes = (ASTNode *)realloc(astPool.nodes, sizeof(ASTNode) * capacity);
+        if (nodes == NULL)
+        {
+            // Handle memory allocation failure if needed
+            printf("Memory allocation failed for AST node\n");
+            exit(1);
+        }
+        astPool.nodes = nodes;
+        astPool.capacity = capacity;
+
+        // Slot 0 stands for the null node and is never handed out
+        if (astPool.count == 0)
+            astPool.count = 1;
     }
 
+    NodeIndex index = astPool.count++;
+    ASTNode *newNode = &astPool.nodes[index];
+
+    // Zeroing the node clears every child link to NULL_NODE, every name to
+    // NULL and every literal to 0
+    memset(newNode, 0, sizeof(ASTNode));
     newNode->type = type;
-    newNode->dataType = NULL; // Initialize dataType to NULL
+    newNode->dataType = DataType_Unknown;
 
     // debugging: log the node creation
     // printf("Created AST node of type %d\n", type);
 
-    // Initialize the node based on its type
-    switch (type)
+    return index;
+}
+
+// Append a child to a VarDeclList or StmtList node, growing its vector
+// geometrically so building a list of n items costs O(n)
+void appendListItem(NodeIndex listIndex, NodeIndex item)
+{
+    if (item == NULL_NODE)
+        return;
+
+    // Both list kinds share the same layout
+    ASTNode *list = getNode(listIndex);
+    if (list->stmtList.count == list->stmtList.capacity)
     {
-    case NodeType_Program:
-        newNode->program.varDeclList = NULL;
-        newNode->program.block = NULL;
-        break;
-    case NodeType_VarDeclList:
-        newNode->varDeclList.varDecl = NULL;
-        newNode->varDeclList.varDeclList = NULL;
-        break;
-    case NodeType_VarDecl:
-        newNode->varDecl.varType = NULL;
-        newNode->varDecl.varName = NULL;
-        break;
-    case NodeType_SimpleExpr:
-        newNode->simpleExpr.number = 0;
-        newNode->simpleExpr.floatValue = 0.0;
-        newNode->simpleExpr.isFloat = false;
-        break;
-    case NodeType_SimpleID:
-        newNode->simpleID.name = NULL;
-        break;
-    case NodeType_Expr:
-        newNode->expr.operator= '\0'; // Placeholder value
-        newNode->expr.left = NULL;
-        newNode->expr.right = NULL;
-        break;
-    case NodeType_StmtList:
-        newNode->stmtList.stmt = NULL; // Example initialization
-        newNode->stmtList.stmtList = NULL;
-        break;
-    case NodeType_AssignStmt:
-        newNode->assignStmt.operator= NULL; // Example initialization
-        newNode->assignStmt.varName = NULL;
-        newNode->assignStmt.expr = NULL;
-        break;
-    case NodeType_BinOp:
-        newNode->binOp.operator= '\0'; // Placeholder value
-        newNode->binOp.left = NULL;
-        newNode->binOp.right = NULL;
-        break;
-    case NodeType_LogicalOp:
-        newNode->logicalOp.logicalOp = NULL;
-        newNode->logicalOp.left = NULL;
-        newNode->logicalOp.right = NULL;
-        break;
-    case NodeType_WriteStmt:
-        newNode->writeStmt.expr = NULL;
-        break;
-    case NodeType_IfStmt:
-        newNode->ifStmt.condition = NULL;
-        newNode->ifStmt.thenBlock = NULL;
-        newNode->ifStmt.elseBlock = NULL;
-        break;
-    case NodeType_WhileStmt:
-        newNode->whileStmt.condition = NULL;
-        newNode->whileStmt.block = NULL;
-        break;
-    case NodeType_ReturnStmt:
-        newNode->returnStmt.expr = NULL;
-        break;
-    case NodeType_Block:
-        newNode->block.stmtList = NULL;
-        break;
-    case NodeType_ArrayDecl:
-        newNode->arrayDecl.varType = NULL;
-        newNode->arrayDecl.varName = NULL;
-        newNode->arrayDecl.size = 0;
-        break;
-    case NodeType_ArrayAssign:
-        newNode->arrayAssign.arrayName = NULL;
-        newNode->arrayAssign.index = NULL;
-        newNode->arrayAssign.expr = NULL;
-        break;
-    case NodeType_ArrayAccess:
-        newNode->arrayAccess.arrayName = NULL;
-        newNode->arrayAccess.index = NULL;
-        break;
+        int capacity = list->stmtList.capacity ? list->stmtList.capacity * 2 : 8;
+        NodeIndex *items = (NodeIndex *)realloc(list->stmtList.items, sizeof(NodeIndex) * capacity);
+        if (items == NULL)
+        {
+            printf("Memory allocation failed for AST list\n");
+            exit(1);
+        }
+        list->stmtList.items = items;
+        list->stmtList.capacity = capacity;
     }
-    return newNode;
+    list->stmtList.items[list->stmtList.count++] = item;
 }
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
 
 // NodeType enum to differentiate between different
 // kinds of AST nodes
@@ -27,41 +29,53 @@ typedef enum
     NodeType_IfStmt,
     NodeType_WhileStmt,
     NodeType_ReturnStmt,
-    NodeType_LogicalOp,
-    NodeType_Expr
+    NodeType_LogicalOp
 } NodeType;
 
+// Nodes refer to each other by their index in the node pool, which keeps
+// child links at 32 bits; index 0 is reserved as the null node
+typedef uint32_t NodeIndex;
+#define NULL_NODE 0
+
 // Structure for AST nodes
 typedef struct ASTNode
 {
-    NodeType type;
-    char *dataType;
+    uint8_t type;     // NodeType
+    uint8_t dataType; // DataType, set by the parser for declarations and
+                      // literals and by semantic analysis for expressions
+    uint8_t regNeed;  // Registers needed to evaluate an expression (its
+                      // Sethi-Ullman number), set by semantic analysis
+    uint32_t symbol;  // Symbol id bound by resolveNames for declarations and
+                      // names (SimpleID, AssignStmt, ArrayAssign, ArrayAccess)
     union
     {
         struct
         {
-            struct ASTNode *varDeclList;
-            struct ASTNode *block;
+            NodeIndex varDeclList;
+            NodeIndex block;
         } program;
 
         struct
         {
-            struct ASTNode *varDecl;
-            struct ASTNode *varDeclList;
+            // Declarations in source order, stored contiguously
+            NodeIndex *items;
+            int count;
+            int capacity;
         } varDeclList;
 
         struct
         {
-            char *varType;
-            char *varName;
-            bool isFloat;
+            char *varName; // The declared type is the node's dataType
         } varDecl;
 
         struct
         {
-            int number;
-            float floatValue;
-            bool isFloat;
+            // The literal is stored inline; dataType tells which member is set
+            union
+            {
+                int number;
+                float floatValue;
+            };
         } simpleExpr;
 
         struct
@@ -71,95 +85,102 @@ typedef struct ASTNode
 
         struct
         {
-            // Expression-specific fields
-            char operator;         // Example for an operator field
-            struct ASTNode *left;  // Left operand
-            struct ASTNode *right; // Right operand
-        } expr;
-
-        struct
-        {
-            // StatementList-specific fields
-            struct ASTNode *stmt;
-            struct ASTNode *stmtList;
-            // Example for linking statements in a list
+            // Statements in source order, stored contiguously
+            NodeIndex *items;
+            int count;
+            int capacity;
         } stmtList;
 
         struct
         {
-            char *operator; // e.g., '='
-            char *varName;
-            struct ASTNode *expr;
+            char *varName; // The operator is always '='
+            NodeIndex expr;
         } assignStmt;
 
         struct
         {
             char operator;
-            struct ASTNode *left;
-            struct ASTNode *right;
+            NodeIndex left;
+            NodeIndex right;
         } binOp;
 
         struct
         {
             char *logicalOp;
-            struct ASTNode *left;
-            struct ASTNode *right;
+            NodeIndex left;
+            NodeIndex right;
         } logicalOp; // Logical operation
 
         struct
         {
-            struct ASTNode *stmtList;
+            NodeIndex stmtList;
         } block; // Block
 
         struct
         {
-            struct ASTNode *expr;
+            NodeIndex expr;
         } writeStmt; // WRITE statement
 
         struct
         {
-            struct ASTNode *condition;
-            struct ASTNode *thenBlock;
-            struct ASTNode *elseBlock;
+            NodeIndex condition;
+            NodeIndex thenBlock;
+            NodeIndex elseBlock;
         } ifStmt; // IF-ELSE statement
 
         struct
         {
-            struct ASTNode *condition;
-            struct ASTNode *block;
+            NodeIndex condition;
+            NodeIndex block;
         } whileStmt; // WHILE statement
 
         struct
         {
-            struct ASTNode *expr;
+            NodeIndex expr;
         } returnStmt; // RETURN statement
 
         struct
         {
-            char *varType;
-            char *varName;
+            char *varName; // The element type is the node's dataType
             int size;
-            bool isFloat;
         } arrayDecl; // Array declaration
 
         struct
         {
             char *arrayName;
-            struct ASTNode *index;
-            struct ASTNode *expr;
+            NodeIndex index;
+            NodeIndex expr;
         } arrayAssign; // Array assignment
 
         struct
         {
             char *arrayName;
-            struct ASTNode *index;
+            NodeIndex index;
         } arrayAccess; // Array access
     };
 } ASTNode;
 
+// Every node of the program lives in one growable array
+typedef struct ASTPool
+{
+    ASTNode *nodes;
+    uint32_t count;
+    uint32_t capacity;
+} ASTPool;
+
+extern ASTPool astPool;
+
+// Resolve a node index; the pointer is only valid until the next createNode
+static inline ASTNode *getNode(NodeIndex index)
+{
+    return index == NULL_NODE ? NULL : &astPool.nodes[index];
+}
+
 // Function prototypes for AST handling
-ASTNode *createNode(NodeType type);
-void freeAST(ASTNode *node);
-void traverseAST(ASTNode *node, int level);
+NodeIndex createNode(NodeType type);
+void appendListItem(NodeIndex list, NodeIndex item);
+void freeAST();
+void releaseNodesFrom(NodeIndex mark);
+void traverseAST(NodeIndex index, int level);
 
 #endif // AST_H
@@ -1,166 +1,252 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "Array.h"
-
-Array *createArray(char *dataType, int size)
-{
-    // invalid size
-    if (size <= 0)
-    {
-        fprintf(stderr, "Error: Array size must be positive\n");
-        return NULL;
-    }
-
-    Array *array = (Array *)malloc(sizeof(Array));
-    // null check for array
-    if (array == NULL)
-    {
-        fprintf(stderr, "Error: Memory allocation failed for Array\n");
-        return NULL;
-    }
-
-    array->dataType = strdup(dataType);
-    // null check for dataType
-    if (array->dataType == NULL)
-    {
-        fprintf(stderr, "Error: Memory allocation failed for dataType\n");
-        free(array);
-        return NULL;
-    }
-
-    array->size = size;
-    array->elements = NULL; // No elements allocated initially
-
-    return array;
-}
-
-void freeArray(Array *array)
-{
-    if (array == NULL)
-        return;
-
-    // Free the dataType string
-    free(array->dataType);
-
-    // Free all the array elements
-    ArrayElement *current = array->elements;
-    while (current != NULL)
-    {
-        ArrayElement *next = current->next;
-        free(current->value);
-        free(current);
-        current = next;
-    }
-
-    // Free the array itself
-    free(array);
-}
-
-bool setArrayValue(Array *array, int index, const char *value)
-{
-    if (array == NULL)
-    {
-        fprintf(stderr, "Error: Array is NULL\n");
-        return false;
-    }
-
-    if (index < 0 || index >= array->size)
-    {
-        fprintf(stderr, "Error: Array index out of bounds: %d\n", index);
-        return false;
-    }
-
-    ArrayElement *current = array->elements;
-    ArrayElement *prev = NULL;
-
-    // Find the correct position to insert/update the element
-    while (current != NULL && current->index < index)
-    {
-        prev = current;
-        current = current->next;
-    }
-
-    if (current != NULL && current->index == index)
-    {
-        // Update existing element
-        free(current->value);
-        current->value = strdup(value);
-        if (current->value == NULL)
-        {
-            fprintf(stderr, "Error: Memory allocation failed for value\n");
-            return false;
-        }
-    }
-    else
-    {
-        // Create a new element
-        ArrayElement *newElement = (ArrayElement *)malloc(sizeof(ArrayElement));
-        if (newElement == NULL)
-        {
-            fprintf(stderr, "Error: Memory allocation failed for ArrayElement\n");
-            return false;
-        }
-        newElement->index = index;
-        newElement->value = strdup(value);
-        if (newElement->value == NULL)
-        {
-            fprintf(stderr, "Error: Memory allocation failed for value\n");
-            free(newElement);
-            return false;
-        }
-        newElement->next = current;
-
-        if (prev == NULL)
-        {
-            // Insert at the beginning
-            array->elements = newElement;
-        }
-        else
-        {
-            prev->next = newElement;
-        }
-    }
-
-    return true;
-}
-
-char *getArrayValue(Array *array, int index)
-{
-    if (array == NULL)
-    {
-        fprintf(stderr, "Error: Array is NULL\n");
-        return NULL;
-    }
-
-    if (index < 0 || index >= array->size)
-    {
-        fprintf(stderr, "Error: Array index out of bounds: %d\n", index);
-        return NULL;
-    }
-
-    ArrayElement *current = array->elements;
-
-    while (current != NULL && current->index <= index)
-    {
-        if (current->index == index)
-        {
-            // Return a copy of the value to prevent accidental modification
-            return strdup(current->value);
-        }
-        current = current->next;
-    }
-
-    // Element not found (uninitialized)
-    return NULL;
-}
-
-int getArraySize(Array *array)
-{
-    if (array == NULL)
-    {
-        fprintf(stderr, "Error: Array is NULL\n");
-        return -1; // Indicate an error
-    }
-    return array->size;
-}
\ No newline at end of file
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Array.h"
+
+#define ARRAY_INITIAL_SLOTS 16
+
+Array *createArray(DataType dataType, int size)
+{
+    // invalid size
+    if (size <= 0)
+    {
+        fprintf(stderr, "Error: Array size must be positive\n");
+        return NULL;
+    }
+
+    Array *array = (Array *)malloc(sizeof(Array));
+    // null check for array
+    if (array == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for Array\n");
+        return NULL;
+    }
+
+    array->dataType = dataType;
+    array->isFloat = dataType == DataType_Float;
+    array->size = size;
+    array->knownCount = 0;
+    array->isDense = size <= ARRAY_DENSE_LIMIT;
+
+    // Storage is allocated on the first store, so untouched arrays cost nothing
+    array->known = NULL;
+    array->values = NULL;
+    array->slots = NULL;
+    array->capacity = 0;
+    array->used = 0;
+
+    return array;
+}
+
+void freeArray(Array *array)
+{
+    if (array == NULL)
+        return;
+
+    // Free the element storage
+    free(array->known);
+    free(array->values);
+    free(array->slots);
+
+    // Free the array itself
+    free(array);
+}
+
+static bool checkIndex(Array *array, int index)
+{
+    if (array == NULL)
+    {
+        fprintf(stderr, "Error: Array is NULL\n");
+        return false;
+    }
+
+    if (index < 0 || index >= array->size)
+    {
+        fprintf(stderr, "Error: Array index out of bounds: %d\n", index);
+        return false;
+    }
+    return true;
+}
+
+// Multiplicative hash of an element index into a power-of-two table
+static int slotFor(int index, int capacity)
+{
+    return (int)(((unsigned int)index * 2654435761u) & (unsigned int)(capacity - 1));
+}
+
+static ArraySlot *findSlot(Array *array, int index)
+{
+    if (array->slots == NULL)
+        return NULL;
+
+    int i = slotFor(index, array->capacity);
+    while (array->slots[i].index != ARRAY_SLOT_EMPTY)
+    {
+        if (array->slots[i].index == index)
+            return &array->slots[i];
+        i = (i + 1) & (array->capacity - 1);
+    }
+    return NULL;
+}
+
+static bool allocateSlots(Array *array, int capacity)
+{
+    ArraySlot *oldSlots = array->slots;
+    int oldCapacity = array->capacity;
+
+    array->slots = (ArraySlot *)malloc(sizeof(ArraySlot) * capacity);
+    if (array->slots == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for array slots\n");
+        array->slots = oldSlots;
+        return false;
+    }
+    for (int i = 0; i < capacity; i++)
+    {
+        array->slots[i].index = ARRAY_SLOT_EMPTY;
+    }
+    array->capacity = capacity;
+    array->used = 0;
+
+    // Reinsert live entries; deleted slots are dropped
+    for (int i = 0; i < oldCapacity; i++)
+    {
+        if (oldSlots[i].index >= 0)
+        {
+            int j = slotFor(oldSlots[i].index, capacity);
+            while (array->slots[j].index != ARRAY_SLOT_EMPTY)
+                j = (j + 1) & (capacity - 1);
+            array->slots[j] = oldSlots[i];
+            array->used++;
+        }
+    }
+    free(oldSlots);
+    return true;
+}
+
+bool setArrayValue(Array *array, int index, ArrayValue value)
+{
+    if (!checkIndex(array, index))
+        return false;
+
+    if (array->isDense)
+    {
+        if (array->values == NULL)
+        {
+            array->values = (ArrayValue *)malloc(sizeof(ArrayValue) * array->size);
+            array->known = (uint64_t *)calloc((array->size + 63) / 64, sizeof(uint64_t));
+            if (array->values == NULL || array->known == NULL)
+            {
+                fprintf(stderr, "Error: Memory allocation failed for array values\n");
+                return false;
+            }
+        }
+
+        uint64_t bit = (uint64_t)1 << (index % 64);
+        if (!(array->known[index / 64] & bit))
+        {
+            array->known[index / 64] |= bit;
+            array->knownCount++;
+        }
+        array->values[index] = value;
+        return true;
+    }
+
+    ArraySlot *slot = findSlot(array, index);
+    if (slot != NULL)
+    {
+        // Update existing element
+        slot->value = value;
+        return true;
+    }
+
+    // Keep the table at most three quarters full
+    if (array->slots == NULL || (array->used + 1) * 4 > array->capacity * 3)
+    {
+        int capacity = array->capacity ? array->capacity : ARRAY_INITIAL_SLOTS;
+        while ((array->knownCount + 1) * 2 > capacity)
+            capacity *= 2;
+        if (!allocateSlots(array, capacity))
+            return false;
+    }
+
+    int i = slotFor(index, array->capacity);
+    while (array->slots[i].index >= 0)
+        i = (i + 1) & (array->capacity - 1);
+    if (array->slots[i].index == ARRAY_SLOT_EMPTY)
+        array->used++;
+    array->slots[i].index = index;
+    array->slots[i].value = value;
+    array->knownCount++;
+    return true;
+}
+
+const ArrayValue *getArrayValue(Array *array, int index)
+{
+    if (!checkIndex(array, index))
+        return NULL;
+
+    if (array->isDense)
+    {
+        if (array->known == NULL || !(array->known[index / 64] & ((uint64_t)1 << (index % 64))))
+            return NULL; // Element not known
+        return &array->values[index];
+    }
+
+    ArraySlot *slot = findSlot(array, index);
+    return slot != NULL ? &slot->value : NULL;
+}
+
+void clearArrayValue(Array *array, int index)
+{
+    if (!checkIndex(array, index))
+        return;
+
+    if (array->isDense)
+    {
+        uint64_t bit = (uint64_t)1 << (index % 64);
+        if (array->known != NULL && (array->known[index / 64] & bit))
+        {
+            array->known[index / 64] &= ~bit;
+            array->knownCount--;
+        }
+        return;
+    }
+
+    ArraySlot *slot = findSlot(array, index);
+    if (slot != NULL)
+    {
+        slot->index = ARRAY_SLOT_DELETED;
+        array->knownCount--;
+    }
+}
+
+void clearArrayValues(Array *array)
+{
+    if (array == NULL)
+        return;
+
+    if (array->isDense)
+    {
+        if (array->known != NULL)
+            memset(array->known, 0, sizeof(uint64_t) * ((array->size + 63) / 64));
+    }
+    else
+    {
+        free(array->slots);
+        array->slots = NULL;
+        array->capacity = 0;
+        array->used = 0;
+    }
+    array->knownCount = 0;
+}
+
+int getArraySize(Array *array)
+{
+    if (array == NULL)
+    {
+        fprintf(stderr, "Error: Array is NULL\n");
+        return -1; // Indicate an error
+    }
+    return array->size;
+}
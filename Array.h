@@ -1,37 +1,67 @@
-#ifndef ARRAY_H
-#define ARRAY_H
-
-#include <stdbool.h>
-
-typedef struct ArrayElement
-{
-    int index;                 // Index of the element in the array
-    char *value;               // Value stored at this index (as a string)
-    struct ArrayElement *next; // Pointer to the next element
-} ArrayElement;
-
-typedef struct Array
-{
-    char *dataType;         // Data type of the array elements
-    int size;               // Declared size of the array
-    ArrayElement *elements; // Linked list of initialized elements
-} Array;
-
-// Function prototypes
-
-// Create a new array
-Array *createArray(char *dataType, int size);
-
-// Free an array
-void freeArray(Array *array);
-
-// Set value at a specific index
-bool setArrayValue(Array *array, int index, const char *value);
-
-// Get value at a specific index
-char *getArrayValue(Array *array, int index);
-
-// Get the size of the array
-int getArraySize(Array *array);
-
-#endif // ARRAY_H
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+
+// Arrays up to this many elements keep their known values in a flat table;
+// larger arrays use a hash map so tracking costs scale with what is known
+#define ARRAY_DENSE_LIMIT 1024
+
+// Compile-time value of one element, interpreted through Array::isFloat
+typedef union ArrayValue
+{
+    int intValue;
+    float floatValue;
+} ArrayValue;
+
+// Hash slot for sparse arrays (index is ARRAY_SLOT_EMPTY or ARRAY_SLOT_DELETED when unused)
+typedef struct ArraySlot
+{
+    int index;
+    ArrayValue value;
+} ArraySlot;
+
+#define ARRAY_SLOT_EMPTY -1
+#define ARRAY_SLOT_DELETED -2
+
+typedef struct Array
+{
+    DataType dataType;  // Data type of the array elements
+    bool isFloat;       // Elements hold floatValue rather than intValue
+    int size;           // Declared size of the array
+    int knownCount;     // Number of elements with a known value
+    bool isDense;       // Storage strategy chosen from the size
+    uint64_t *known;    // Dense: bitmap of elements with a known value
+    ArrayValue *values; // Dense: one value per element
+    ArraySlot *slots;   // Sparse: open-addressing table keyed by index
+    int capacity;       // Sparse: number of slots (a power of two)
+    int used;           // Sparse: live plus deleted slots
+} Array;
+
+// Function prototypes
+
+// Create a new array
+Array *createArray(DataType dataType, int size);
+
+// Free an array
+void freeArray(Array *array);
+
+// Set value at a specific index
+bool setArrayValue(Array *array, int index, ArrayValue value);
+
+// Get value at a specific index; the pointer is borrowed and stays valid
+// until the next update of the array. NULL if the value is not known.
+const ArrayValue *getArrayValue(Array *array, int index);
+
+// Forget the value at a specific index
+void clearArrayValue(Array *array, int index);
+
+// Forget every known value (e.g. after a store to an unknown index)
+void clearArrayValues(Array *array);
+
+// Get the size of the array
+int getArraySize(Array *array);
+
+#endif // ARRAY_H
@@ -25,7 +25,7 @@ unsigned int hashFunction(const char *name, int tableSize)
 }
 
 // Create a new symbol with the given name, type, and index
-Symbol *createSymbol(const char *name, const char *type, int index, bool isArray, Array *arrayInfo)
+Symbol *createSymbol(const char *name, DataType type, int index, bool isArray, Array *arrayInfo)
 {
     Symbol *newSymbol = (Symbol *)malloc(sizeof(Symbol));
     if (!newSymbol)
@@ -34,8 +34,9 @@ Symbol *createSymbol(const char *name, const char *type, int index, bool isArray
         exit(1);
     }
     newSymbol->name = strdup(name);
-    newSymbol->type = strdup(type);
+    newSymbol->type = type;
     newSymbol->index = index;
+    newSymbol->id = NO_SYMBOL;
     newSymbol->value = NULL;
     newSymbol->isArray = isArray;
     newSymbol->arrayInfo = arrayInfo;
@@ -43,22 +44,23 @@ Symbol *createSymbol(const char *name, const char *type, int index, bool isArray
     return newSymbol;
 }
 
-// Insert a symbol into the symbol table
-void insertSymbol(SymbolTable *symbolTable, const char *name, const char *type, bool isArray, Array *arrayInfo)
+// Insert a symbol into the symbol table; returns the new symbol, or NULL if
+// the name is already declared
+Symbol *insertSymbol(SymbolTable *symbolTable, const char *name, DataType type, bool isArray, Array *arrayInfo)
 {
     // Check if the symbol already exists
     Symbol *existingSymbol = findSymbol(symbolTable, name);
     if (existingSymbol != NULL)
     {
         fprintf(stderr, "Error: Symbol %s is already declared.\n", name);
-        return;
+        return NULL;
     }
 
     unsigned int index = hashFunction(name, symbolTable->size);
     Symbol *newSymbol = createSymbol(name, type, index, isArray, arrayInfo);
 
     // Set default value for floats if applicable
-    if (strcmp(type, "float") == 0) {
+    if (type == DataType_Float) {
         newSymbol->value = strdup("0.0"); // Default float value
     }
 
@@ -66,8 +68,32 @@ void insertSymbol(SymbolTable *symbolTable, const char *name, const char *type,
     newSymbol->next = symbolTable->table[index];
     symbolTable->table[index] = newSymbol;
 
+    // Register the symbol under the next id
+    if (symbolTable->count + 1 >= symbolTable->capacity)
+    {
+        int capacity = symbolTable->capacity ? symbolTable->capacity * 2 : 64;
+        symbolTable->byId = (Symbol **)realloc(symbolTable->byId, sizeof(Symbol *) * capacity);
+        if (!symbolTable->byId)
+        {
+            fprintf(stderr, "Memory allocation failed for symbol ids\n");
+            exit(1);
+        }
+        symbolTable->capacity = capacity;
+    }
+    newSymbol->id = ++symbolTable->count;
+    symbolTable->byId[newSymbol->id] = newSymbol;
+
     printf("Inserted symbol: Name = %s, Type = %s, Index = %d, isArray = %s\n",
-           name, type, index, isArray ? "true" : "false");
+           name, dataTypeName(type), index, isArray ? "true" : "false");
+    return newSymbol;
+}
+
+// Look up a symbol by the id it was given on insertion (NULL for NO_SYMBOL)
+Symbol *getSymbolById(SymbolTable *symbolTable, int id)
+{
+    if (id <= NO_SYMBOL || id > symbolTable->count)
+        return NULL;
+    return symbolTable->byId[id];
 }
 
 // Find a symbol in the symbol table by name
@@ -100,8 +126,8 @@ Symbol *findSymbol(SymbolTable *symbolTable, const char *name)
     return NULL; // Return NULL if the symbol is not found
 }
 
-// Free the memory used by the symbol table
-void freeSymbolTable(SymbolTable *symbolTable)
+// Free every symbol, leaving the table empty but allocated for reuse
+void resetSymbolTable(SymbolTable *symbolTable)
 {
     if (symbolTable == NULL)
     {
@@ -123,13 +149,6 @@ void freeSymbolTable(SymbolTable *symbolTable)
                 symbol->name = NULL;
             }
 
-            // Free the symbol's type
-            if (symbol->type != NULL)
-            {
-                free(symbol->type);
-                symbol->type = NULL;
-            }
-
             // Free the symbol's value
             if (symbol->value != NULL)
             {
@@ -148,9 +167,23 @@ void freeSymbolTable(SymbolTable *symbolTable)
             free(symbol);
             symbol = next;
         }
+        symbolTable->table[i] = NULL;
     }
+    symbolTable->count = 0;
+}
+
+// Free the memory used by the symbol table
+void freeSymbolTable(SymbolTable *symbolTable)
+{
+    if (symbolTable == NULL)
+    {
+        return;
+    }
+
+    resetSymbolTable(symbolTable);
 
     // Free the table array and the symbol table itself
+    free(symbolTable->byId);
     free(symbolTable->table);
     symbolTable->table = NULL;
     free(symbolTable);
@@ -181,6 +214,9 @@ SymbolTable *createSymbolTable(int size)
     {
         newTable->table[i] = NULL;
     }
+    newTable->byId = NULL;
+    newTable->count = 0;
+    newTable->capacity = 0;
 
     return newTable;
 }
@@ -5,13 +5,15 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "Array.h"
+#include "types.h"
 
 typedef struct Symbol
 {
     char *name;          // The name of the symbol
-    char *type;          // The type of the symbol (e.g., int, float, etc.)
+    DataType type;       // The type of the symbol (e.g., int, float, etc.)
     char *value;         // The value of the symbol (e.g., "1", "30.5", "Hi", etc.)
     int index;           // The index generated by the hash function
+    int id;              // Dense id (1, 2, ...) for binding AST nodes to symbols
     bool isArray;        // Flag to indicate if the symbol is an array
     Array *arrayInfo;    // Pointer to array-specific information
     struct Symbol *next; // Pointer to the next symbol in the list (linked list)
@@ -21,15 +23,23 @@ typedef struct Symbol
 typedef struct SymbolTable
 {
     int size;
-    Symbol **table; // Array of symbol pointers (linked list heads)
+    Symbol **table;   // Array of symbol pointers (linked list heads)
+    Symbol **byId;    // byId[id] is the symbol with that id; slot 0 is unused
+    int count;        // Number of symbols (the largest id)
+    int capacity;     // Allocated length of byId
 } SymbolTable;
 
+// Id of "no symbol" in AST bindings
+#define NO_SYMBOL 0
+
 // Function Declarations
 unsigned int hashFunction(const char *name, int tableSize);
-Symbol *createSymbol(const char *name, const char *type, int index, bool isArray, Array *arrayInfo);
-void insertSymbol(SymbolTable *symbolTable, const char *name, const char *type, bool isArray, Array *arrayInfo);
+Symbol *createSymbol(const char *name, DataType type, int index, bool isArray, Array *arrayInfo);
+Symbol *insertSymbol(SymbolTable *symbolTable, const char *name, DataType type, bool isArray, Array *arrayInfo);
+Symbol *getSymbolById(SymbolTable *symbolTable, int id);
 Symbol *findSymbol(SymbolTable *symbolTable, const char *name);
 void freeSymbolTable(SymbolTable *symbolTable);
+void resetSymbolTable(SymbolTable *symbolTable);
 SymbolTable *createSymbolTable(int size);
 void updateSymbolValue(SymbolTable *symbolTable, const char *name, const char *value);
 const char *getSymbolValue(SymbolTable *symbolTable, const char *name);
@@ -0,0 +1,494 @@
+// cache.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "cache.h"
+
+#define ENTRY_SUFFIX ".entry"
+#define ENTRY_MAGIC "cmm-cache-entry 1\n"
+#define STATS_FILE "stats"
+
+struct CompileCache
+{
+    char *dir;
+    long long maxBytes;
+    // Counts for this run, added to the stats file on close
+    long long hits;
+    long long misses;
+    long long stores;
+    long long evictions;
+};
+
+typedef struct
+{
+    long long hits;
+    long long misses;
+    long long stores;
+    long long evictions;
+} CacheStats;
+
+// ---- SHA-256 ----
+
+typedef struct
+{
+    uint32_t state[8];
+    uint64_t length; // Bytes hashed so far
+    unsigned char block[64];
+    size_t used;     // Bytes waiting in block
+} Sha256;
+
+static const uint32_t sha256Constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256Block(Sha256 *sha, const unsigned char *block)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+               (uint32_t)block[i * 4 + 2] << 8 | (uint32_t)block[i * 4 + 3];
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = sha->state[0], b = sha->state[1], c = sha->state[2], d = sha->state[3];
+    uint32_t e = sha->state[4], f = sha->state[5], g = sha->state[6], h = sha->state[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha256Constants[i] + w[i];
+        uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    sha->state[0] += a;
+    sha->state[1] += b;
+    sha->state[2] += c;
+    sha->state[3] += d;
+    sha->state[4] += e;
+    sha->state[5] += f;
+    sha->state[6] += g;
+    sha->state[7] += h;
+}
+
+static void sha256Init(Sha256 *sha)
+{
+    static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(sha->state, initial, sizeof(initial));
+    sha->length = 0;
+    sha->used = 0;
+}
+
+static void sha256Update(Sha256 *sha, const void *data, size_t length)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    sha->length += length;
+    while (length > 0)
+    {
+        size_t n = 64 - sha->used < length ? 64 - sha->used : length;
+        memcpy(sha->block + sha->used, bytes, n);
+        sha->used += n;
+        bytes += n;
+        length -= n;
+        if (sha->used == 64)
+        {
+            sha256Block(sha, sha->block);
+            sha->used = 0;
+        }
+    }
+}
+
+static void sha256Final(Sha256 *sha, unsigned char digest[32])
+{
+    uint64_t bits = sha->length * 8;
+    unsigned char pad = 0x80;
+    sha256Update(sha, &pad, 1);
+    pad = 0;
+    while (sha->used != 56)
+        sha256Update(sha, &pad, 1);
+    unsigned char lengthBytes[8];
+    for (int i = 0; i < 8; i++)
+        lengthBytes[i] = (unsigned char)(bits >> (56 - i * 8));
+    sha256Update(sha, lengthBytes, 8);
+    for (int i = 0; i < 8; i++)
+    {
+        digest[i * 4] = (unsigned char)(sha->state[i] >> 24);
+        digest[i * 4 + 1] = (unsigned char)(sha->state[i] >> 16);
+        digest[i * 4 + 2] = (unsigned char)(sha->state[i] >> 8);
+        digest[i * 4 + 3] = (unsigned char)sha->state[i];
+    }
+}
+
+// ---- Keys ----
+
+void computeCacheKey(SourceBuffer *source, const char *optionString, const char *pipeline, char *key)
+{
+    Sha256 sha;
+    sha256Init(&sha);
+
+    // The build of the compiler: a rebuilt binary never reuses old entries
+    char build[128];
+    struct stat info;
+    if (stat("/proc/self/exe", &info) == 0)
+        snprintf(build, sizeof(build), "%s %lld %lld", COMPILER_VERSION, (long long)info.st_size, (long long)info.st_mtime);
+    else
+        snprintf(build, sizeof(build), "%s", COMPILER_VERSION);
+
+    // Each part is NUL-terminated so the parts cannot run into each other
+    sha256Update(&sha, build, strlen(build) + 1);
+    sha256Update(&sha, optionString, strlen(optionString) + 1);
+    sha256Update(&sha, pipeline, strlen(pipeline) + 1);
+    sha256Update(&sha, source->data, source->length);
+
+    unsigned char digest[32];
+    sha256Final(&sha, digest);
+    for (int i = 0; i < 32; i++)
+        sprintf(key + i * 2, "%02x", digest[i]);
+    key[CACHE_KEY_LENGTH] = '\0';
+}
+
+// ---- Entries ----
+
+static char *entryPath(CompileCache *cache, const char *key)
+{
+    size_t size = strlen(cache->dir) + CACHE_KEY_LENGTH + sizeof(ENTRY_SUFFIX) + 2;
+    char *path = (char *)malloc(size);
+    snprintf(path, size, "%s/%s%s", cache->dir, key, ENTRY_SUFFIX);
+    return path;
+}
+
+// Read a whole file; NULL if it cannot be read
+static char *readFile(const char *path, size_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    char *data = size >= 0 ? (char *)malloc((size_t)size + 1) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)size, file) != (size_t)size)
+    {
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    data[size] = '\0';
+    *length = (size_t)size;
+    return data;
+}
+
+// Write a file through a temporary name so readers never see half of it
+static bool writeFileAtomically(const char *path, const char *data, size_t length)
+{
+    size_t size = strlen(path) + 32;
+    char *temp = (char *)malloc(size);
+    snprintf(temp, size, "%s.tmp%ld", path, (long)getpid());
+    FILE *file = fopen(temp, "wb");
+    bool ok = file != NULL && fwrite(data, 1, length, file) == length;
+    if (file != NULL && fclose(file) != 0)
+        ok = false;
+    if (ok && rename(temp, path) != 0)
+        ok = false;
+    if (!ok)
+        unlink(temp);
+    free(temp);
+    return ok;
+}
+
+CompileCache *openCompileCache(const char *dir, long long maxBytes)
+{
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST)
+    {
+        perror(dir);
+        return NULL;
+    }
+    CompileCache *cache = (CompileCache *)calloc(1, sizeof(CompileCache));
+    if (cache == NULL)
+        return NULL;
+    cache->dir = strdup(dir);
+    cache->maxBytes = maxBytes;
+    return cache;
+}
+
+bool restoreCacheEntry(CompileCache *cache, const char *key)
+{
+    char *path = entryPath(cache, key);
+    size_t length;
+    char *entry = readFile(path, &length);
+    if (entry == NULL)
+    {
+        cache->misses++;
+        free(path);
+        return false;
+    }
+
+    // Entry: the magic line, then "<name> <length>\n<bytes>" per file
+    bool ok = strncmp(entry, ENTRY_MAGIC, strlen(ENTRY_MAGIC)) == 0;
+    char *cursor = entry + strlen(ENTRY_MAGIC);
+    char *end = entry + length;
+    while (ok && cursor < end)
+    {
+        char name[256];
+        size_t fileLength;
+        int headerLength;
+        if (sscanf(cursor, "%255s %zu\n%n", name, &fileLength, &headerLength) != 2 ||
+            strchr(name, '/') != NULL || fileLength > (size_t)(end - cursor - headerLength))
+        {
+            ok = false;
+            break;
+        }
+        cursor += headerLength;
+        ok = writeFileAtomically(name, cursor, fileLength);
+        cursor += fileLength;
+    }
+    free(entry);
+
+    if (ok)
+    {
+        // The modification time orders entries for eviction
+        utimes(path, NULL);
+        cache->hits++;
+    }
+    else
+    {
+        fprintf(stderr, "Warning: Discarding damaged cache entry %s\n", path);
+        unlink(path);
+        cache->misses++;
+    }
+    free(path);
+    return ok;
+}
+
+typedef struct
+{
+    char *path;
+    long long size;
+    time_t lastUse;
+} EntryInfo;
+
+static int compareLastUse(const void *a, const void *b)
+{
+    time_t x = ((const EntryInfo *)a)->lastUse;
+    time_t y = ((const EntryInfo *)b)->lastUse;
+    return (x > y) - (x < y);
+}
+
+// List the cache's entries; returns how many and sets *totalBytes
+static EntryInfo *listEntries(CompileCache *cache, int *count, long long *totalBytes)
+{
+    *count = 0;
+    *totalBytes = 0;
+    DIR *dir = opendir(cache->dir);
+    if (dir == NULL)
+        return NULL;
+
+    int capacity = 64;
+    EntryInfo *entries = (EntryInfo *)malloc(sizeof(EntryInfo) * capacity);
+    struct dirent *item;
+    size_t suffixLength = strlen(ENTRY_SUFFIX);
+    while ((item = readdir(dir)) != NULL)
+    {
+        size_t nameLength = strlen(item->d_name);
+        if (nameLength <= suffixLength || strcmp(item->d_name + nameLength - suffixLength, ENTRY_SUFFIX) != 0)
+            continue;
+
+        size_t size = strlen(cache->dir) + nameLength + 2;
+        char *path = (char *)malloc(size);
+        snprintf(path, size, "%s/%s", cache->dir, item->d_name);
+        struct stat info;
+        if (stat(path, &info) != 0)
+        {
+            free(path);
+            continue;
+        }
+        if (*count == capacity)
+        {
+            capacity *= 2;
+            entries = (EntryInfo *)realloc(entries, sizeof(EntryInfo) * capacity);
+        }
+        entries[*count].path = path;
+        entries[*count].size = (long long)info.st_size;
+        entries[*count].lastUse = info.st_mtime;
+        *totalBytes += (long long)info.st_size;
+        (*count)++;
+    }
+    closedir(dir);
+    return entries;
+}
+
+static void freeEntries(EntryInfo *entries, int count)
+{
+    for (int i = 0; i < count; i++)
+        free(entries[i].path);
+    free(entries);
+}
+
+// Remove least recently used entries until the cache fits its limit
+static void evictEntries(CompileCache *cache)
+{
+    int count;
+    long long totalBytes;
+    EntryInfo *entries = listEntries(cache, &count, &totalBytes);
+    if (entries == NULL)
+        return;
+    if (totalBytes > cache->maxBytes)
+    {
+        qsort(entries, count, sizeof(EntryInfo), compareLastUse);
+        for (int i = 0; i < count && totalBytes > cache->maxBytes; i++)
+        {
+            if (unlink(entries[i].path) == 0)
+            {
+                totalBytes -= entries[i].size;
+                cache->evictions++;
+            }
+        }
+    }
+    freeEntries(entries, count);
+}
+
+void storeCacheEntry(CompileCache *cache, const char *key, const char **files, int fileCount)
+{
+    char *entry = NULL;
+    size_t length = 0;
+    FILE *out = open_memstream(&entry, &length);
+    fputs(ENTRY_MAGIC, out);
+    for (int i = 0; i < fileCount; i++)
+    {
+        size_t fileLength;
+        char *data = readFile(files[i], &fileLength);
+        if (data == NULL)
+            continue;
+        fprintf(out, "%s %zu\n", files[i], fileLength);
+        fwrite(data, 1, fileLength, out);
+        free(data);
+    }
+    fclose(out);
+
+    char *path = entryPath(cache, key);
+    if (writeFileAtomically(path, entry, length))
+        cache->stores++;
+    free(path);
+    free(entry);
+
+    evictEntries(cache);
+}
+
+// ---- Statistics ----
+
+static void readStats(FILE *file, CacheStats *stats)
+{
+    memset(stats, 0, sizeof(CacheStats));
+    char name[32];
+    long long value;
+    rewind(file);
+    while (fscanf(file, "%31s %lld", name, &value) == 2)
+    {
+        if (strcmp(name, "hits") == 0)
+            stats->hits = value;
+        else if (strcmp(name, "misses") == 0)
+            stats->misses = value;
+        else if (strcmp(name, "stores") == 0)
+            stats->stores = value;
+        else if (strcmp(name, "evictions") == 0)
+            stats->evictions = value;
+    }
+}
+
+// Open the stats file locked, so concurrent compiles do not lose counts
+static FILE *openStats(CompileCache *cache)
+{
+    size_t size = strlen(cache->dir) + sizeof(STATS_FILE) + 2;
+    char *path = (char *)malloc(size);
+    snprintf(path, size, "%s/%s", cache->dir, STATS_FILE);
+    int fd = open(path, O_RDWR | O_CREAT, 0666);
+    free(path);
+    if (fd < 0)
+        return NULL;
+    flock(fd, LOCK_EX);
+    return fdopen(fd, "r+");
+}
+
+void closeCompileCache(CompileCache *cache)
+{
+    if (cache == NULL)
+        return;
+
+    FILE *file = openStats(cache);
+    if (file != NULL)
+    {
+        CacheStats stats;
+        readStats(file, &stats);
+        stats.hits += cache->hits;
+        stats.misses += cache->misses;
+        stats.stores += cache->stores;
+        stats.evictions += cache->evictions;
+
+        rewind(file);
+        if (ftruncate(fileno(file), 0) == 0)
+        {
+            fprintf(file, "hits %lld\nmisses %lld\nstores %lld\nevictions %lld\n",
+                    stats.hits, stats.misses, stats.stores, stats.evictions);
+        }
+        fclose(file); // Also drops the lock
+    }
+
+    free(cache->dir);
+    free(cache);
+}
+
+void printCacheStats(CompileCache *cache, FILE *out)
+{
+    CacheStats stats = {0, 0, 0, 0};
+    FILE *file = openStats(cache);
+    if (file != NULL)
+    {
+        readStats(file, &stats);
+        fclose(file);
+    }
+    stats.hits += cache->hits;
+    stats.misses += cache->misses;
+    stats.stores += cache->stores;
+    stats.evictions += cache->evictions;
+
+    int count;
+    long long totalBytes;
+    EntryInfo *entries = listEntries(cache, &count, &totalBytes);
+    if (entries != NULL)
+        freeEntries(entries, count);
+
+    long long lookups = stats.hits + stats.misses;
+    fprintf(out, "Cache %s: %d entries, %lld of %lld KB\n",
+            cache->dir, count, totalBytes / 1024, cache->maxBytes / 1024);
+    fprintf(out, "Hits %lld, misses %lld (%.1f%% hit rate), stores %lld, evictions %lld\n",
+            stats.hits, stats.misses, lookups > 0 ? 100.0 * stats.hits / lookups : 0.0,
+            stats.stores, stats.evictions);
+}
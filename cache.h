@@ -0,0 +1,50 @@
+// cache.h
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "source.h"
+
+// Compiler version mixed into every cache key; bump it when the generated
+// code changes without the compiler binary changing
+#define COMPILER_VERSION "cmm-1.0"
+
+// Hex SHA-256 digest
+#define CACHE_KEY_LENGTH 64
+
+// Default location and size limit of the cache
+#define DEFAULT_CACHE_DIR ".cmm-cache"
+#define DEFAULT_CACHE_MAX_BYTES (256LL * 1024 * 1024)
+
+// On-disk compile cache. An entry is keyed by a hash of the source bytes,
+// the compiler version and build, and the compile options, and holds every
+// file the compile wrote (the assembly and any TAC dumps). Entries are
+// single files replaced atomically, so concurrent compiles may share a
+// cache; the least recently used are evicted once the cache outgrows its
+// size limit.
+typedef struct CompileCache CompileCache;
+
+// Open (creating if needed) the cache in dir; NULL on failure
+CompileCache *openCompileCache(const char *dir, long long maxBytes);
+
+// Add this run's counts to the cache's statistics and release it
+void closeCompileCache(CompileCache *cache);
+
+// Key of a compile of source with the given options and optimization
+// pipeline, in CACHE_KEY_LENGTH hex digits plus a terminating NUL
+void computeCacheKey(SourceBuffer *source, const char *optionString, const char *pipeline, char *key);
+
+// On a hit, write the entry's files back into the current directory and
+// return true; on a miss return false
+bool restoreCacheEntry(CompileCache *cache, const char *key);
+
+// Store the named files (those that exist) under key, then evict old
+// entries if the cache is over its limit
+void storeCacheEntry(CompileCache *cache, const char *key, const char **files, int fileCount);
+
+// Print the accumulated statistics and the current size of the cache
+void printCacheStats(CompileCache *cache, FILE *out);
+
+#endif // CACHE_H
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cfg.h"
+#include "SymbolTable.h"
+#include "utils.h"
+
+// Open-addressing map from label name to the block it starts
+typedef struct
+{
+    const char *label;
+    int block;
+} LabelSlot;
+
+static int lookupLabel(LabelSlot *slots, int capacity, const char *label)
+{
+    unsigned int i = hashFunction(label, capacity);
+    while (slots[i].label != NULL)
+    {
+        if (strcmp(slots[i].label, label) == 0)
+        {
+            return slots[i].block;
+        }
+        i = (i + 1) % capacity;
+    }
+    return -1;
+}
+
+static void addPredecessor(BasicBlock *block, int pred)
+{
+    block->preds = realloc(block->preds, sizeof(int) * (block->numPreds + 1));
+    if (!block->preds)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for CFG predecessors\n");
+        exit(1);
+    }
+    block->preds[block->numPreds++] = pred;
+}
+
+CFG *buildCFG(TAC *head)
+{
+    if (head == NULL)
+        return NULL;
+
+    // First pass: count blocks and labels. A new block starts at the first
+    // instruction, at every label and after every branch.
+    int numBlocks = 0;
+    int numLabels = 0;
+    bool startsBlock = true;
+    for (TAC *current = head; current != NULL; current = current->next)
+    {
+        if (isLabel(current))
+        {
+            numLabels++;
+            startsBlock = true;
+        }
+        if (startsBlock)
+        {
+            numBlocks++;
+            startsBlock = false;
+        }
+        if (isBranch(current))
+        {
+            startsBlock = true;
+        }
+    }
+
+    CFG *cfg = (CFG *)malloc(sizeof(CFG));
+    if (!cfg || !(cfg->blocks = (BasicBlock *)calloc(numBlocks, sizeof(BasicBlock))))
+    {
+        fprintf(stderr, "Error: Memory allocation failed for CFG blocks\n");
+        exit(1);
+    }
+    cfg->numBlocks = numBlocks;
+
+    int capacity = numLabels * 2 + 1;
+    LabelSlot *labels = (LabelSlot *)calloc(capacity, sizeof(LabelSlot));
+    if (!labels)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for CFG labels\n");
+        exit(1);
+    }
+
+    // Second pass: record block boundaries and label positions
+    int blockId = -1;
+    startsBlock = true;
+    for (TAC *current = head; current != NULL; current = current->next)
+    {
+        if (isLabel(current) || startsBlock)
+        {
+            blockId++;
+            cfg->blocks[blockId].id = blockId;
+            cfg->blocks[blockId].first = current;
+            startsBlock = false;
+        }
+        cfg->blocks[blockId].last = current;
+
+        if (isLabel(current))
+        {
+            unsigned int i = hashFunction(current->result, capacity);
+            while (labels[i].label != NULL)
+            {
+                i = (i + 1) % capacity;
+            }
+            labels[i].label = current->result;
+            labels[i].block = blockId;
+        }
+        if (isBranch(current))
+        {
+            startsBlock = true;
+        }
+    }
+
+    // Third pass: wire up successor and predecessor edges
+    for (int b = 0; b < numBlocks; b++)
+    {
+        BasicBlock *block = &cfg->blocks[b];
+        TAC *last = block->last;
+        block->numSucc = 0;
+
+        if (last->op != NULL && strcmp(last->op, "goto") == 0)
+        {
+            block->succ[block->numSucc++] = lookupLabel(labels, capacity, last->result);
+        }
+        else if (last->op != NULL && strcmp(last->op, "ifFalse") == 0)
+        {
+            if (b + 1 < numBlocks)
+                block->succ[block->numSucc++] = b + 1;
+            block->succ[block->numSucc++] = lookupLabel(labels, capacity, last->result);
+        }
+        else if (b + 1 < numBlocks)
+        {
+            block->succ[block->numSucc++] = b + 1;
+        }
+
+        for (int s = 0; s < block->numSucc; s++)
+        {
+            if (block->succ[s] < 0)
+            {
+                fprintf(stderr, "Error: Branch to undefined label %s\n", last->result);
+                abortCompilation();
+            }
+            addPredecessor(&cfg->blocks[block->succ[s]], b);
+        }
+    }
+
+    free(labels);
+    return cfg;
+}
+
+void freeCFG(CFG *cfg)
+{
+    if (cfg == NULL)
+        return;
+
+    for (int b = 0; b < cfg->numBlocks; b++)
+    {
+        free(cfg->blocks[b].preds);
+    }
+    free(cfg->blocks);
+    free(cfg);
+}
@@ -0,0 +1,33 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include <stdbool.h>
+#include "semantic.h"
+
+// A basic block is a maximal run of TAC instructions with a single entry
+// (its first instruction) and a single exit (its last instruction)
+typedef struct BasicBlock
+{
+    int id;
+    TAC *first;          // First instruction in the block
+    TAC *last;           // Last instruction in the block (inclusive)
+    int succ[2];         // Successor block ids; for ifFalse succ[0] is the fall-through
+    int numSucc;         // Number of valid entries in succ
+    int *preds;          // Predecessor block ids
+    int numPreds;
+} BasicBlock;
+
+// Control-flow graph over a TAC list; blocks are stored in program order
+typedef struct CFG
+{
+    BasicBlock *blocks;
+    int numBlocks;
+} CFG;
+
+// Build the control-flow graph for a TAC list (returns NULL for an empty list)
+CFG *buildCFG(TAC *head);
+
+// Free a control-flow graph (the TAC instructions are not touched)
+void freeCFG(CFG *cfg);
+
+#endif // CFG_H
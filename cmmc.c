@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "server.h"
+
+// Client for the compile server (main_program --serve): sends one file to
+// the server and prints the assembly it returns, or writes it to a file.
+//
+// Usage: ./cmmc [-s socket] [--target=mips | --target=x86-64] [-o output] [file]
+//        ./cmmc [-s socket] --shutdown
+//
+// The file defaults to input.cmm; "-" sends standard input as source text.
+// Without -o the assembly goes to stdout. Compile errors go to stderr and
+// the exit status is 1.
+
+static void usage()
+{
+    fprintf(stderr, "Usage: ./cmmc [-s socket] [--target=mips | --target=x86-64] [-o output] [file]\n"
+                    "       ./cmmc [-s socket] --shutdown\n");
+    exit(1);
+}
+
+static bool writeBytes(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t n = write(fd, data, length);
+        if (n <= 0)
+            return false;
+        data += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+// Paths are resolved by the server, so send them absolute
+static bool absolutePath(const char *path, char *result, size_t size)
+{
+    if (path[0] == '/')
+        return snprintf(result, size, "%s", path) < (int)size;
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) == NULL)
+        return false;
+    return snprintf(result, size, "%s/%s", cwd, path) < (int)size;
+}
+
+// Read all of standard input
+static char *readInput(size_t *length)
+{
+    size_t capacity = 65536;
+    char *text = (char *)malloc(capacity);
+    *length = 0;
+    size_t n;
+    while ((n = fread(text + *length, 1, capacity - *length, stdin)) > 0)
+    {
+        *length += n;
+        if (*length == capacity)
+        {
+            capacity *= 2;
+            text = (char *)realloc(text, capacity);
+        }
+    }
+    return text;
+}
+
+int main(int argc, char **argv)
+{
+    const char *socketPath = COMPILE_SERVER_SOCKET;
+    const char *target = "mips";
+    const char *output = NULL;
+    const char *path = "input.cmm";
+    bool shutdownServer = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strncmp(argv[i], "--target=", 9) == 0)
+            target = argv[i] + 9;
+        else if (strcmp(argv[i], "--shutdown") == 0)
+            shutdownServer = true;
+        else if (argv[i][0] == '-' && argv[i][1] != '\0')
+            usage();
+        else
+            path = argv[i];
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Error: Socket path %s is too long\n", socketPath);
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        perror(socketPath);
+        return 1;
+    }
+
+    // Build the request header, followed by the source text for stdin
+    char header[3 * PATH_MAX];
+    char resolved[PATH_MAX];
+    int length = 0;
+    char *text = NULL;
+    size_t textLength = 0;
+    if (shutdownServer)
+    {
+        length = snprintf(header, sizeof(header), "shutdown\n\n");
+    }
+    else
+    {
+        length = snprintf(header, sizeof(header), "target %s\n", target);
+        if (output != NULL)
+        {
+            if (!absolutePath(output, resolved, sizeof(resolved)))
+                usage();
+            length += snprintf(header + length, sizeof(header) - length, "output %s\n", resolved);
+        }
+        if (strcmp(path, "-") == 0)
+        {
+            text = readInput(&textLength);
+            length += snprintf(header + length, sizeof(header) - length, "source %zu\n\n", textLength);
+        }
+        else
+        {
+            if (!absolutePath(path, resolved, sizeof(resolved)))
+                usage();
+            length += snprintf(header + length, sizeof(header) - length, "file %s\n\n", resolved);
+        }
+    }
+    if (!writeBytes(fd, header, (size_t)length) || (text != NULL && !writeBytes(fd, text, textLength)))
+    {
+        perror("send");
+        return 1;
+    }
+    free(text);
+
+    // Reply: "ok <length>" or "error <length>", then the body
+    FILE *reply = fdopen(fd, "r");
+    char status[16];
+    size_t bodyLength;
+    if (reply == NULL || fscanf(reply, "%15s %zu", status, &bodyLength) != 2 || fgetc(reply) != '\n')
+    {
+        fprintf(stderr, "Error: Bad reply from the compile server\n");
+        return 1;
+    }
+    bool ok = strcmp(status, "ok") == 0;
+    FILE *out = ok ? stdout : stderr;
+    char buffer[65536];
+    while (bodyLength > 0)
+    {
+        size_t n = fread(buffer, 1, bodyLength < sizeof(buffer) ? bodyLength : sizeof(buffer), reply);
+        if (n == 0)
+            break;
+        fwrite(buffer, 1, n, out);
+        bodyLength -= n;
+    }
+    if (ok && output != NULL)
+        fputc('\n', out);
+    fclose(reply);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,663 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "simulator.h"
+
+// Optimizer pipeline tuner: searches over pass orders and repetition
+// counts for the pipeline that makes a corpus of programs run in the
+// fewest simulated cycles, at an acceptable compile time, and saves it as
+// a preset the compiler loads with --passes=@file.
+//
+// Usage: ./cmmtune [options] program.cmm...
+//
+//   -c compiler        Compiler to tune (default ./main_program)
+//   -o file            Where to write the best pipeline (default tuned.passes)
+//   -g generations     Generations of the search (default 10)
+//   -p population      Pipelines per generation (default 16)
+//   -w weight          Weight of compile time against cycles (default 0.1)
+//   -s seed            Random seed (default 1)
+//   -n runs            Compiles timed per measurement, keeping the fastest (default 3)
+//   -m model           Cost model file for the simulator
+//   -r                 Random search instead of the genetic search
+//
+// A pipeline's score is its cycles over the corpus relative to -O2, plus
+// weight times its compile time relative to -O2, both averaged over the
+// programs; lower is better. Every program is run once at -O0 first, and
+// a pipeline that changes any program's output is rejected.
+
+#define DEFAULT_COMPILER "./main_program"
+#define DEFAULT_OUTPUT "tuned.passes"
+#define MAX_STEPS 100000000LL
+
+#define MAX_PASSES 32     // Registered passes the tuner can handle
+#define MAX_GENES 16      // Pipeline length limit
+#define MAX_PROGRAMS 256
+
+// Iteration caps the search chooses between for the repeated group
+static const int iterationChoices[] = {1, 2, 3, 4, 8, 16, 64};
+#define ITERATION_CHOICES (int)(sizeof(iterationChoices) / sizeof(iterationChoices[0]))
+
+// A pipeline: a list of passes with one optional group
+// [groupStart, groupEnd) that is repeated up to iterations times
+typedef struct
+{
+    int passes[MAX_GENES];
+    int count;
+    int groupStart;
+    int groupEnd;
+    int iterations;
+} Genome;
+
+typedef struct
+{
+    char *description;
+    double score;         // REJECTED if the pipeline breaks a program
+    double cycleRatio;
+    double compileRatio;
+} Evaluation;
+
+typedef struct
+{
+    const char *source;   // Path given on the command line
+    char *dir;            // Working directory the compiler runs in
+    char *expectedOutput; // Output at -O0
+    long long baseCycles; // Cycles at -O2
+    double baseSeconds;   // Compile time at -O2
+} Program;
+
+static char *passNames[MAX_PASSES];
+static int passCount = 0;
+static char *levelNames[8]; // "0", "1", "2", "s"
+static char *levelPipelines[8];
+static int levelCount = 0;
+
+static char compilerPath[PATH_MAX];
+static Program programs[MAX_PROGRAMS];
+static int programCount = 0;
+static CostModel model;
+static double compileWeight = 0.1;
+static int timingRuns = 3;
+
+// Every pipeline evaluated so far, so none is compiled twice
+static Evaluation *evaluations = NULL;
+static int evaluationCount = 0;
+static int evaluationCapacity = 0;
+
+static unsigned long long rngState = 1;
+
+#define REJECTED 1e30
+
+static void usage()
+{
+    fprintf(stderr, "Usage: ./cmmtune [-c compiler] [-o file] [-g generations] [-p population] [-w weight]\n"
+                    "                 [-n runs] [-s seed] [-m model] [-r] program.cmm...\n");
+    exit(1);
+}
+
+static unsigned randomNumber()
+{
+    // xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return (unsigned)((rngState * 2685821657736338717ULL) >> 32);
+}
+
+static int randomBelow(int n)
+{
+    return (int)(randomNumber() % (unsigned)n);
+}
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *joinPath(const char *dir, const char *name)
+{
+    char *path = (char *)malloc(strlen(dir) + strlen(name) + 2);
+    sprintf(path, "%s/%s", dir, name);
+    return path;
+}
+
+static bool copyFile(const char *from, const char *to)
+{
+    FILE *in = fopen(from, "rb");
+    if (in == NULL)
+        return false;
+    FILE *out = fopen(to, "wb");
+    if (out == NULL)
+    {
+        fclose(in);
+        return false;
+    }
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        fwrite(buffer, 1, n, out);
+    fclose(in);
+    return fclose(out) == 0;
+}
+
+// Run the compiler in dir with one extra argument, discarding its console
+// output. Returns its exit status, or -1 if it could not be run.
+static int runCompiler(const char *dir, const char *argument, double *seconds)
+{
+    double start = now();
+    pid_t pid = fork();
+    if (pid < 0)
+        return -1;
+    if (pid == 0)
+    {
+        int null = open("/dev/null", O_WRONLY);
+        if (null < 0 || chdir(dir) != 0)
+            _exit(127);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        execl(compilerPath, compilerPath, argument, (char *)NULL);
+        _exit(127);
+    }
+    int status;
+    if (waitpid(pid, &status, 0) < 0)
+        return -1;
+    *seconds = now() - start;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Ask the compiler for its passes and optimization levels
+static bool readPassRegistry()
+{
+    char command[PATH_MAX + 32];
+    snprintf(command, sizeof(command), "'%s' --list-passes", compilerPath);
+    FILE *pipe = popen(command, "r");
+    if (pipe == NULL)
+        return false;
+
+    char line[1024];
+    bool inLevels = false;
+    while (fgets(line, sizeof(line), pipe) != NULL)
+    {
+        line[strcspn(line, "\n")] = '\0';
+        if (strcmp(line, "Passes:") == 0)
+        {
+            inLevels = false;
+        }
+        else if (strcmp(line, "Levels:") == 0)
+        {
+            inLevels = true;
+        }
+        else if (!inLevels && passCount < MAX_PASSES)
+        {
+            char name[64];
+            if (sscanf(line, " %63s", name) == 1)
+                passNames[passCount++] = strdup(name);
+        }
+        else if (inLevels && levelCount < 8)
+        {
+            // "  -Ox pipeline"; -O0's pipeline is empty
+            char *pipeline = strchr(line + 2, ' ');
+            if (strncmp(line, "  -O", 4) != 0 || pipeline == NULL)
+                continue;
+            *pipeline = '\0';
+            levelNames[levelCount] = strdup(line + 4);
+            levelPipelines[levelCount++] = strdup(pipeline + 1);
+        }
+    }
+    return pclose(pipe) == 0 && passCount > 0;
+}
+
+static int passIndex(const char *name, size_t length)
+{
+    for (int i = 0; i < passCount; i++)
+    {
+        if (strlen(passNames[i]) == length && strncmp(passNames[i], name, length) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// Read a pipeline description (without budgets) into a genome
+static bool parseGenome(const char *description, Genome *genome)
+{
+    genome->count = 0;
+    genome->groupStart = genome->groupEnd = 0;
+    genome->iterations = 64;
+    const char *p = description;
+    while (*p != '\0')
+    {
+        if (*p == ',')
+        {
+            p++;
+        }
+        else if (*p == '{')
+        {
+            genome->groupStart = genome->count;
+            p++;
+        }
+        else if (*p == '}')
+        {
+            genome->groupEnd = genome->count;
+            p++;
+            if (*p == '*')
+                genome->iterations = (int)strtol(p + 1, (char **)&p, 10);
+        }
+        else
+        {
+            size_t length = strcspn(p, ",{}");
+            int pass = passIndex(p, length);
+            if (pass < 0 || genome->count == MAX_GENES)
+                return false;
+            genome->passes[genome->count++] = pass;
+            p += length;
+        }
+    }
+    return true;
+}
+
+static void describeGenome(const Genome *genome, char *description, size_t size)
+{
+    size_t length = 0;
+    description[0] = '\0';
+    for (int i = 0; i < genome->count; i++)
+    {
+        bool opens = i == genome->groupStart && genome->groupEnd > genome->groupStart;
+        length += snprintf(description + length, size - length, "%s%s%s", i > 0 ? "," : "", opens ? "{" : "",
+                           passNames[genome->passes[i]]);
+        if (i + 1 == genome->groupEnd && genome->groupEnd > genome->groupStart)
+            length += snprintf(description + length, size - length, "}*%d", genome->iterations);
+    }
+}
+
+// Keep the group inside the pass list
+static void fixGroup(Genome *genome)
+{
+    if (genome->groupEnd > genome->count)
+        genome->groupEnd = genome->count;
+    if (genome->groupStart > genome->groupEnd)
+        genome->groupStart = genome->groupEnd;
+}
+
+static void randomGenome(Genome *genome)
+{
+    genome->count = 1 + randomBelow(MAX_GENES / 2);
+    for (int i = 0; i < genome->count; i++)
+        genome->passes[i] = randomBelow(passCount);
+    genome->groupStart = randomBelow(genome->count);
+    genome->groupEnd = genome->groupStart + 1 + randomBelow(genome->count - genome->groupStart);
+    genome->iterations = iterationChoices[randomBelow(ITERATION_CHOICES)];
+}
+
+static void mutateGenome(Genome *genome)
+{
+    switch (randomBelow(6))
+    {
+    case 0: // Replace a pass
+        genome->passes[randomBelow(genome->count)] = randomBelow(passCount);
+        break;
+    case 1: // Insert a pass
+        if (genome->count < MAX_GENES)
+        {
+            int at = randomBelow(genome->count + 1);
+            memmove(&genome->passes[at + 1], &genome->passes[at], sizeof(int) * (genome->count - at));
+            genome->passes[at] = randomBelow(passCount);
+            genome->count++;
+            if (at < genome->groupStart)
+                genome->groupStart++;
+            if (at < genome->groupEnd)
+                genome->groupEnd++;
+        }
+        break;
+    case 2: // Delete a pass
+        if (genome->count > 1)
+        {
+            int at = randomBelow(genome->count);
+            memmove(&genome->passes[at], &genome->passes[at + 1], sizeof(int) * (genome->count - at - 1));
+            genome->count--;
+            if (at < genome->groupStart)
+                genome->groupStart--;
+            if (at < genome->groupEnd)
+                genome->groupEnd--;
+        }
+        break;
+    case 3: // Swap two passes
+    {
+        int a = randomBelow(genome->count), b = randomBelow(genome->count);
+        int pass = genome->passes[a];
+        genome->passes[a] = genome->passes[b];
+        genome->passes[b] = pass;
+        break;
+    }
+    case 4: // Move the group
+        genome->groupStart = randomBelow(genome->count + 1);
+        genome->groupEnd = genome->groupStart + randomBelow(genome->count - genome->groupStart + 1);
+        break;
+    default: // Change the iteration cap
+        genome->iterations = iterationChoices[randomBelow(ITERATION_CHOICES)];
+        break;
+    }
+    fixGroup(genome);
+}
+
+// One-point crossover of the pass lists; the group comes from the first parent
+static void crossGenomes(const Genome *a, const Genome *b, Genome *child)
+{
+    int cutA = randomBelow(a->count + 1);
+    int cutB = randomBelow(b->count + 1);
+    *child = *a;
+    child->count = cutA;
+    for (int i = cutB; i < b->count && child->count < MAX_GENES; i++)
+        child->passes[child->count++] = b->passes[i];
+    if (child->count == 0)
+        child->passes[child->count++] = randomBelow(passCount);
+    fixGroup(child);
+}
+
+// Compile a program with a pipeline and simulate the result. Returns
+// false if the compile fails or the program's output changes.
+static bool measure(Program *program, const char *pipelineArgument, long long *cycles, double *seconds, char **output)
+{
+    // Compile times of a few milliseconds are noisy, so keep the fastest
+    for (int run = 0; run < timingRuns; run++)
+    {
+        double runSeconds;
+        if (runCompiler(program->dir, pipelineArgument, &runSeconds) != 0)
+            return false;
+        if (run == 0 || runSeconds < *seconds)
+            *seconds = runSeconds;
+    }
+
+    char *asmPath = joinPath(program->dir, "output.asm");
+    MipsProgram *mips = assembleMipsFile(asmPath);
+    free(asmPath);
+    if (mips == NULL)
+        return false;
+
+    char *text = NULL;
+    size_t length = 0;
+    FILE *out = open_memstream(&text, &length);
+    SimulatorStats stats;
+    bool ok = runMipsProgram(mips, &model, out, MAX_STEPS, &stats);
+    fclose(out);
+    freeMipsProgram(mips);
+
+    if (ok && program->expectedOutput != NULL && strcmp(text, program->expectedOutput) != 0)
+        ok = false;
+    *cycles = stats.cycles;
+    if (output != NULL && ok)
+        *output = text;
+    else
+        free(text);
+    return ok;
+}
+
+// Score a pipeline, returning its index in evaluations (which may move
+// when it grows)
+static int evaluate(const char *description)
+{
+    for (int i = 0; i < evaluationCount; i++)
+    {
+        if (strcmp(evaluations[i].description, description) == 0)
+            return i;
+    }
+
+    char *argument = (char *)malloc(strlen(description) + 16);
+    sprintf(argument, "--passes=%s", description);
+    double cycleRatio = 0.0, compileRatio = 0.0;
+    bool ok = true;
+    for (int i = 0; i < programCount && ok; i++)
+    {
+        long long cycles;
+        double seconds;
+        ok = measure(&programs[i], argument, &cycles, &seconds, NULL);
+        cycleRatio += (double)cycles / programs[i].baseCycles;
+        compileRatio += seconds / programs[i].baseSeconds;
+    }
+    free(argument);
+
+    if (evaluationCount == evaluationCapacity)
+    {
+        evaluationCapacity = evaluationCapacity ? evaluationCapacity * 2 : 64;
+        evaluations = (Evaluation *)realloc(evaluations, sizeof(Evaluation) * evaluationCapacity);
+    }
+    Evaluation *evaluation = &evaluations[evaluationCount++];
+    evaluation->description = strdup(description);
+    evaluation->cycleRatio = cycleRatio / programCount;
+    evaluation->compileRatio = compileRatio / programCount;
+    evaluation->score = ok ? evaluation->cycleRatio + compileWeight * evaluation->compileRatio : REJECTED;
+    return evaluationCount - 1;
+}
+
+static double scoreGenome(const Genome *genome)
+{
+    char description[1024];
+    describeGenome(genome, description, sizeof(description));
+    int evaluation = evaluate(description);
+    return evaluations[evaluation].score;
+}
+
+// Tournament of three
+static const Genome *selectParent(const Genome *population, const double *scores, int size)
+{
+    int best = randomBelow(size);
+    for (int i = 0; i < 2; i++)
+    {
+        int other = randomBelow(size);
+        if (scores[other] < scores[best])
+            best = other;
+    }
+    return &population[best];
+}
+
+// Set up a working directory per program and record its reference output
+// and -O2 cycles and compile time
+static bool prepareProgram(Program *program, const char *root, int index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%d", index);
+    program->dir = joinPath(root, name);
+    char *input = joinPath(program->dir, "input.cmm");
+    bool ok = mkdir(program->dir, 0700) == 0 && copyFile(program->source, input);
+    free(input);
+    if (!ok)
+    {
+        fprintf(stderr, "Error: Unable to copy %s\n", program->source);
+        return false;
+    }
+
+    long long cycles;
+    double seconds;
+    program->expectedOutput = NULL;
+    if (!measure(program, "-O0", &cycles, &seconds, &program->expectedOutput))
+    {
+        fprintf(stderr, "Error: %s does not compile and run at -O0\n", program->source);
+        return false;
+    }
+    if (!measure(program, "-O2", &program->baseCycles, &program->baseSeconds, NULL))
+    {
+        fprintf(stderr, "Error: %s changes its output at -O2\n", program->source);
+        return false;
+    }
+    fprintf(stderr, "%s: %lld cycles at -O0, %lld at -O2 (%.1f ms compile)\n", program->source, cycles,
+            program->baseCycles, program->baseSeconds * 1000.0);
+    return true;
+}
+
+static void removeWorkDirectory(const char *root)
+{
+    static const char *files[] = {"input.cmm", "output.asm", "TACsem.ir", "TACopt.ir", "TACgen.ir"};
+    for (int i = 0; i < programCount; i++)
+    {
+        if (programs[i].dir == NULL)
+            continue;
+        for (size_t f = 0; f < sizeof(files) / sizeof(files[0]); f++)
+        {
+            char *path = joinPath(programs[i].dir, files[f]);
+            unlink(path);
+            free(path);
+        }
+        rmdir(programs[i].dir);
+    }
+    rmdir(root);
+}
+
+static bool writePreset(const char *path, const Evaluation *best, int generations, bool randomSearch)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    fprintf(file, "# Optimizer pipeline tuned by cmmtune (%s search, %d generations, %d pipelines) over:\n",
+            randomSearch ? "random" : "genetic", generations, evaluationCount);
+    for (int i = 0; i < programCount; i++)
+        fprintf(file, "#   %s\n", programs[i].source);
+    fprintf(file, "# Relative to -O2: %.4f of the cycles, %.4f of the compile time\n", best->cycleRatio,
+            best->compileRatio);
+    fprintf(file, "# Load with --passes=@%s\n", path);
+    fprintf(file, "%s\n", best->description);
+    return fclose(file) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *compiler = DEFAULT_COMPILER;
+    const char *outputPath = DEFAULT_OUTPUT;
+    int generations = 10;
+    int populationSize = 16;
+    bool randomSearch = false;
+    defaultCostModel(&model);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            compiler = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+            generations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+            populationSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            compileWeight = atof(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            timingRuns = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            rngState = strtoull(argv[++i], NULL, 10) | 1;
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            if (!loadCostModel(&model, argv[++i]))
+                return 1;
+        }
+        else if (strcmp(argv[i], "-r") == 0)
+            randomSearch = true;
+        else if (argv[i][0] == '-' || programCount == MAX_PROGRAMS)
+            usage();
+        else
+            programs[programCount++].source = argv[i];
+    }
+    if (programCount == 0 || generations < 1 || populationSize < 4 || compileWeight < 0 || timingRuns < 1)
+        usage();
+
+    if (realpath(compiler, compilerPath) == NULL || !readPassRegistry())
+    {
+        fprintf(stderr, "Error: Unable to run %s --list-passes\n", compiler);
+        return 1;
+    }
+
+    char root[] = "/tmp/cmmtune-XXXXXX";
+    if (mkdtemp(root) == NULL)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    for (int i = 0; i < programCount; i++)
+    {
+        if (!prepareProgram(&programs[i], root, i))
+        {
+            removeWorkDirectory(root);
+            return 1;
+        }
+    }
+
+    // The first generation holds the compiler's own levels and random pipelines
+    Genome *population = (Genome *)malloc(sizeof(Genome) * populationSize);
+    Genome *next = (Genome *)malloc(sizeof(Genome) * populationSize);
+    double *scores = (double *)malloc(sizeof(double) * populationSize);
+    int seeded = 0;
+    int best = -1;
+    for (int i = 0; i < levelCount && seeded < populationSize; i++)
+    {
+        if (levelPipelines[i][0] == '\0' || !parseGenome(levelPipelines[i], &population[seeded]))
+            continue;
+        // Start from -O2, which every score is relative to
+        if (strcmp(levelNames[i], "2") == 0)
+        {
+            char description[1024];
+            describeGenome(&population[seeded], description, sizeof(description));
+            best = evaluate(description);
+        }
+        seeded++;
+    }
+    for (int i = seeded; i < populationSize; i++)
+        randomGenome(&population[i]);
+    if (best < 0)
+        best = evaluate("");
+    for (int generation = 0; generation < generations; generation++)
+    {
+        int bestIndex = 0;
+        for (int i = 0; i < populationSize; i++)
+        {
+            scores[i] = scoreGenome(&population[i]);
+            if (scores[i] < scores[bestIndex])
+                bestIndex = i;
+        }
+        char description[1024];
+        describeGenome(&population[bestIndex], description, sizeof(description));
+        int evaluation = evaluate(description);
+        if (evaluations[evaluation].score < evaluations[best].score)
+            best = evaluation;
+        fprintf(stderr, "Generation %d: best %.4f (cycles %.4f, compile %.4f) %s\n", generation + 1,
+                evaluations[best].score, evaluations[best].cycleRatio, evaluations[best].compileRatio,
+                evaluations[best].description);
+
+        // The best pipeline survives; the rest are bred from tournament
+        // winners, or drawn at random for a random search
+        next[0] = population[bestIndex];
+        for (int i = 1; i < populationSize; i++)
+        {
+            if (randomSearch)
+            {
+                randomGenome(&next[i]);
+                continue;
+            }
+            const Genome *a = selectParent(population, scores, populationSize);
+            if (randomBelow(2) == 0)
+                crossGenomes(a, selectParent(population, scores, populationSize), &next[i]);
+            else
+                next[i] = *a;
+            mutateGenome(&next[i]);
+        }
+        Genome *swap = population;
+        population = next;
+        next = swap;
+    }
+
+    bool ok = evaluations[best].score < REJECTED && writePreset(outputPath, &evaluations[best], generations, randomSearch);
+    if (ok)
+        fprintf(stderr, "Wrote %s: %s\n", outputPath, evaluations[best].description);
+
+    removeWorkDirectory(root);
+    free(population);
+    free(next);
+    free(scores);
+    return ok ? 0 : 1;
+}
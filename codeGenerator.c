@@ -2,19 +2,24 @@
 
 #include "codeGenerator.h"
 #include "utils.h"
+#include "mipsSelector.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
 
 static FILE *outputFile;
+static bool ownsOutputFile = false; // Opened by initCodeGenerator, so closed here
+
+// Backend in use
+static const CodeGenTarget *target = &mipsTarget;
 
 // Available registers for int (excluding $t8 and $t9)
 const char *availableRegisters[] = {"$t0", "$t1", "$t2", "$t3", "$t4", "$t5", "$t6", "$t7"};
 #define NUM_AVAILABLE_REGISTERS 8
 bool registerInUse[NUM_AVAILABLE_REGISTERS] = {false};
 
-// Available registers for float (excluding $f16 and $f17)
+// Available registers for float (excluding the scratch registers $f16 and $f18)
 const char *availableFloatRegisters[] = {"$f0", "$f2", "$f4", "$f6", "$f8", "$f10", "$f12", "$f14"};
 #define NUM_AVAILABLE_FLOAT_REGISTERS 8
 bool floatRegisterInUse[NUM_AVAILABLE_FLOAT_REGISTERS] = {false};
@@ -26,6 +31,182 @@ bool floatRegisterInUse[NUM_AVAILABLE_FLOAT_REGISTERS] = {false};
 // Register map to keep track of variable to register mappings
 RegisterMapEntry registerMap[MAX_REGISTER_MAP_SIZE];
 
+// Instructions being translated, from currentInstruction through
+// currentWindowEnd; their operands are never evicted to make room
+static TAC *currentInstruction = NULL;
+static TAC *currentWindowEnd = NULL;
+
+// Spill slots of virtual registers, indexed by virtual register number
+static SpillSlot *spillSlots = NULL;
+static int spillSlotCapacity = 0;
+static int spillAreaSize = 0;
+static int spillAreaPeak = 0;
+
+static SpillSlot *getSpillSlot(const char *temp)
+{
+    int number = virtualRegisterNumber(temp);
+    if (number >= spillSlotCapacity)
+    {
+        int capacity = spillSlotCapacity ? spillSlotCapacity : 64;
+        while (capacity <= number)
+            capacity *= 2;
+        spillSlots = (SpillSlot *)realloc(spillSlots, sizeof(SpillSlot) * capacity);
+        for (int i = spillSlotCapacity; i < capacity; i++)
+        {
+            spillSlots[i].offset = -1;
+            spillSlots[i].isFloat = false;
+        }
+        spillSlotCapacity = capacity;
+    }
+    return &spillSlots[number];
+}
+
+// Forget every slot assignment; the area keeps the largest size it reached
+static void resetSpillSlots()
+{
+    for (int i = 0; i < spillSlotCapacity; i++)
+    {
+        spillSlots[i].offset = -1;
+        spillSlots[i].isFloat = false;
+    }
+    spillAreaSize = 0;
+}
+
+static void freeSpillSlots()
+{
+    free(spillSlots);
+    spillSlots = NULL;
+    spillSlotCapacity = 0;
+    spillAreaSize = 0;
+    spillAreaPeak = 0;
+}
+
+static bool isFloatRegister(const char *regName)
+{
+    return regName[0] == '$' && regName[1] == 'f';
+}
+
+// Whether the integer register bound to variable holds the bits of a float
+static bool holdsFloatBits(const char *variable)
+{
+    for (int i = 0; i < MAX_REGISTER_MAP_SIZE; i++)
+    {
+        if (registerMap[i].variable != NULL && strcmp(registerMap[i].variable, variable) == 0)
+            return registerMap[i].holdsFloat;
+    }
+    return false;
+}
+
+// Write a register back to the variable's home: user variables live in .data,
+// virtual registers in a spill slot, and literals need no store at all
+static void storeVariable(const char *var, const char *regName)
+{
+    if (isConstant(var) || isFloatConstant(var))
+        return;
+
+    fprintf(outputFile, "# Storing variable %s back to memory\n", var);
+    if (isTemporaryVariable(var))
+    {
+        SpillSlot *slot = getSpillSlot(var);
+        if (slot->offset < 0)
+        {
+            slot->offset = spillAreaSize;
+            spillAreaSize += 4;
+            if (spillAreaSize > spillAreaPeak)
+                spillAreaPeak = spillAreaSize;
+        }
+        slot->isFloat = isFloatRegister(regName) || holdsFloatBits(var);
+        target->storeSpill(regName, slot->offset);
+    }
+    else
+    {
+        target->storeHome(regName, var);
+    }
+}
+
+static bool isOperandOf(TAC *instr, const char *var)
+{
+    return instr != NULL &&
+           ((instr->arg1 != NULL && strcmp(instr->arg1, var) == 0) ||
+            (instr->arg2 != NULL && strcmp(instr->arg2, var) == 0) ||
+            (instr->result != NULL && strcmp(instr->result, var) == 0));
+}
+
+static bool isWindowOperand(const char *var)
+{
+    for (TAC *instr = currentInstruction; instr != NULL; instr = instr->next)
+    {
+        if (isOperandOf(instr, var))
+            return true;
+        if (instr == currentWindowEnd)
+            break;
+    }
+    return false;
+}
+
+void protectWindowOperands(TAC *last)
+{
+    currentWindowEnd = last;
+}
+
+// Free one of the given registers by writing its value back to memory. The
+// register stays marked in use and is handed to the caller.
+static const char *evictRegister(const char **registers, int count)
+{
+    for (int i = 0; i < MAX_REGISTER_MAP_SIZE; i++)
+    {
+        const char *var = registerMap[i].variable;
+        if (var == NULL || isWindowOperand(var))
+            continue;
+        for (int r = 0; r < count; r++)
+        {
+            if (strcmp(registerMap[i].regName, registers[r]) == 0)
+            {
+                fprintf(outputFile, "# Spilling register %s to memory\n", registers[r]);
+                storeVariable(var, registers[r]);
+                removeVariableFromRegisterMap(var);
+                return registers[r];
+            }
+        }
+    }
+    return NULL;
+}
+
+// Get a floating-point register holding the operand, converting integers.
+// Values not already in a float register are loaded into scratch.
+const char *getFloatOperand(const char *operand, const char *scratch, SymbolTable *symTab)
+{
+    const char *reg = getRegisterForVariable(operand);
+    if (reg != NULL && isFloatRegister(reg))
+        return reg;
+
+    if (isFloatConstant(operand) || isConstant(operand))
+    {
+        target->loadFloatImmediate(scratch, operand);
+        return scratch;
+    }
+
+    if (isFloatOperand(operand, symTab))
+    {
+        // Float bits in an integer register are moved across unconverted
+        if (reg != NULL)
+            target->moveRegister(scratch, reg);
+        else
+            loadOperand(operand, scratch);
+    }
+    else
+    {
+        // Integer value: move it across and convert
+        if (reg == NULL)
+        {
+            loadOperand(operand, ADDRESS_CALC_REGISTER);
+            reg = ADDRESS_CALC_REGISTER;
+        }
+        target->convertIntToFloat(reg, scratch);
+    }
+    return scratch;
+}
+
 void initializeRegisterMap()
 {
     for (int i = 0; i < MAX_REGISTER_MAP_SIZE; i++)
@@ -49,54 +230,77 @@ void freeRegisterMap()
     }
 }
 
+void setCodeGenTarget(const CodeGenTarget *codeGenTarget)
+{
+    target = codeGenTarget;
+}
+
+FILE *codeGeneratorOutput()
+{
+    return outputFile;
+}
+
 void initCodeGenerator(const char *outputFilename)
 {
-    outputFile = fopen(outputFilename, "w");
-    if (outputFile == NULL)
+    FILE *out = fopen(outputFilename, "w");
+    if (out == NULL)
     {
         perror("Failed to open output file");
-        exit(EXIT_FAILURE);
+        abortCompilation();
     }
-    initializeRegisterMap();
+    initCodeGeneratorOutput(out);
+    ownsOutputFile = true;
 }
 
-void generateMIPS(TAC *tacInstructions, SymbolTable *symTab)
+void initCodeGeneratorOutput(FILE *out)
 {
-    VarNode *varList = NULL; // Declare and initialize varList
-
-    // Collect variables from TAC instructions
-    collectVariables(tacInstructions, &varList);
-
-    // Generate the .data section
-    fprintf(outputFile, ".data\n");
-
-    // Declare the spill area for register spilling
-    fprintf(outputFile, "spill_area: .word 0\n");
+    outputFile = out;
+    ownsOutputFile = false;
+    initializeRegisterMap();
+}
 
+// Declare the variables in the symbol table. Arrays missing from varList
+// have no access left and are skipped; a NULL varList keeps every array.
+static void generateDataSection(SymbolTable *symTab, VarNode *varList)
+{
     // Declare variables from the symbol table
     for (int i = 0; i < symTab->size; i++)
     {
         Symbol *symbol = symTab->table[i];
         while (symbol != NULL)
         {
-            if (symbol->isArray)
+            if (symbol->isArray && varList != NULL && !isVariableInList(varList, symbol->name))
+            {
+                // No access to this array survived optimization
+            }
+            else if (symbol->isArray && symbol->arrayInfo->knownCount == 0)
             {
                 int totalSize = symbol->arrayInfo->size * 4; // Assuming 4 bytes per element
                 fprintf(outputFile, "%s: .space %d\n", symbol->name, totalSize);
             }
-            else if (strcmp(symbol->type, "float") == 0) //  || !isdigit(symbol->name[0])
+            else if (symbol->isArray)
+            {
+                // Some elements have static initializers
+                fprintf(outputFile, "%s:\n", symbol->name);
+                generateArrayData(symbol->arrayInfo);
+            }
+            else if (symbol->type == DataType_Float) //  || !isdigit(symbol->name[0])
             {
                 // Check if the float symbol has a value
-                if (symbol->value != NULL)
+                if (symbol->value != NULL && isConstant(symbol->value))
+                {
+                    // Integer initializer for a float variable
+                    fprintf(outputFile, "%s: .float %s.0\n", symbol->name, symbol->value);
+                }
+                else if (symbol->value != NULL)
                 {
                     // Print the float value in the .data section
                     fprintf(outputFile, "%s: .float %s\n", symbol->name, symbol->value);
                 }
                 else
                 {
-
                     // If no value is set, default to 0.0
-                    fatal("%s: .float 0.0\n"); //, symbol->name
+                    fprintf(outputFile, "%s: .float 0.0\n", symbol->name);
                 }
             }
             else
@@ -109,385 +313,429 @@ void generateMIPS(TAC *tacInstructions, SymbolTable *symTab)
                 {
                     // Skip writing this entry if it is purely numeric
                 }
+                else if (symbol->value != NULL)
+                {
+                    // Initial value folded in by staticDataInitialization
+                    fprintf(outputFile, "%s: %s %s\n", symbol->name, target->wordDirective, symbol->value);
+                }
                 else
                 {
-                    fprintf(outputFile, "%s: .word 0\n", symbol->name);
+                    fprintf(outputFile, "%s: %s 0\n", symbol->name, target->wordDirective);
                 }
             }
             symbol = symbol->next;
         }
     }
+}
 
-    // Declare temporary variables not in symbol table
-    // VarNode *currentVar = varList;
-    // while (currentVar != NULL)
-    // {
-    //     if (!findSymbol(symTab, currentVar->name))
-    //     {
-    //         if (!isConstant(currentVar->name))
-    //         {
-    //             fprintf(outputFile, "%s: .word 0\n", currentVar->name);
-    //         }
-    //     }
-    //     currentVar = currentVar->next;
-    // }
-
+static void generateMIPSTextPrologue()
+{
     // Start the .text section and main function
     fprintf(outputFile, ".text\n");
     fprintf(outputFile, ".globl main\n");
     fprintf(outputFile, "main:\n");
+}
+
+static void generateMIPSTextEpilogue()
+{
+    // Exit program
+    fprintf(outputFile, "\tli $v0, 10\n");
+    fprintf(outputFile, "\tsyscall\n");
+}
+
+// Slots for temporaries that did not fit in the register file
+static void generateSpillArea()
+{
+    if (spillAreaPeak > 0)
+    {
+        fprintf(outputFile, "spill_area: .space %d\n", spillAreaPeak);
+    }
+}
+
+void generateCode(TAC *tacInstructions, SymbolTable *symTab)
+{
+    VarNode *varList = NULL; // Declare and initialize varList
+
+    // Collect variables from TAC instructions
+    collectVariables(tacInstructions, &varList);
+
+    // Generate the .data section
+    fprintf(outputFile, ".data\n");
+    generateDataSection(symTab, varList);
+
+    // Free the variable list
+    freeVariableList(varList);
+
+    target->textPrologue();
+    generateInstructions(tacInstructions, symTab);
+    target->textEpilogue();
+
+    if (spillAreaPeak > 0)
+    {
+        fprintf(outputFile, ".data\n");
+        generateSpillArea();
+    }
+    freeSpillSlots();
+}
+
+// Whether an operand holds an integer in a register, a spill slot or .data
+bool isIntegerOperand(const char *operand, SymbolTable *symTab)
+{
+    if (isConstant(operand) || isFloatConstant(operand))
+        return false;
+    const char *reg = getRegisterForVariable(operand);
+    if (reg != NULL && (isFloatRegister(reg) || holdsFloatBits(operand)))
+        return false;
+    if (isTemporaryVariable(operand))
+        return reg != NULL || !getSpillSlot(operand)->isFloat;
+    Symbol *symbol = findSymbol(symTab, operand);
+    return symbol != NULL && symbol->type == DataType_Int && !symbol->isArray;
+}
+
+// Whether an operand holds a float in a register, a spill slot or .data
+bool isFloatOperand(const char *operand, SymbolTable *symTab)
+{
+    if (isConstant(operand) || isFloatConstant(operand))
+        return isFloatConstant(operand);
+    const char *reg = getRegisterForVariable(operand);
+    if (reg != NULL && (isFloatRegister(reg) || holdsFloatBits(operand)))
+        return true;
+    if (isTemporaryVariable(operand))
+        return reg == NULL && getSpillSlot(operand)->isFloat;
+    Symbol *symbol = findSymbol(symTab, operand);
+    return symbol != NULL && symbol->type == DataType_Float && !symbol->isArray;
+}
+
+// Lower one TAC instruction to MIPS
+static TAC *lowerMIPSInstruction(TAC *current, SymbolTable *symTab)
+{
+    // Arithmetic, assignments, arrays and branches go through the selector
+    TAC *last = selectMIPSInstructions(current, symTab);
+    if (last != NULL)
+        return last;
+
+    if (strcmp(current->op, "fadd") == 0 || strcmp(current->op, "fsub") == 0 ||
+             strcmp(current->op, "fmul") == 0 || strcmp(current->op, "fdiv") == 0)
+    {
+        // Generate code for floating-point operations
+        fprintf(outputFile, "# Generating MIPS code for operation %s\n", current->op);
+        const char *reg1 = getFloatOperand(current->arg1, "$f16", symTab);
+        const char *reg2 = getFloatOperand(current->arg2, "$f18", symTab);
+        const char *resultReg = allocateFloatRegister();
+        if (!resultReg)
+        {
+            fprintf(stderr, "Error: No available registers for result %s\n", current->result);
+            abortCompilation();
+        }
+        setRegisterForVariable(current->result, resultReg);
+        // "fadd" becomes "add.s" and so on
+        fprintf(outputFile, "\t%s.s %s, %s, %s\n", current->op + 1, resultReg, reg1, reg2);
+    }
+    else if (getComparisonInstruction(current->op) != NULL)
+    {
+        // The selector takes integer comparisons, so this one is a float
+        // compare: set the result, then clear it unless the flag holds
+        fprintf(outputFile, "# Generating MIPS code for float comparison %s\n", current->op);
+        const char *reg1 = getFloatOperand(current->arg1, "$f16", symTab);
+        const char *reg2 = getFloatOperand(current->arg2, "$f18", symTab);
+        const char *resultReg = allocateRegister();
+        if (!resultReg)
+        {
+            fprintf(stderr, "Error: No available registers for result %s\n", current->result);
+            abortCompilation();
+        }
+        setRegisterForVariable(current->result, resultReg);
+        const char *op = current->op;
+        // Only eq, lt and le exist, so > and >= swap their operands
+        bool swapped = op[0] == '>';
+        const char *compare = op[0] == '=' || op[0] == '!' ? "eq" : op[1] == '=' ? "le" : "lt";
+        fprintf(outputFile, "\tli %s, 1\n", resultReg);
+        fprintf(outputFile, "\tc.%s.s %s, %s\n", compare, swapped ? reg2 : reg1, swapped ? reg1 : reg2);
+        fprintf(outputFile, "\t%s %s, $zero\n", op[0] == '!' ? "movt" : "movf", resultReg);
+    }
+    else if (strcmp(current->op, "label") == 0)
+    {
+        // Control flow joins here, so every value must be in memory
+        spillAllRegisters();
+        fprintf(outputFile, "%s:\n", current->result);
+    }
+    else if (strcmp(current->op, "goto") == 0)
+    {
+        fprintf(outputFile, "# Generating MIPS code for jump\n");
+        spillAllRegisters();
+        fprintf(outputFile, "\tj %s\n", current->result);
+    }
+    else if (strcmp(current->op, "fmov") == 0)
+    {
+        // Floating-point assignment goes through the reserved register $f16
+        fprintf(outputFile, "# Generating MIPS code for float assignment\n");
+        const char *srcReg = getFloatOperand(current->arg1, "$f16", symTab);
+        fprintf(outputFile, "\ts.s %s, %s\n", srcReg, current->result);
+    }
+    else if (strcmp(current->op, "write") == 0)
+    {
+        // Write operation
+        fprintf(outputFile, "# Generating MIPS code for write operation\n");
+        const char *srcReg = getRegisterForVariable(current->arg1);
+        if (!srcReg)
+        {
+            // Load operand into $a0 directly if it's not in a register
+            loadOperand(current->arg1, "$a0");
+        }
+        else
+        {
+            // Move value to $a0
+            fprintf(outputFile, "\tmove $a0, %s\n", srcReg);
+        }
+        fprintf(outputFile, "\tli $v0, 1\n"); // Syscall code for print_int
+        fprintf(outputFile, "\tsyscall\n");
+        // Print newline character
+        fprintf(outputFile, "\tli $a0, 10\n"); // ASCII code for newline
+        fprintf(outputFile, "\tli $v0, 11\n"); // Syscall code for print_char
+        fprintf(outputFile, "\tsyscall\n");
+    }
+    else if (strcmp(current->op, "write_float") == 0)
+    {
+        // Write operation for floating-point numbers
+        fprintf(outputFile, "# Generating MIPS code for write_float operation\n");
+        const char *srcReg = getFloatOperand(current->arg1, "$f12", symTab);
+        if (strcmp(srcReg, "$f12") != 0)
+        {
+            // Move value to $f12 for floating-point printing
+            fprintf(outputFile, "\tmov.s $f12, %s\n", srcReg);
+        }
+        fprintf(outputFile, "\tli $v0, 2\n"); // Syscall code for print_float
+        fprintf(outputFile, "\tsyscall\n");
 
+        // Print newline character after the float
+        fprintf(outputFile, "\tli $a0, 10\n"); // ASCII code for newline
+        fprintf(outputFile, "\tli $v0, 11\n"); // Syscall code for print_char
+        fprintf(outputFile, "\tsyscall\n");
+    }
+    else
+    {
+        fprintf(stderr, "Warning: Unsupported TAC operation '%s'\n", current->op);
+    }
+    return current;
+}
+
+static void mipsStoreHome(const char *regName, const char *var)
+{
+    fprintf(outputFile, "\t%s %s, %s\n", isFloatRegister(regName) ? "s.s" : "sw", regName, var);
+}
+
+static void mipsStoreSpill(const char *regName, int offset)
+{
+    fprintf(outputFile, "\t%s %s, spill_area+%d\n", isFloatRegister(regName) ? "s.s" : "sw", regName, offset);
+}
+
+static void mipsLoadHome(const char *regName, const char *var)
+{
+    fprintf(outputFile, "\t%s %s, %s\n", isFloatRegister(regName) ? "l.s" : "lw", regName, var);
+}
+
+static void mipsLoadSpill(const char *regName, int offset)
+{
+    fprintf(outputFile, "\t%s %s, spill_area+%d\n", isFloatRegister(regName) ? "l.s" : "lw", regName, offset);
+}
+
+static void mipsLoadImmediate(const char *regName, const char *constant)
+{
+    fprintf(outputFile, "\tli %s, %s\n", regName, constant);
+}
+
+static void mipsLoadFloatImmediate(const char *regName, const char *constant)
+{
+    fprintf(outputFile, "\tli.s %s, %s%s\n", regName, constant, isConstant(constant) ? ".0" : "");
+}
+
+static void mipsMoveRegister(const char *destReg, const char *srcReg)
+{
+    if (isFloatRegister(destReg) == isFloatRegister(srcReg))
+        fprintf(outputFile, "\t%s %s, %s\n", isFloatRegister(destReg) ? "mov.s" : "move", destReg, srcReg);
+    else if (isFloatRegister(destReg))
+        fprintf(outputFile, "\tmtc1 %s, %s\n", srcReg, destReg);
+    else
+        fprintf(outputFile, "\tmfc1 %s, %s\n", destReg, srcReg);
+}
+
+static void mipsConvertIntToFloat(const char *intReg, const char *floatReg)
+{
+    fprintf(outputFile, "\tmtc1 %s, %s\n", intReg, floatReg);
+    fprintf(outputFile, "\tcvt.s.w %s, %s\n", floatReg, floatReg);
+}
+
+const CodeGenTarget mipsTarget = {
+    "mips",
+    ".word",
+    generateMIPSTextPrologue,
+    generateMIPSTextEpilogue,
+    lowerMIPSInstruction,
+    mipsStoreHome,
+    mipsStoreSpill,
+    mipsLoadHome,
+    mipsLoadSpill,
+    mipsLoadImmediate,
+    mipsLoadFloatImmediate,
+    mipsMoveRegister,
+    mipsConvertIntToFloat,
+};
+
+// Translate a run of TAC into .text. Every register is written back at the
+// end, so consecutive runs can be generated one after another.
+void generateInstructions(TAC *tacInstructions, SymbolTable *symTab)
+{
     TAC *current = tacInstructions;
     while (current != NULL)
     {
+        currentInstruction = current;
+        currentWindowEnd = current;
+        // A backend may translate several instructions at once
+        TAC *last = current;
         if (current->op != NULL)
         {
-            if (strcmp(current->op, "+") == 0 || strcmp(current->op, "-") == 0 ||
-                strcmp(current->op, "*") == 0 || strcmp(current->op, "/") == 0)
-            {
-                // Generate code for binary operations
-                fprintf(outputFile, "# Generating MIPS code for operation %s\n", current->op);
-                // Load operands
-                const char *reg1 = getRegisterForVariable(current->arg1);
-                if (!reg1)
-                {
-                    reg1 = allocateRegister();
-                    if (!reg1)
-                    {
-                        fprintf(stderr, "Error: No available registers for operand %s\n", current->arg1);
-                        exit(1);
-                    }
-                    setRegisterForVariable(current->arg1, reg1);
-                    loadOperand(current->arg1, reg1);
-                }
-                const char *reg2 = getRegisterForVariable(current->arg2);
-                if (!reg2)
-                {
-                    reg2 = allocateRegister();
-                    if (!reg2)
-                    {
-                        fprintf(stderr, "Error: No available registers for operand %s\n", current->arg2);
-                        exit(1);
-                    }
-                    setRegisterForVariable(current->arg2, reg2);
-                    loadOperand(current->arg2, reg2);
-                }
-                const char *resultReg = allocateRegister();
-                if (!resultReg)
-                {
-                    fprintf(stderr, "Error: No available registers for result %s\n", current->result);
-                    exit(1);
-                }
-                setRegisterForVariable(current->result, resultReg);
-                // Perform operation
-                if (strcmp(current->op, "+") == 0)
-                {
-                    fprintf(outputFile, "\tadd %s, %s, %s\n", resultReg, reg1, reg2);
-                }
-                else if (strcmp(current->op, "-") == 0)
-                {
-                    fprintf(outputFile, "\tsub %s, %s, %s\n", resultReg, reg1, reg2);
-                }
-                else if (strcmp(current->op, "*") == 0)
-                {
-                    fprintf(outputFile, "\tmul %s, %s, %s\n", resultReg, reg1, reg2);
-                }
-                else if (strcmp(current->op, "/") == 0)
-                {
-                    fprintf(outputFile, "\tdiv %s, %s\n", reg1, reg2);
-                    fprintf(outputFile, "\tmflo %s\n", resultReg);
-                }
-                // No need to store result to memory immediately
-            }
-            else if (strcmp(current->op, "=") == 0)
-            {
-                // Assignment operation
-                fprintf(outputFile, "# Generating MIPS code for assignment\n");
-                const char *srcReg = getRegisterForVariable(current->arg1);
-                if (!srcReg)
-                {
-                    srcReg = allocateRegister();
-                    if (!srcReg)
-                    {
-                        fprintf(stderr, "Error: No available registers for operand %s\n", current->arg1);
-                        exit(1);
-                    }
-                    setRegisterForVariable(current->arg1, srcReg);
-                    loadOperand(current->arg1, srcReg);
-                }
-                // Map result variable to a register
-                const char *destReg = getRegisterForVariable(current->result);
-                if (!destReg)
-                {
-                    destReg = allocateRegister();
-                    if (!destReg)
-                    {
-                        fprintf(stderr, "Error: No available registers for result %s\n", current->result);
-                        exit(1);
-                    }
-                    setRegisterForVariable(current->result, destReg);
-                }
-                fprintf(outputFile, "\tmove %s, %s\n", destReg, srcReg);
-                // No need to store to memory immediately
-            }
-            else if (strcmp(current->op, "write") == 0)
-            {
-                // Write operation
-                fprintf(outputFile, "# Generating MIPS code for write operation\n");
-                const char *srcReg = getRegisterForVariable(current->arg1);
-                if (!srcReg)
-                {
-                    // Load operand into $a0 directly if it's not in a register
-                    loadOperand(current->arg1, "$a0");
-                }
-                else
-                {
-                    // Move value to $a0
-                    fprintf(outputFile, "\tmove $a0, %s\n", srcReg);
-                }
-                fprintf(outputFile, "\tli $v0, 1\n"); // Syscall code for print_int
-                fprintf(outputFile, "\tsyscall\n");
-                // Print newline character
-                fprintf(outputFile, "\tli $a0, 10\n"); // ASCII code for newline
-                fprintf(outputFile, "\tli $v0, 11\n"); // Syscall code for print_char
-                fprintf(outputFile, "\tsyscall\n");
-            }
-            else if (strcmp(current->op, "write_float") == 0)
-            {
-                // Write operation for floating-point numbers
-                fprintf(outputFile, "# Generating MIPS code for write_float operation\n");
-                const char *srcReg = getRegisterForVariable(current->arg1);
-                if (!srcReg)
-                {
-                    // Load operand into $f12 directly if it's not in a register
-                    loadOperand(current->arg1, "$f12");
-                }
-                else
-                {
-                    // Move value to $f12 for floating-point printing
-                    fprintf(outputFile, "\tmov.s $f12, %s\n", srcReg);
-                }
-                fprintf(outputFile, "\tli $v0, 2\n"); // Syscall code for print_float
-                fprintf(outputFile, "\tsyscall\n");
+            last = target->lowerInstruction(current, symTab);
+        }
 
-                // Print newline character after the float
-                fprintf(outputFile, "\tli $a0, 10\n"); // ASCII code for newline
-                fprintf(outputFile, "\tli $v0, 11\n"); // Syscall code for print_char
-                fprintf(outputFile, "\tsyscall\n");
-            }
-            else if (strcmp(current->op, "[]=") == 0)
-            {
-                // Array assignment operation
-                fprintf(outputFile, "# Generating MIPS code for array assignment\n");
-                // Load base address of array into BASE_ADDRESS_REGISTER
-                fprintf(outputFile, "\tla %s, %s\n", BASE_ADDRESS_REGISTER, current->result);
-                // Compute offset if possible
-                char *offsetValue = computeOffset(current->arg1, 4);
-                if (offsetValue != NULL)
-                {
-                    // Ensure temporary variable is in the symbol table
-                    if (isTemporaryVariable(current->arg2))
-                    {
-                        if (!findSymbol(symTab, current->arg2))
-                        {
-                            insertSymbol(symTab, current->arg2, "int", false, NULL);
-                        }
-                    }
-                    // Load value
-                    const char *valueReg = getRegisterForVariable(current->arg2);
-                    if (!valueReg)
-                    {
-                        valueReg = allocateRegister();
-                        if (!valueReg)
-                        {
-                            fprintf(stderr, "Error: No available registers for value\n");
-                            exit(1);
-                        }
-                        setRegisterForVariable(current->arg2, valueReg);
-                        loadOperand(current->arg2, valueReg);
-                    }
-                    fprintf(outputFile, "\tsw %s, %s(%s)\n", valueReg, offsetValue, BASE_ADDRESS_REGISTER);
-                    free(offsetValue);
-                }
-                else
-                {
-                    // Index is variable, compute at runtime
-                    // Load index
-                    const char *indexReg = getRegisterForVariable(current->arg1);
-                    if (!indexReg)
-                    {
-                        indexReg = allocateRegister();
-                        if (!indexReg)
-                        {
-                            fprintf(stderr, "Error: No available registers for index\n");
-                            exit(1);
-                        }
-                        setRegisterForVariable(current->arg1, indexReg);
-                        loadOperand(current->arg1, indexReg);
-                    }
-                    // Load value
-                    const char *valueReg = getRegisterForVariable(current->arg2);
-                    if (!valueReg)
-                    {
-                        valueReg = allocateRegister();
-                        if (!valueReg)
-                        {
-                            fprintf(stderr, "Error: No available registers for value\n");
-                            exit(1);
-                        }
-                        setRegisterForVariable(current->arg2, valueReg);
-                        loadOperand(current->arg2, valueReg);
-                    }
-                    // Calculate offset: indexReg * 4
-                    const char *tempReg = ADDRESS_CALC_REGISTER;
-                    fprintf(outputFile, "\tmul %s, %s, 4\n", tempReg, indexReg);
-                    // Effective address: BASE_ADDRESS_REGISTER + tempReg
-                    fprintf(outputFile, "\tadd %s, %s, %s\n", tempReg, BASE_ADDRESS_REGISTER, tempReg);
-                    // Store value
-                    fprintf(outputFile, "\tsw %s, 0(%s)\n", valueReg, tempReg);
-                }
-            }
-            else if (strcmp(current->op, "=[]") == 0)
+        // Deallocate registers for variables no longer used
+        for (TAC *instr = current; instr != last->next; instr = instr->next)
+        {
+            const char *variablesToCheck[] = {instr->arg1, instr->arg2, instr->result};
+            for (int i = 0; i < 3; i++)
             {
-                // Array access operation
-                fprintf(outputFile, "# Generating MIPS code for array access\n");
-                // Load base address of array into BASE_ADDRESS_REGISTER
-                fprintf(outputFile, "\tla %s, %s\n", BASE_ADDRESS_REGISTER, current->arg1);
-                // Compute offset if possible
-                char *offsetValue = computeOffset(current->arg2, 4);
-                if (offsetValue != NULL)
+                const char *var = variablesToCheck[i];
+                if (var != NULL && isVariableInRegisterMap(var))
                 {
-                    // Ensure temporary variable is in the symbol table
-                    if (isTemporaryVariable(current->result))
-                    {
-                        if (!findSymbol(symTab, current->result))
-                        {
-                            insertSymbol(symTab, current->result, "int", false, NULL);
-                        }
-                    }
-                    // Load value into a register
-                    const char *resultReg = getRegisterForVariable(current->result);
-                    if (!resultReg)
+                    if (!isVariableUsedLater(instr, var))
                     {
-                        resultReg = allocateRegister();
-                        if (!resultReg)
+                        const char *regName = getRegisterForVariable(var);
+                        // Store the variable back to memory if it's a user-defined variable;
+                        // a dead temporary simply gives its register back
+                        if (!isTemporaryVariable(var))
                         {
-                            fprintf(stderr, "Error: No available registers for result %s\n", current->result);
-                            exit(1);
+                            storeVariable(var, regName);
                         }
-                        setRegisterForVariable(current->result, resultReg);
+                        releaseRegister(regName);
+                        removeVariableFromRegisterMap(var);
                     }
-                    fprintf(outputFile, "\tlw %s, %s(%s)\n", resultReg, offsetValue, BASE_ADDRESS_REGISTER);
-                    free(offsetValue);
-                }
-                else
-                {
-                    // Index is variable, compute at runtime
-                    // Load index
-                    const char *indexReg = getRegisterForVariable(current->arg2);
-                    if (!indexReg)
-                    {
-                        indexReg = allocateRegister();
-                        if (!indexReg)
-                        {
-                            fprintf(stderr, "Error: No available registers for index\n");
-                            exit(1);
-                        }
-                        setRegisterForVariable(current->arg2, indexReg);
-                        loadOperand(current->arg2, indexReg);
-                    }
-                    // Calculate offset: indexReg * 4
-                    const char *tempReg = ADDRESS_CALC_REGISTER;
-                    fprintf(outputFile, "\tmul %s, %s, 4\n", tempReg, indexReg);
-                    // Effective address: BASE_ADDRESS_REGISTER + tempReg
-                    fprintf(outputFile, "\tadd %s, %s, %s\n", tempReg, BASE_ADDRESS_REGISTER, tempReg);
-                    // Load value into a register
-                    const char *resultReg = getRegisterForVariable(current->result);
-                    if (!resultReg)
-                    {
-                        resultReg = allocateRegister();
-                        if (!resultReg)
-                        {
-                            fprintf(stderr, "Error: No available registers for result %s\n", current->result);
-                            exit(1);
-                        }
-                        setRegisterForVariable(current->result, resultReg);
-                    }
-                    fprintf(outputFile, "\tlw %s, 0(%s)\n", resultReg, tempReg);
                 }
             }
-            else
-            {
-                fprintf(stderr, "Warning: Unsupported TAC operation '%s'\n", current->op);
-            }
         }
 
-        // Deallocate registers for variables no longer used
-        const char *variablesToCheck[] = {current->arg1, current->arg2, current->result};
-        for (int i = 0; i < 3; i++)
+        current = last->next;
+    }
+    currentInstruction = NULL;
+
+    // Store all live registers back to memory
+    spillAllRegisters();
+    freeRegisterMap();
+
+    // Temporaries never outlive a run, so the next one can reuse their slots
+    resetSpillSlots();
+}
+
+void beginStreamingMIPS()
+{
+    generateMIPSTextPrologue();
+}
+
+void finishStreamingMIPS(SymbolTable *symTab)
+{
+    generateMIPSTextEpilogue();
+
+    // Static data goes after the code, once every initializer is known
+    fprintf(outputFile, ".data\n");
+    generateDataSection(symTab, NULL);
+    generateSpillArea();
+    freeSpillSlots();
+}
+
+// Emit the contents of an array with static initializers: runs of known
+// elements become .word/.float lists and unknown gaps become .space
+void generateArrayData(Array *array)
+{
+    int i = 0;
+    while (i < array->size)
+    {
+        if (getArrayValue(array, i) == NULL)
         {
-            const char *var = variablesToCheck[i];
-            if (var != NULL && isVariableInRegisterMap(var))
-            {
-                if (!isVariableUsedLater(current, var))
-                {
-                    const char *regName = getRegisterForVariable(var);
-                    // Store the variable back to memory if it's a user-defined variable or a temporary variable
-                    if (findSymbol(symTab, var) || isTemporaryVariable(var))
-                    {
-                        fprintf(outputFile, "# Storing variable %s back to memory\n", var);
-                        fprintf(outputFile, "\tsw %s, %s\n", regName, var);
-                    }
-                    deallocateRegister(regName);
-                    removeVariableFromRegisterMap(var);
-                }
-            }
+            int start = i;
+            while (i < array->size && getArrayValue(array, i) == NULL)
+                i++;
+            fprintf(outputFile, "\t.space %d\n", (i - start) * 4);
+            continue;
         }
 
-        current = current->next;
+        fprintf(outputFile, "\t%s ", array->isFloat ? ".float" : target->wordDirective);
+        for (int count = 0; i < array->size && count < 16; count++, i++)
+        {
+            const ArrayValue *value = getArrayValue(array, i);
+            if (value == NULL)
+                break;
+            if (count > 0)
+                fprintf(outputFile, ", ");
+            if (array->isFloat)
+                fprintf(outputFile, "%f", value->floatValue);
+            else
+                fprintf(outputFile, "%d", value->intValue);
+        }
+        fprintf(outputFile, "\n");
     }
+}
 
-    // Before exiting, store all live registers back to memory
+void finalizeCodeGenerator(const char *outputFilename)
+{
+    if (outputFile)
+    {
+        if (ownsOutputFile)
+            fclose(outputFile);
+        else
+            fflush(outputFile);
+        printf("MIPS code generated and saved to file %s\n", outputFilename);
+        outputFile = NULL;
+    }
+}
+
+void resetCodeGenerator()
+{
+    if (outputFile && ownsOutputFile)
+        fclose(outputFile);
+    outputFile = NULL;
+    freeRegisterMap();
+    for (int i = 0; i < NUM_AVAILABLE_REGISTERS; i++)
+        registerInUse[i] = false;
+    for (int i = 0; i < NUM_AVAILABLE_FLOAT_REGISTERS; i++)
+        floatRegisterInUse[i] = false;
+    currentInstruction = NULL;
+    freeSpillSlots();
+}
+
+/* Register Allocation Functions */
+
+// Store every variable held in a register back to memory and empty the register map
+void spillAllRegisters()
+{
     for (int i = 0; i < MAX_REGISTER_MAP_SIZE; i++)
     {
         if (registerMap[i].variable != NULL)
         {
             const char *var = registerMap[i].variable;
             const char *regName = registerMap[i].regName;
-            if (findSymbol(symTab, var) || isTemporaryVariable(var))
+            // A temporary only needs a memory copy if something still reads it
+            if (!isTemporaryVariable(var) ||
+                (currentInstruction != NULL && isVariableUsedLater(currentInstruction, var)))
             {
-                fprintf(outputFile, "# Storing variable %s back to memory\n", var);
-                fprintf(outputFile, "\tsw %s, %s\n", regName, var);
+                storeVariable(var, regName);
             }
-            deallocateRegister(regName);
+            releaseRegister(regName);
             free(registerMap[i].variable);
             free(registerMap[i].regName);
             registerMap[i].variable = NULL;
             registerMap[i].regName = NULL;
         }
     }
-    freeRegisterMap();
-
-    // Exit program
-    fprintf(outputFile, "\tli $v0, 10\n");
-    fprintf(outputFile, "\tsyscall\n");
-
-    // Free the variable list
-    freeVariableList(varList);
 }
 
-void finalizeCodeGenerator(const char *outputFilename)
-{
-    if (outputFile)
-    {
-        fclose(outputFile);
-        printf("MIPS code generated and saved to file %s\n", outputFilename);
-        outputFile = NULL;
-    }
-}
-
-/* Register Allocation Functions */
-
 // Allocate a register
 const char *allocateRegister()
 {
@@ -500,12 +748,12 @@ const char *allocateRegister()
         }
     }
 
-    // Implement spilling logic here
-    const char *spillRegister = availableRegisters[0]; // Example: spill the first register
-    fprintf(outputFile, "# Spilling register %s to memory\n", spillRegister);
-    // Store spilled register's value in memory (e.g., on the stack)
-    fprintf(outputFile, "\tsw %s, spill_area\n", spillRegister);
-
+    // Every register is taken: move a value the current instruction does not use to memory
+    const char *spillRegister = evictRegister(availableRegisters, NUM_AVAILABLE_REGISTERS);
+    if (!spillRegister)
+    {
+        fprintf(stderr, "Error: No available registers\n");
+    }
     return spillRegister;
 }
 
@@ -531,11 +779,22 @@ void setRegisterForVariable(const char *variable, const char *regName)
         {
             registerMap[i].variable = strdup(variable);
             registerMap[i].regName = strdup(regName);
+            registerMap[i].holdsFloat = false;
             break;
         }
     }
 }
 
+// Record whether the integer register bound to variable holds float bits
+void setFloatBitsForVariable(const char *variable, bool holdsFloat)
+{
+    for (int i = 0; i < MAX_REGISTER_MAP_SIZE; i++)
+    {
+        if (registerMap[i].variable != NULL && strcmp(registerMap[i].variable, variable) == 0)
+            registerMap[i].holdsFloat = holdsFloat;
+    }
+}
+
 // Get register assigned to a variable
 const char *getRegisterForVariable(const char *variable)
 {
@@ -573,6 +832,24 @@ void removeVariableFromRegisterMap(const char *variable)
 
 /* Other Helper Functions */
 
+// Map a TAC comparison operator to its MIPS set instruction (NULL if not a comparison)
+const char *getComparisonInstruction(const char *op)
+{
+    if (strcmp(op, "<") == 0)
+        return "slt";
+    if (strcmp(op, "<=") == 0)
+        return "sle";
+    if (strcmp(op, ">") == 0)
+        return "sgt";
+    if (strcmp(op, ">=") == 0)
+        return "sge";
+    if (strcmp(op, "==") == 0)
+        return "seq";
+    if (strcmp(op, "!=") == 0)
+        return "sne";
+    return NULL;
+}
+
 // Function to compute offset for array access if index is a constant
 char *computeOffset(const char *indexOperand, int elementSize)
 {
@@ -682,16 +959,15 @@ void loadOperand(const char *operand, const char *registerName)
 {
     if (isConstant(operand))
     {
-        // If the register is for floats, handle the constant as a float.
-        if (registerName[0] == '$' && registerName[1] == 'f')
+        if (isFloatRegister(registerName))
         {
-            // Declare the constant in the .data section and load it into a floating-point register.
-            fprintf(outputFile, "\tl.s %s, %s\n", registerName, operand); // Assume operand is stored in memory
+            // Integer constant wanted as a float
+            target->loadFloatImmediate(registerName, operand);
         }
         else
         {
             // Load integer constant
-            fprintf(outputFile, "\tli %s, %s\n", registerName, operand);
+            target->loadImmediate(registerName, operand);
         }
     }
     else if (isVariableInRegisterMap(operand))
@@ -700,48 +976,57 @@ void loadOperand(const char *operand, const char *registerName)
         const char *reg = getRegisterForVariable(operand);
         if (strcmp(registerName, reg) != 0)
         {
-            // Check if it's a floating-point register
-            if (registerName[0] == '$' && registerName[1] == 'f')
-            {
-                fprintf(outputFile, "\tmov.s %s, %s\n", registerName, reg);
-            }
-            else
-            {
-                fprintf(outputFile, "\tmove %s, %s\n", registerName, reg);
-            }
+            target->moveRegister(registerName, reg);
         }
     }
-    else
+    else if (isTemporaryVariable(operand))
     {
-        // Load from memory
-        if (registerName[0] == '$' && registerName[1] == 'f')
-        {
-            // Load float from memory
-            fprintf(outputFile, "\tl.s %s, %s\n", registerName, operand);
-        }
-        else
+        // Temporary that was spilled out of the register file
+        SpillSlot *slot = getSpillSlot(operand);
+        if (slot->offset < 0)
         {
-            // Load integer from memory
-            fprintf(outputFile, "\tlw %s, %s\n", registerName, operand);
+            fprintf(stderr, "Error: Temporary %s used before it is defined\n", operand);
+            abortCompilation();
         }
+        target->loadSpill(registerName, slot->offset);
+    }
+    else
+    {
+        // Load from the variable's home in .data
+        target->loadHome(registerName, operand);
     }
 }
 
-bool isTemporaryVariable(const char *operand)
+void moveRegister(const char *destReg, const char *srcReg)
 {
-    if (operand == NULL)
-        return false;
-    // Check if operand starts with 't' followed by digits
-    if (operand[0] != 't')
-        return false;
-    for (int i = 1; operand[i] != '\0'; i++)
+    target->moveRegister(destReg, srcReg);
+}
+
+// Register that holds an operand, loading it into a fresh one if needed
+const char *getOperandRegister(const char *operand)
+{
+    const char *reg = getRegisterForVariable(operand);
+    if (!reg)
     {
-        if (!isdigit(operand[i]))
+        reg = allocateRegister();
+        if (!reg)
         {
-            return false;
+            fprintf(stderr, "Error: No available registers for operand %s\n", operand);
+            abortCompilation();
         }
+        loadOperand(operand, reg);
+        setRegisterForVariable(operand, reg);
+        // A temporary reloaded from its spill slot keeps its float bits
+        if (isTemporaryVariable(operand))
+            setFloatBitsForVariable(operand, getSpillSlot(operand)->isFloat);
     }
-    return true;
+    return reg;
+}
+
+bool isTemporaryVariable(const char *operand)
+{
+    // Temporaries are virtual registers with no home in .data
+    return isVirtualRegister(operand);
 }
 
 // Function to check if a variable is used later
@@ -772,8 +1057,13 @@ const char *allocateFloatRegister()
             return availableFloatRegisters[i]; // Return the register name
         }
     }
-    fprintf(stderr, "Error: No available floating-point registers\n");
-    return NULL;
+    // Every register is taken: move a value the current instruction does not use to memory
+    const char *spillRegister = evictRegister(availableFloatRegisters, NUM_AVAILABLE_FLOAT_REGISTERS);
+    if (!spillRegister)
+    {
+        fprintf(stderr, "Error: No available floating-point registers\n");
+    }
+    return spillRegister;
 }
 
 // Deallocate a floating-point register
@@ -787,4 +1077,12 @@ void deallocateFloatRegister(const char *regName)
             break;
         }
     }
-}
\ No newline at end of file
+}
+// Release an integer or floating-point register
+void releaseRegister(const char *regName)
+{
+    if (isFloatRegister(regName))
+        deallocateFloatRegister(regName);
+    else
+        deallocateRegister(regName);
+}
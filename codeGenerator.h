@@ -8,6 +8,7 @@
 #include "Array.h"
 #include "SymbolTable.h"
 #include "optimizer.h"
+#include <stdio.h>
 #include <stdbool.h>
 #include <ctype.h>
 
@@ -31,19 +32,90 @@ typedef struct VarNode
 // Structure for register mapping
 typedef struct
 {
-    char *variable; // Variable name
-    char *regName;  // Register name
+    char *variable;  // Variable name
+    char *regName;   // Register name
+    bool holdsFloat; // Integer register holding the bits of a float
 } RegisterMapEntry;
 
+// Memory home of a virtual register that had to leave the register file
+typedef struct
+{
+    int offset;   // Byte offset into spill_area, -1 until first spilled
+    bool isFloat; // Value was spilled from a floating-point register
+} SpillSlot;
+
+// A backend: how to lower TAC and how to emit the loads, stores and moves
+// the shared register allocator needs. Registers are always named by their
+// MIPS names ($t0, $f2, ...); other targets give each a fixed counterpart.
+typedef struct
+{
+    const char *name;          // Name used on the command line
+    const char *wordDirective; // Data directive for a 32-bit integer
+    void (*textPrologue)();
+    void (*textEpilogue)();
+    // Lowers instr, or a window starting at it; returns the last instruction translated
+    TAC *(*lowerInstruction)(TAC *instr, SymbolTable *symTab);
+    void (*storeHome)(const char *regName, const char *var);
+    void (*storeSpill)(const char *regName, int offset);
+    void (*loadHome)(const char *regName, const char *var);
+    void (*loadSpill)(const char *regName, int offset);
+    void (*loadImmediate)(const char *regName, const char *constant);
+    void (*loadFloatImmediate)(const char *regName, const char *constant); // Integer or float literal
+    void (*moveRegister)(const char *destReg, const char *srcReg);
+    void (*convertIntToFloat)(const char *intReg, const char *floatReg);
+} CodeGenTarget;
+
+extern const CodeGenTarget mipsTarget;
+
+// Select the backend used from now on (MIPS by default)
+void setCodeGenTarget(const CodeGenTarget *codeGenTarget);
+
 // Initializes code generation, setting up any necessary structures
 void initCodeGenerator(const char *outputFilename);
 
-// Generates MIPS assembly code from the provided TAC
-void generateMIPS(TAC *tacInstructions, SymbolTable *symTab);
+// Initializes code generation into an already open stream; the caller
+// keeps it and closes it after finalizeCodeGenerator
+void initCodeGeneratorOutput(FILE *out);
+
+// Output file of the code generator, for backends in other files
+FILE *codeGeneratorOutput();
+
+// Generates assembly for the current target from the provided TAC
+void generateCode(TAC *tacInstructions, SymbolTable *symTab);
+
+// Generates code for a run of TAC, leaving every value in memory at the end
+void generateInstructions(TAC *tacInstructions, SymbolTable *symTab);
+
+// Get a floating-point register holding the operand, converting integers;
+// values not already in a float register are loaded into scratch
+const char *getFloatOperand(const char *operand, const char *scratch, SymbolTable *symTab);
+
+// Register that holds an operand, loading it into a fresh one if needed
+const char *getOperandRegister(const char *operand);
+
+// Whether an operand holds an integer in a register, a spill slot or .data
+bool isIntegerOperand(const char *operand, SymbolTable *symTab);
+bool isFloatOperand(const char *operand, SymbolTable *symTab);
+
+// Keep the operands of every instruction from the current one through last
+// in their registers while a window of instructions is translated
+void protectWindowOperands(TAC *last);
+
+// Streaming code generation: .text is written one window of TAC at a time
+// through generateInstructions and .data is written once at the end
+void beginStreamingMIPS();
+void finishStreamingMIPS(SymbolTable *symTab);
+
+// Emits the .data contents of an array with statically known elements
+void generateArrayData(Array *array);
 
 // Finalizes code generation, closing files and cleaning up
 void finalizeCodeGenerator(const char *outputFilename);
 
+// Abandon any code generation in progress and return the generator to its
+// initial state, e.g. after a compile error
+void resetCodeGenerator();
+
 // Function declarations for register allocation
 const char *allocateRegister();
 void deallocateRegister(const char *regName);
@@ -53,14 +125,20 @@ void setRegisterForVariable(const char *variable, const char *regName);
 const char *getRegisterForVariable(const char *variable);
 bool isVariableInRegisterMap(const char *variable);
 void removeVariableFromRegisterMap(const char *variable);
+void setFloatBitsForVariable(const char *variable, bool holdsFloat);
+void spillAllRegisters();
 
 // Print the current TAC instruction
 void printCurrentTAC(TAC *tac);
 
 VarNode *findVariable(VarNode *varList, const char *varName);
+bool isVariableInList(VarNode *varList, const char *varName);
 
 void loadOperand(const char *operand, const char *registerName);
 
+// Copy a register through the target's move, across register banks if needed
+void moveRegister(const char *destReg, const char *srcReg);
+
 void freeVariableList(VarNode *varList);
 
 void collectVariables(TAC *tacInstructions, VarNode **varList);
@@ -74,7 +152,11 @@ bool isVariableUsedLater(TAC *current, const char *variable);
 const char *allocateFloatRegister();
 void deallocateFloatRegister(const char *regName);
 
+// Release an integer or floating-point register
+void releaseRegister(const char *regName);
+
 // helper function
 char *computeOffset(const char *indexOperand, int elementSize);
+const char *getComparisonInstruction(const char *op);
 
 #endif // CODE_GENERATOR_H
@@ -0,0 +1,38 @@
+// compile.h
+
+#ifndef COMPILE_H
+#define COMPILE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "source.h"
+#include "SymbolTable.h"
+#include "codeGenerator.h"
+
+// How one compilation runs
+typedef struct
+{
+    bool interpret;              // Run the optimized TAC instead of generating code
+    bool dumpIR;                 // Write TACsem.ir, TACopt.ir and TACgen.ir
+    const CodeGenTarget *target; // Backend for the generated code
+    const char *outputFile;      // Output path, opened unless output is set
+    FILE *output;                // Open stream to write the code to instead
+    bool emitBinaryIR;           // Write TACsem.tacb and TACopt.tacb
+    const char *passPipeline;    // Optimizer pipeline (see passManager.h), NULL for -O2
+    bool passStats;              // Report per-pass statistics on stderr
+} CompileOptions;
+
+// Compile a source buffer using an empty symbol table (implemented in
+// parser.y). Returns 0 on success; errors end in abortCompilation.
+int compileSource(SourceBuffer *source, SymbolTable *symTab, const CompileOptions *options);
+
+// Compile saved IR (binary IR or a text dump, see irfile.h) in place of
+// a source file, reporting the time each stage took on stderr. Returns 0
+// on success.
+int compileIRFile(const char *path, SymbolTable *symTab, const CompileOptions *options);
+
+// Free everything the last compilation built, keeping the AST pool and
+// the symbol table allocated for the next one
+void resetCompileState(SymbolTable *symTab);
+
+#endif // COMPILE_H
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "intern.h"
+
+// Strings are packed into large chunks so interning a new name is usually
+// a bump of a pointer rather than a malloc
+#define INTERN_CHUNK_SIZE 65536
+#define INTERN_INITIAL_CAPACITY 1024
+
+typedef struct InternChunk
+{
+    struct InternChunk *next;
+    size_t used;
+    size_t size;
+    char data[];
+} InternChunk;
+
+typedef struct
+{
+    char *str;
+    size_t length;
+    uint32_t hash;
+} InternEntry;
+
+static InternChunk *chunks = NULL;
+static InternEntry *entries = NULL;
+static int capacity = 0;
+static int count = 0;
+
+// FNV-1a hash of the string bytes
+static uint32_t hashString(const char *str, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static char *storeString(const char *str, size_t length)
+{
+    if (chunks == NULL || chunks->used + length + 1 > chunks->size)
+    {
+        size_t size = length + 1 > INTERN_CHUNK_SIZE ? length + 1 : INTERN_CHUNK_SIZE;
+        InternChunk *chunk = (InternChunk *)malloc(sizeof(InternChunk) + size);
+        if (chunk == NULL)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for interned strings\n");
+            exit(1);
+        }
+        chunk->next = chunks;
+        chunk->used = 0;
+        chunk->size = size;
+        chunks = chunk;
+    }
+
+    char *copy = chunks->data + chunks->used;
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    chunks->used += length + 1;
+    return copy;
+}
+
+static void growTable()
+{
+    int newCapacity = capacity ? capacity * 2 : INTERN_INITIAL_CAPACITY;
+    InternEntry *newEntries = (InternEntry *)calloc(newCapacity, sizeof(InternEntry));
+    if (newEntries == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for intern table\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < capacity; i++)
+    {
+        if (entries[i].str == NULL)
+            continue;
+        int j = entries[i].hash & (newCapacity - 1);
+        while (newEntries[j].str != NULL)
+            j = (j + 1) & (newCapacity - 1);
+        newEntries[j] = entries[i];
+    }
+
+    free(entries);
+    entries = newEntries;
+    capacity = newCapacity;
+}
+
+char *internString(const char *str, size_t length)
+{
+    // Keep the table at most half full
+    if ((count + 1) * 2 > capacity)
+        growTable();
+
+    uint32_t hash = hashString(str, length);
+    int i = hash & (capacity - 1);
+    while (entries[i].str != NULL)
+    {
+        if (entries[i].hash == hash && entries[i].length == length &&
+            memcmp(entries[i].str, str, length) == 0)
+        {
+            return entries[i].str;
+        }
+        i = (i + 1) & (capacity - 1);
+    }
+
+    entries[i].str = storeString(str, length);
+    entries[i].length = length;
+    entries[i].hash = hash;
+    count++;
+    return entries[i].str;
+}
+
+char *intern(const char *str)
+{
+    return internString(str, strlen(str));
+}
+
+int getInternCount()
+{
+    return count;
+}
+
+void freeInternTable()
+{
+    while (chunks != NULL)
+    {
+        InternChunk *next = chunks->next;
+        free(chunks);
+        chunks = next;
+    }
+    free(entries);
+    entries = NULL;
+    capacity = 0;
+    count = 0;
+}
@@ -0,0 +1,20 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+
+// Return the canonical copy of a string: equal strings always get the same
+// pointer, so names can be compared by address. Interned strings live until
+// freeInternTable and must not be modified or freed by callers.
+char *internString(const char *str, size_t length);
+
+// Intern a NUL-terminated string
+char *intern(const char *str);
+
+// Number of distinct strings interned so far
+int getInternCount();
+
+// Release every interned string
+void freeInternTable();
+
+#endif // INTERN_H
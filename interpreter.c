@@ -0,0 +1,622 @@
+// interpreter.c
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "interpreter.h"
+#include "utils.h"
+
+// GCC and Clang dispatch through a table of label addresses (threaded
+// code); other compilers fall back to a switch
+#if defined(__GNUC__)
+#define INTERPRETER_THREADED
+#endif
+
+typedef enum
+{
+    Op_Add, Op_Sub, Op_Mul, Op_Div,
+    Op_Lt, Op_Le, Op_Gt, Op_Ge, Op_Eq, Op_Ne,
+    Op_FloatLt, Op_FloatLe, Op_FloatGt, Op_FloatGe, Op_FloatEq, Op_FloatNe,
+    Op_FloatAdd, Op_FloatSub, Op_FloatMul, Op_FloatDiv,
+    Op_Move, Op_FloatMove, Op_ArrayLoad, Op_ArrayStore,
+    Op_Goto, Op_IfFalse, Op_Write, Op_WriteFloat, Op_Halt,
+    OPCODE_COUNT
+} Opcode;
+
+// Operand a or b is an integer that a float instruction must convert
+#define CONVERT_A 1
+#define CONVERT_B 2
+
+// One pre-decoded instruction. Operands are indices into the value slots,
+// except that array instructions carry the array's symbol id and jumps
+// carry the index of their target instruction in r.
+typedef struct
+{
+#ifdef INTERPRETER_THREADED
+    const void *handler; // Address of the handler, filled in before a run
+#endif
+    uint8_t opcode;
+    uint8_t flags;
+    int32_t a, b, r;
+} DecodedTAC;
+
+typedef union
+{
+    int32_t i;
+    float f;
+} Value;
+
+typedef struct
+{
+    int32_t base; // First element in the array memory, -1 if not an array
+    int32_t size;
+    bool isFloat;
+} ArrayLayout;
+
+// Open-addressing map from label name to the instruction it marks
+typedef struct
+{
+    const char *label;
+    int target;
+} LabelSlot;
+
+typedef struct
+{
+    SymbolTable *symTab;
+    DecodedTAC *code;
+    int count;
+    Value *slots;      // Variables by symbol id, then temporaries, then constants
+    bool *slotIsFloat;
+    int tempBase;
+    int constantNext;
+    ArrayLayout *arrays; // By symbol id
+    Value *memory;
+    LabelSlot *labels;
+    int labelCapacity;
+} Program;
+
+static int findLabelSlot(Program *program, const char *label)
+{
+    unsigned int i = hashFunction(label, program->labelCapacity);
+    while (program->labels[i].label != NULL && strcmp(program->labels[i].label, label) != 0)
+        i = (i + 1) % program->labelCapacity;
+    return i;
+}
+
+// Slot of a constant, variable or temporary operand; -1 if it names nothing
+static int32_t decodeOperand(Program *program, const char *operand)
+{
+    if (operand == NULL)
+        return -1;
+
+    if (isConstant(operand) || isFloatConstant(operand))
+    {
+        int slot = program->constantNext++;
+        program->slotIsFloat[slot] = !isConstant(operand);
+        if (program->slotIsFloat[slot])
+            program->slots[slot].f = (float)atof(operand);
+        else
+            program->slots[slot].i = atoi(operand);
+        return slot;
+    }
+    if (isVirtualRegister(operand))
+        return program->tempBase + virtualRegisterNumber(operand);
+
+    Symbol *symbol = findSymbol(program->symTab, operand);
+    if (symbol == NULL || symbol->isArray)
+    {
+        fprintf(stderr, "Error: Unknown scalar '%s' in TAC\n", operand);
+        return -1;
+    }
+    return symbol->id;
+}
+
+static int32_t decodeArray(Program *program, const char *name)
+{
+    Symbol *symbol = name != NULL ? findSymbol(program->symTab, name) : NULL;
+    if (symbol == NULL || !symbol->isArray)
+    {
+        fprintf(stderr, "Error: Unknown array '%s' in TAC\n", name != NULL ? name : "(null)");
+        return -1;
+    }
+    return symbol->id;
+}
+
+static bool decodeInstruction(Program *program, TAC *instr, DecodedTAC *decoded)
+{
+    static const struct
+    {
+        const char *op;
+        Opcode intOpcode;
+        Opcode floatOpcode; // Used when either operand is a float
+    } binaryOps[] = {
+        {"+", Op_Add, Op_FloatAdd}, {"-", Op_Sub, Op_FloatSub},
+        {"*", Op_Mul, Op_FloatMul}, {"/", Op_Div, Op_FloatDiv},
+        {"fadd", Op_FloatAdd, Op_FloatAdd}, {"fsub", Op_FloatSub, Op_FloatSub},
+        {"fmul", Op_FloatMul, Op_FloatMul}, {"fdiv", Op_FloatDiv, Op_FloatDiv},
+        {"<", Op_Lt, Op_FloatLt}, {"<=", Op_Le, Op_FloatLe},
+        {">", Op_Gt, Op_FloatGt}, {">=", Op_Ge, Op_FloatGe},
+        {"==", Op_Eq, Op_FloatEq}, {"!=", Op_Ne, Op_FloatNe},
+    };
+
+    memset(decoded, 0, sizeof(DecodedTAC));
+    decoded->a = decoded->b = decoded->r = -1;
+    const char *op = instr->op;
+
+    for (size_t i = 0; i < sizeof(binaryOps) / sizeof(binaryOps[0]); i++)
+    {
+        if (strcmp(op, binaryOps[i].op) != 0)
+            continue;
+
+        decoded->a = decodeOperand(program, instr->arg1);
+        decoded->b = decodeOperand(program, instr->arg2);
+        decoded->r = decodeOperand(program, instr->result);
+        if (decoded->a < 0 || decoded->b < 0 || decoded->r < 0)
+            return false;
+
+        bool floatA = program->slotIsFloat[decoded->a];
+        bool floatB = program->slotIsFloat[decoded->b];
+        decoded->opcode = floatA || floatB ? binaryOps[i].floatOpcode : binaryOps[i].intOpcode;
+        if (!floatA)
+            decoded->flags |= CONVERT_A;
+        if (!floatB)
+            decoded->flags |= CONVERT_B;
+
+        // Arithmetic on floats gives a float; comparisons give 0 or 1
+        bool floatResult = decoded->opcode >= Op_FloatAdd && decoded->opcode <= Op_FloatDiv;
+        if (isVirtualRegister(instr->result))
+            program->slotIsFloat[decoded->r] = floatResult;
+        return true;
+    }
+
+    if (strcmp(op, "=") == 0 || strcmp(op, "fmov") == 0)
+    {
+        decoded->a = decodeOperand(program, instr->arg1);
+        decoded->r = decodeOperand(program, instr->result);
+        if (decoded->a < 0 || decoded->r < 0)
+            return false;
+
+        // fmov converts an integer source; = copies the value as it is
+        bool floatSource = program->slotIsFloat[decoded->a];
+        decoded->opcode = op[0] == 'f' ? Op_FloatMove : Op_Move;
+        if (!floatSource)
+            decoded->flags |= CONVERT_A;
+        if (isVirtualRegister(instr->result))
+            program->slotIsFloat[decoded->r] = op[0] == 'f' || floatSource;
+        return true;
+    }
+    if (strcmp(op, "=[]") == 0)
+    {
+        decoded->opcode = Op_ArrayLoad;
+        decoded->b = decodeArray(program, instr->arg1);
+        decoded->a = decodeOperand(program, instr->arg2);
+        decoded->r = decodeOperand(program, instr->result);
+        if (decoded->a < 0 || decoded->b < 0 || decoded->r < 0)
+            return false;
+        if (isVirtualRegister(instr->result))
+            program->slotIsFloat[decoded->r] = program->arrays[decoded->b].isFloat;
+        return true;
+    }
+    if (strcmp(op, "[]=") == 0)
+    {
+        decoded->opcode = Op_ArrayStore;
+        decoded->a = decodeOperand(program, instr->arg1);
+        decoded->b = decodeOperand(program, instr->arg2);
+        decoded->r = decodeArray(program, instr->result);
+        if (decoded->a < 0 || decoded->b < 0 || decoded->r < 0)
+            return false;
+        // An integer stored into a float array is converted
+        if (program->arrays[decoded->r].isFloat && !program->slotIsFloat[decoded->b])
+            decoded->flags |= CONVERT_B;
+        return true;
+    }
+    if (strcmp(op, "goto") == 0 || strcmp(op, "ifFalse") == 0)
+    {
+        decoded->opcode = op[0] == 'g' ? Op_Goto : Op_IfFalse;
+        if (decoded->opcode == Op_IfFalse && (decoded->a = decodeOperand(program, instr->arg1)) < 0)
+            return false;
+
+        int slot = findLabelSlot(program, instr->result);
+        if (program->labels[slot].label == NULL)
+        {
+            fprintf(stderr, "Error: Branch to undefined label %s\n", instr->result);
+            return false;
+        }
+        decoded->r = program->labels[slot].target;
+        return true;
+    }
+    if (strcmp(op, "write") == 0 || strcmp(op, "write_float") == 0)
+    {
+        decoded->a = decodeOperand(program, instr->arg1);
+        if (decoded->a < 0)
+            return false;
+        decoded->opcode = op[5] == '_' ? Op_WriteFloat : Op_Write;
+        if (!program->slotIsFloat[decoded->a])
+            decoded->flags |= CONVERT_A;
+        return true;
+    }
+
+    fprintf(stderr, "Error: Unsupported TAC operation '%s'\n", op);
+    return false;
+}
+
+static void freeProgram(Program *program)
+{
+    free(program->code);
+    free(program->slots);
+    free(program->slotIsFloat);
+    free(program->arrays);
+    free(program->memory);
+    free(program->labels);
+}
+
+// Lay out the storage and translate the list into a DecodedTAC array
+static bool loadProgram(Program *program, TAC *head, SymbolTable *symTab)
+{
+    memset(program, 0, sizeof(Program));
+    program->symTab = symTab;
+
+    // Size everything up front: instructions, labels, temporaries, constants
+    int labelCount = 0;
+    int maxTemp = -1;
+    int constants = 0;
+    for (TAC *instr = head; instr != NULL; instr = instr->next)
+    {
+        if (isLabel(instr))
+        {
+            labelCount++;
+            continue;
+        }
+        program->count++;
+        const char *operands[] = {instr->arg1, instr->arg2, instr->result};
+        for (int i = 0; i < 3; i++)
+        {
+            if (isConstant(operands[i]) || isFloatConstant(operands[i]))
+                constants++;
+            else if (virtualRegisterNumber(operands[i]) > maxTemp)
+                maxTemp = virtualRegisterNumber(operands[i]);
+        }
+    }
+
+    program->tempBase = symTab->count + 1;
+    program->constantNext = program->tempBase + maxTemp + 1;
+    int slotCount = program->constantNext + constants;
+    program->slots = (Value *)calloc(slotCount, sizeof(Value));
+    program->slotIsFloat = (bool *)calloc(slotCount, sizeof(bool));
+    program->arrays = (ArrayLayout *)calloc(symTab->count + 1, sizeof(ArrayLayout));
+    program->code = (DecodedTAC *)malloc(sizeof(DecodedTAC) * (program->count + 1));
+
+    // Variables and arrays start out as the .data section would have them
+    int memorySize = 0;
+    for (int id = 1; id <= symTab->count; id++)
+    {
+        Symbol *symbol = getSymbolById(symTab, id);
+        if (symbol->isArray)
+        {
+            program->arrays[id].base = memorySize;
+            program->arrays[id].size = symbol->arrayInfo->size;
+            program->arrays[id].isFloat = symbol->arrayInfo->isFloat;
+            memorySize += symbol->arrayInfo->size;
+            continue;
+        }
+        program->arrays[id].base = -1;
+        program->slotIsFloat[id] = symbol->type == DataType_Float;
+        if (symbol->value == NULL)
+            continue;
+        if (program->slotIsFloat[id])
+            program->slots[id].f = (float)atof(symbol->value);
+        else
+            program->slots[id].i = atoi(symbol->value);
+    }
+    program->memory = (Value *)calloc(memorySize > 0 ? memorySize : 1, sizeof(Value));
+    for (int id = 1; id <= symTab->count; id++)
+    {
+        Symbol *symbol = getSymbolById(symTab, id);
+        if (!symbol->isArray || symbol->arrayInfo->knownCount == 0)
+            continue;
+        for (int i = 0; i < symbol->arrayInfo->size; i++)
+        {
+            const ArrayValue *value = getArrayValue(symbol->arrayInfo, i);
+            if (value != NULL)
+                memcpy(&program->memory[program->arrays[id].base + i], value, sizeof(Value));
+        }
+    }
+
+    // A label marks the instruction that follows it
+    program->labelCapacity = labelCount * 2 + 1;
+    program->labels = (LabelSlot *)calloc(program->labelCapacity, sizeof(LabelSlot));
+    int index = 0;
+    for (TAC *instr = head; instr != NULL; instr = instr->next)
+    {
+        if (isLabel(instr))
+        {
+            int slot = findLabelSlot(program, instr->result);
+            program->labels[slot].label = instr->result;
+            program->labels[slot].target = index;
+        }
+        else
+        {
+            index++;
+        }
+    }
+
+    index = 0;
+    for (TAC *instr = head; instr != NULL; instr = instr->next)
+    {
+        if (isLabel(instr))
+            continue;
+        if (!decodeInstruction(program, instr, &program->code[index++]))
+        {
+            freeProgram(program);
+            return false;
+        }
+    }
+    memset(&program->code[index], 0, sizeof(DecodedTAC));
+    program->code[index].opcode = Op_Halt;
+    return true;
+}
+
+bool interpretTAC(TAC *head, SymbolTable *symTab, FILE *out, long long maxSteps, InterpreterStats *stats)
+{
+    Program program;
+    memset(stats, 0, sizeof(InterpreterStats));
+    if (!loadProgram(&program, head, symTab))
+        return false;
+    stats->instructions = program.count;
+
+    Value *slots = program.slots;
+    Value *memory = program.memory;
+    const ArrayLayout *arrays = program.arrays;
+    const DecodedTAC *code = program.code;
+    const DecodedTAC *ip = code;
+    long long executed = 0;
+    bool ok = true;
+
+// Operand access; float instructions convert integer operands on the fly
+#define I(x) (slots[ip->x].i)
+#define FA ((ip->flags & CONVERT_A) ? (float)slots[ip->a].i : slots[ip->a].f)
+#define FB ((ip->flags & CONVERT_B) ? (float)slots[ip->b].i : slots[ip->b].f)
+
+// Backward jumps are the only way to loop, so the step limit is checked there
+#define JUMP()                          \
+    do                                  \
+    {                                   \
+        if (executed > maxSteps)        \
+            goto stepLimit;             \
+        ip = code + ip->r;              \
+        DISPATCH();                     \
+    } while (0)
+
+#ifdef INTERPRETER_THREADED
+    static const void *handlers[OPCODE_COUNT] = {
+        [Op_Add] = &&L_Op_Add, [Op_Sub] = &&L_Op_Sub, [Op_Mul] = &&L_Op_Mul, [Op_Div] = &&L_Op_Div,
+        [Op_Lt] = &&L_Op_Lt, [Op_Le] = &&L_Op_Le, [Op_Gt] = &&L_Op_Gt, [Op_Ge] = &&L_Op_Ge,
+        [Op_Eq] = &&L_Op_Eq, [Op_Ne] = &&L_Op_Ne,
+        [Op_FloatLt] = &&L_Op_FloatLt, [Op_FloatLe] = &&L_Op_FloatLe, [Op_FloatGt] = &&L_Op_FloatGt,
+        [Op_FloatGe] = &&L_Op_FloatGe, [Op_FloatEq] = &&L_Op_FloatEq, [Op_FloatNe] = &&L_Op_FloatNe,
+        [Op_FloatAdd] = &&L_Op_FloatAdd, [Op_FloatSub] = &&L_Op_FloatSub,
+        [Op_FloatMul] = &&L_Op_FloatMul, [Op_FloatDiv] = &&L_Op_FloatDiv,
+        [Op_Move] = &&L_Op_Move, [Op_FloatMove] = &&L_Op_FloatMove,
+        [Op_ArrayLoad] = &&L_Op_ArrayLoad, [Op_ArrayStore] = &&L_Op_ArrayStore,
+        [Op_Goto] = &&L_Op_Goto, [Op_IfFalse] = &&L_Op_IfFalse,
+        [Op_Write] = &&L_Op_Write, [Op_WriteFloat] = &&L_Op_WriteFloat, [Op_Halt] = &&L_Op_Halt,
+    };
+    for (int i = 0; i <= program.count; i++)
+        program.code[i].handler = handlers[program.code[i].opcode];
+
+#define CASE(op) L_##op:
+#define DISPATCH()           \
+    do                       \
+    {                        \
+        executed++;          \
+        goto *ip->handler;   \
+    } while (0)
+#else
+#define CASE(op) case op:
+#define DISPATCH() \
+    do             \
+    {              \
+        executed++; \
+        goto dispatch; \
+    } while (0)
+#endif
+#define NEXT()     \
+    do             \
+    {              \
+        ip++;      \
+        DISPATCH(); \
+    } while (0)
+
+    DISPATCH();
+
+#ifndef INTERPRETER_THREADED
+dispatch:
+    switch (ip->opcode)
+    {
+#endif
+    CASE(Op_Add)
+        slots[ip->r].i = (int32_t)((uint32_t)I(a) + (uint32_t)I(b));
+        NEXT();
+    CASE(Op_Sub)
+        slots[ip->r].i = (int32_t)((uint32_t)I(a) - (uint32_t)I(b));
+        NEXT();
+    CASE(Op_Mul)
+        slots[ip->r].i = (int32_t)((uint32_t)I(a) * (uint32_t)I(b));
+        NEXT();
+    CASE(Op_Div)
+        if (I(b) == 0)
+        {
+            fprintf(stderr, "Runtime error: Division by zero\n");
+            ok = false;
+            goto done;
+        }
+        slots[ip->r].i = I(b) == -1 ? (int32_t)(0u - (uint32_t)I(a)) : I(a) / I(b);
+        NEXT();
+    CASE(Op_Lt)
+        slots[ip->r].i = I(a) < I(b);
+        NEXT();
+    CASE(Op_Le)
+        slots[ip->r].i = I(a) <= I(b);
+        NEXT();
+    CASE(Op_Gt)
+        slots[ip->r].i = I(a) > I(b);
+        NEXT();
+    CASE(Op_Ge)
+        slots[ip->r].i = I(a) >= I(b);
+        NEXT();
+    CASE(Op_Eq)
+        slots[ip->r].i = I(a) == I(b);
+        NEXT();
+    CASE(Op_Ne)
+        slots[ip->r].i = I(a) != I(b);
+        NEXT();
+    CASE(Op_FloatLt)
+        slots[ip->r].i = FA < FB;
+        NEXT();
+    CASE(Op_FloatLe)
+        slots[ip->r].i = FA <= FB;
+        NEXT();
+    CASE(Op_FloatGt)
+        slots[ip->r].i = FA > FB;
+        NEXT();
+    CASE(Op_FloatGe)
+        slots[ip->r].i = FA >= FB;
+        NEXT();
+    CASE(Op_FloatEq)
+        slots[ip->r].i = FA == FB;
+        NEXT();
+    CASE(Op_FloatNe)
+        slots[ip->r].i = FA != FB;
+        NEXT();
+    CASE(Op_FloatAdd)
+        slots[ip->r].f = FA + FB;
+        NEXT();
+    CASE(Op_FloatSub)
+        slots[ip->r].f = FA - FB;
+        NEXT();
+    CASE(Op_FloatMul)
+        slots[ip->r].f = FA * FB;
+        NEXT();
+    CASE(Op_FloatDiv)
+        slots[ip->r].f = FA / FB;
+        NEXT();
+    CASE(Op_Move)
+        slots[ip->r] = slots[ip->a];
+        NEXT();
+    CASE(Op_FloatMove)
+        slots[ip->r].f = FA;
+        NEXT();
+    CASE(Op_ArrayLoad)
+    {
+        const ArrayLayout *array = &arrays[ip->b];
+        if ((uint32_t)I(a) >= (uint32_t)array->size)
+            goto outOfBounds;
+        slots[ip->r] = memory[array->base + I(a)];
+        NEXT();
+    }
+    CASE(Op_ArrayStore)
+    {
+        const ArrayLayout *array = &arrays[ip->r];
+        if ((uint32_t)I(a) >= (uint32_t)array->size)
+            goto outOfBounds;
+        if (ip->flags & CONVERT_B)
+            memory[array->base + I(a)].f = (float)I(b);
+        else
+            memory[array->base + I(a)] = slots[ip->b];
+        NEXT();
+    }
+    CASE(Op_Goto)
+        JUMP();
+    CASE(Op_IfFalse)
+        if (I(a) == 0)
+            JUMP();
+        NEXT();
+    CASE(Op_Write)
+        if (out)
+            fprintf(out, "%d\n", I(a));
+        NEXT();
+    CASE(Op_WriteFloat)
+        if (out)
+            fprintf(out, "%.9g\n", FA);
+        NEXT();
+    CASE(Op_Halt)
+        executed--; // Not a TAC instruction
+        goto done;
+#ifndef INTERPRETER_THREADED
+    default:
+        goto done;
+    }
+#endif
+
+outOfBounds:
+    fprintf(stderr, "Runtime error: Array index %d out of bounds\n", I(a));
+    ok = false;
+    goto done;
+
+stepLimit:
+    fprintf(stderr, "Runtime error: Step limit of %lld instructions reached\n", maxSteps);
+    ok = false;
+
+done:
+#undef I
+#undef FA
+#undef FB
+#undef JUMP
+#undef CASE
+#undef DISPATCH
+#undef NEXT
+    stats->executed = executed;
+    freeProgram(&program);
+    return ok;
+}
+
+// ---- Pass-by-pass comparison ----
+
+static SymbolTable *comparisonSymTab = NULL;
+static char *referenceOutput = NULL;
+static size_t referenceLength = 0;
+static bool referenceOk = false;
+
+void beginPassComparison(SymbolTable *symTab)
+{
+    comparisonSymTab = symTab;
+    endPassComparison();
+    fprintf(stderr, "%-32s %10s %14s  %s\n", "Pass", "TAC", "Executed", "Output");
+}
+
+void comparePass(const char *passName, TAC *head)
+{
+    if (comparisonSymTab == NULL)
+        return;
+
+    char *output = NULL;
+    size_t length = 0;
+    FILE *out = open_memstream(&output, &length);
+    InterpreterStats stats;
+    bool ok = interpretTAC(head, comparisonSymTab, out, INTERPRETER_MAX_STEPS, &stats);
+    fclose(out);
+
+    const char *verdict;
+    if (referenceOutput == NULL)
+    {
+        // The first run is the reference
+        referenceOutput = output;
+        referenceLength = length;
+        referenceOk = ok;
+        verdict = ok ? "reference" : "reference (runtime error)";
+    }
+    else
+    {
+        bool same = ok == referenceOk && length == referenceLength && memcmp(output, referenceOutput, length) == 0;
+        verdict = same ? "same" : "DIFFERS";
+        free(output);
+    }
+    fprintf(stderr, "%-32s %10d %14lld  %s\n", passName, stats.instructions, stats.executed, verdict);
+}
+
+void endPassComparison()
+{
+    free(referenceOutput);
+    referenceOutput = NULL;
+    referenceLength = 0;
+    referenceOk = false;
+}
@@ -0,0 +1,32 @@
+// interpreter.h
+
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "semantic.h"
+#include "SymbolTable.h"
+
+// Instructions a run may execute before it is treated as non-terminating
+#define INTERPRETER_MAX_STEPS 100000000LL
+
+typedef struct
+{
+    int instructions;   // TAC instructions in the program, labels excluded
+    long long executed; // TAC instructions executed
+} InterpreterStats;
+
+// Run a TAC list directly. Variables start from the values the .data
+// section would give them. Output goes to out, which may be NULL.
+// Returns false on a runtime error or when maxSteps is exceeded.
+bool interpretTAC(TAC *head, SymbolTable *symTab, FILE *out, long long maxSteps, InterpreterStats *stats);
+
+// Pass-by-pass checking: the first comparePass records the reference
+// output and each later one reports whether the program still prints the
+// same thing, along with its static and executed instruction counts
+void beginPassComparison(SymbolTable *symTab);
+void comparePass(const char *passName, TAC *head);
+void endPassComparison();
+
+#endif // INTERPRETER_H
@@ -0,0 +1,748 @@
+// irfile.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "irfile.h"
+#include "utils.h"
+#include "temp.h"
+
+// Operand tags, two bits per operand (arg1, arg2, result)
+#define TAG_NONE 0
+#define TAG_STRING 1   // Index into the string table
+#define TAG_TEMP 2     // Virtual register number
+#define TAG_INTEGER 3  // Integer constant
+
+#define IR_NO_STRING 0xffffffffu
+
+// Every operation the front end and optimizer produce
+static const char *irOpcodes[] = {
+    "=", "+", "-", "*", "/", "fadd", "fsub", "fmul", "fdiv", "fmov",
+    "<", "<=", ">", ">=", "==", "!=", "[]=", "=[]",
+    "write", "write_float", "label", "goto", "ifFalse",
+};
+#define IR_OPCODE_COUNT (int)(sizeof(irOpcodes) / sizeof(irOpcodes[0]))
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t stringCount;
+    uint32_t stringBytes;      // Size of the string data, padded to 4
+    uint32_t symbolCount;
+    uint32_t knownValueCount;
+    uint32_t instructionCount;
+    uint32_t tempCount;        // Virtual registers handed out when saved
+    uint32_t flags;            // IR_FLAG_*
+} IRHeader;
+
+typedef struct
+{
+    uint32_t name;      // String table index
+    uint32_t value;     // String table index or IR_NO_STRING
+    int32_t arraySize;  // 0 for scalars
+    uint8_t type;       // DataType
+    uint8_t isArray;
+    uint8_t elementType; // DataType of the array elements
+    uint8_t reserved;
+} IRSymbol;
+
+typedef struct
+{
+    uint32_t symbol; // Position in the symbol records
+    int32_t index;
+    uint32_t bits;   // ArrayValue
+} IRKnownValue;
+
+typedef struct
+{
+    uint8_t opcode;
+    uint8_t tags;
+    uint16_t reserved;
+    uint32_t operands[3]; // arg1, arg2, result
+} IRInstruction;
+
+// ---- Writing ----
+
+// Strings collected while writing, deduplicated through a hash table
+typedef struct
+{
+    char **strings;
+    int count;
+    int capacity;
+    int *slots; // Open addressing: index into strings, or -1
+    int slotCount;
+    size_t bytes;
+} StringTable;
+
+static uint32_t hashName(const char *str)
+{
+    uint32_t hash = 2166136261u;
+    while (*str)
+    {
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void initStringTable(StringTable *table)
+{
+    table->strings = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->slotCount = 256;
+    table->slots = (int *)malloc(sizeof(int) * table->slotCount);
+    memset(table->slots, -1, sizeof(int) * table->slotCount);
+    table->bytes = 0;
+}
+
+static void freeStringTable(StringTable *table)
+{
+    free(table->strings);
+    free(table->slots);
+}
+
+static uint32_t addString(StringTable *table, char *str)
+{
+    if ((table->count + 1) * 2 > table->slotCount)
+    {
+        int slotCount = table->slotCount * 2;
+        int *slots = (int *)malloc(sizeof(int) * slotCount);
+        memset(slots, -1, sizeof(int) * slotCount);
+        for (int i = 0; i < table->count; i++)
+        {
+            int j = hashName(table->strings[i]) & (slotCount - 1);
+            while (slots[j] != -1)
+                j = (j + 1) & (slotCount - 1);
+            slots[j] = i;
+        }
+        free(table->slots);
+        table->slots = slots;
+        table->slotCount = slotCount;
+    }
+
+    int j = hashName(str) & (table->slotCount - 1);
+    while (table->slots[j] != -1)
+    {
+        if (strcmp(table->strings[table->slots[j]], str) == 0)
+            return (uint32_t)table->slots[j];
+        j = (j + 1) & (table->slotCount - 1);
+    }
+
+    if (table->count == table->capacity)
+    {
+        table->capacity = table->capacity ? table->capacity * 2 : 256;
+        table->strings = (char **)realloc(table->strings, sizeof(char *) * table->capacity);
+    }
+    table->strings[table->count] = str;
+    table->slots[j] = table->count;
+    table->bytes += strlen(str) + 1;
+    return (uint32_t)table->count++;
+}
+
+// Encode one operand, returning its tag
+static int encodeOperand(StringTable *table, char *operand, uint32_t *encoded)
+{
+    char text[32];
+    if (operand == NULL)
+    {
+        *encoded = 0;
+        return TAG_NONE;
+    }
+    // Numbers are stored inline only when they print back identically
+    if (isVirtualRegister(operand))
+    {
+        int number = virtualRegisterNumber(operand);
+        snprintf(text, sizeof(text), "%s%d", TEMP_PREFIX, number);
+        if (number >= 0 && strcmp(text, operand) == 0)
+        {
+            *encoded = (uint32_t)number;
+            return TAG_TEMP;
+        }
+    }
+    else if (isConstant(operand) && strlen(operand) < 12)
+    {
+        long value = strtol(operand, NULL, 10);
+        snprintf(text, sizeof(text), "%ld", value);
+        if (value >= INT32_MIN && value <= INT32_MAX && strcmp(text, operand) == 0)
+        {
+            *encoded = (uint32_t)(int32_t)value;
+            return TAG_INTEGER;
+        }
+    }
+    *encoded = addString(table, operand);
+    return TAG_STRING;
+}
+
+static int findOpcode(const char *op)
+{
+    for (int i = 0; i < IR_OPCODE_COUNT; i++)
+    {
+        if (strcmp(irOpcodes[i], op) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// Append the statically known elements of an array
+static void collectKnownValues(Array *array, uint32_t symbol, IRKnownValue **values, int *count, int *capacity)
+{
+    if (array == NULL || array->knownCount == 0)
+        return;
+    int found = 0;
+    int limit = array->isDense ? array->size : array->capacity;
+    for (int i = 0; i < limit && found < array->knownCount; i++)
+    {
+        int index = array->isDense ? i : array->slots[i].index;
+        if (index < 0)
+            continue;
+        const ArrayValue *value = getArrayValue(array, index);
+        if (value == NULL)
+            continue;
+        if (*count == *capacity)
+        {
+            *capacity = *capacity ? *capacity * 2 : 64;
+            *values = (IRKnownValue *)realloc(*values, sizeof(IRKnownValue) * *capacity);
+        }
+        IRKnownValue *known = &(*values)[(*count)++];
+        known->symbol = symbol;
+        known->index = index;
+        memcpy(&known->bits, value, sizeof(known->bits));
+        found++;
+    }
+}
+
+bool writeBinaryIR(const char *path, TAC *head, SymbolTable *symTab, bool optimized)
+{
+    StringTable strings;
+    initStringTable(&strings);
+
+    // Symbols in id order, so reloading gives them the same ids
+    IRSymbol *symbols = (IRSymbol *)calloc(symTab->count + 1, sizeof(IRSymbol));
+    IRKnownValue *knownValues = NULL;
+    int knownCount = 0, knownCapacity = 0;
+    for (int id = 1; id <= symTab->count; id++)
+    {
+        Symbol *symbol = getSymbolById(symTab, id);
+        IRSymbol *record = &symbols[id - 1];
+        record->name = addString(&strings, symbol->name);
+        record->value = symbol->value ? addString(&strings, symbol->value) : IR_NO_STRING;
+        record->type = (uint8_t)symbol->type;
+        record->isArray = symbol->isArray && symbol->arrayInfo != NULL;
+        if (record->isArray)
+        {
+            record->arraySize = symbol->arrayInfo->size;
+            record->elementType = (uint8_t)symbol->arrayInfo->dataType;
+            collectKnownValues(symbol->arrayInfo, (uint32_t)(id - 1), &knownValues, &knownCount, &knownCapacity);
+        }
+    }
+
+    int instructionCount = 0;
+    for (TAC *current = head; current != NULL; current = current->next)
+        instructionCount++;
+    IRInstruction *instructions = (IRInstruction *)calloc(instructionCount + 1, sizeof(IRInstruction));
+    int i = 0;
+    for (TAC *current = head; current != NULL; current = current->next, i++)
+    {
+        int opcode = findOpcode(current->op);
+        if (opcode < 0)
+        {
+            fprintf(stderr, "Error: Unsupported TAC operation '%s' in IR output\n", current->op);
+            free(instructions);
+            free(knownValues);
+            free(symbols);
+            freeStringTable(&strings);
+            return false;
+        }
+        IRInstruction *instr = &instructions[i];
+        instr->opcode = (uint8_t)opcode;
+        instr->tags = (uint8_t)(encodeOperand(&strings, current->arg1, &instr->operands[0]) |
+                                encodeOperand(&strings, current->arg2, &instr->operands[1]) << 2 |
+                                encodeOperand(&strings, current->result, &instr->operands[2]) << 4);
+    }
+
+    IRHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IR_MAGIC, sizeof(header.magic));
+    header.version = IR_VERSION;
+    header.stringCount = (uint32_t)strings.count;
+    header.stringBytes = (uint32_t)((strings.bytes + 3) & ~(size_t)3);
+    header.symbolCount = (uint32_t)symTab->count;
+    header.knownValueCount = (uint32_t)knownCount;
+    header.instructionCount = (uint32_t)instructionCount;
+    header.tempCount = (uint32_t)tempCount;
+    header.flags = optimized ? IR_FLAG_OPTIMIZED : 0;
+
+    bool ok = false;
+    FILE *file = fopen(path, "wb");
+    if (file != NULL)
+    {
+        fwrite(&header, sizeof(header), 1, file);
+        uint32_t offset = 0;
+        for (int s = 0; s < strings.count; s++)
+        {
+            fwrite(&offset, sizeof(offset), 1, file);
+            offset += (uint32_t)strlen(strings.strings[s]) + 1;
+        }
+        for (int s = 0; s < strings.count; s++)
+            fwrite(strings.strings[s], 1, strlen(strings.strings[s]) + 1, file);
+        static const char padding[4] = {0, 0, 0, 0};
+        fwrite(padding, 1, header.stringBytes - strings.bytes, file);
+        fwrite(symbols, sizeof(IRSymbol), symTab->count, file);
+        fwrite(knownValues, sizeof(IRKnownValue), knownCount, file);
+        fwrite(instructions, sizeof(IRInstruction), instructionCount, file);
+        ok = !ferror(file);
+        if (fclose(file) != 0)
+            ok = false;
+    }
+    if (!ok)
+        perror(path);
+
+    free(instructions);
+    free(knownValues);
+    free(symbols);
+    freeStringTable(&strings);
+    return ok;
+}
+
+// ---- Loading ----
+
+static char *decodeOperand(const char *strings, const uint32_t *offsets, int tag, uint32_t operand)
+{
+    char text[32];
+    switch (tag)
+    {
+    case TAG_STRING:
+        return strdup(strings + offsets[operand]);
+    case TAG_TEMP:
+        snprintf(text, sizeof(text), "%s%u", TEMP_PREFIX, operand);
+        return strdup(text);
+    case TAG_INTEGER:
+        snprintf(text, sizeof(text), "%d", (int32_t)operand);
+        return strdup(text);
+    default:
+        return NULL;
+    }
+}
+
+TAC *loadBinaryIR(const char *path, SymbolTable *symTab, bool *optimized)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror(path);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(IRHeader))
+    {
+        fprintf(stderr, "Error: %s is not an IR file\n", path);
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)info.st_size;
+    const char *data = (const char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    // Check the header and that every section lies within the file
+    const IRHeader *header = (const IRHeader *)data;
+    size_t stringsAt = sizeof(IRHeader) + (size_t)header->stringCount * sizeof(uint32_t);
+    size_t symbolsAt = stringsAt + header->stringBytes;
+    size_t knownAt = symbolsAt + (size_t)header->symbolCount * sizeof(IRSymbol);
+    size_t instructionsAt = knownAt + (size_t)header->knownValueCount * sizeof(IRKnownValue);
+    size_t end = instructionsAt + (size_t)header->instructionCount * sizeof(IRInstruction);
+    if (memcmp(header->magic, IR_MAGIC, sizeof(header->magic)) != 0 || header->version != IR_VERSION ||
+        end != size || (header->stringBytes > 0 && data[symbolsAt - 1] != '\0'))
+    {
+        fprintf(stderr, "Error: %s is not a version %d IR file\n", path, IR_VERSION);
+        munmap((void *)data, size);
+        return NULL;
+    }
+    const uint32_t *offsets = (const uint32_t *)(data + sizeof(IRHeader));
+    const char *strings = data + stringsAt;
+    const IRSymbol *symbols = (const IRSymbol *)(data + symbolsAt);
+    const IRKnownValue *knownValues = (const IRKnownValue *)(data + knownAt);
+    const IRInstruction *instructions = (const IRInstruction *)(data + instructionsAt);
+
+    bool ok = true;
+    for (uint32_t s = 0; s < header->stringCount && ok; s++)
+        ok = offsets[s] < header->stringBytes;
+
+    // Declare the symbols in their original order, then restore their values
+    for (uint32_t s = 0; s < header->symbolCount && ok; s++)
+    {
+        const IRSymbol *record = &symbols[s];
+        if (record->name >= header->stringCount ||
+            (record->value != IR_NO_STRING && record->value >= header->stringCount))
+        {
+            ok = false;
+            break;
+        }
+        Array *array = NULL;
+        if (record->isArray)
+        {
+            array = createArray((DataType)record->elementType, record->arraySize);
+            if (array == NULL)
+            {
+                ok = false;
+                break;
+            }
+        }
+        Symbol *symbol = insertSymbol(symTab, strings + offsets[record->name], (DataType)record->type, record->isArray, array);
+        if (symbol == NULL)
+        {
+            freeArray(array);
+            ok = false;
+            break;
+        }
+        free(symbol->value);
+        symbol->value = record->value != IR_NO_STRING ? strdup(strings + offsets[record->value]) : NULL;
+    }
+    for (uint32_t k = 0; k < header->knownValueCount && ok; k++)
+    {
+        Symbol *symbol = getSymbolById(symTab, (int)knownValues[k].symbol + 1);
+        ArrayValue value;
+        memcpy(&value, &knownValues[k].bits, sizeof(value));
+        ok = symbol != NULL && symbol->arrayInfo != NULL &&
+             setArrayValue(symbol->arrayInfo, knownValues[k].index, value);
+    }
+
+    TAC *head = NULL;
+    TAC **tail = &head;
+    for (uint32_t i = 0; i < header->instructionCount && ok; i++)
+    {
+        const IRInstruction *record = &instructions[i];
+        if (record->opcode >= IR_OPCODE_COUNT)
+        {
+            ok = false;
+            break;
+        }
+        for (int o = 0; o < 3; o++)
+        {
+            if ((record->tags >> (o * 2) & 3) == TAG_STRING && record->operands[o] >= header->stringCount)
+                ok = false;
+        }
+        if (!ok)
+            break;
+
+        TAC *instr = (TAC *)malloc(sizeof(TAC));
+        instr->op = strdup(irOpcodes[record->opcode]);
+        instr->arg1 = decodeOperand(strings, offsets, record->tags & 3, record->operands[0]);
+        instr->arg2 = decodeOperand(strings, offsets, record->tags >> 2 & 3, record->operands[1]);
+        instr->result = decodeOperand(strings, offsets, record->tags >> 4 & 3, record->operands[2]);
+        instr->next = NULL;
+        *tail = instr;
+        tail = &instr->next;
+    }
+
+    if (ok && (int)header->tempCount > tempCount)
+        tempCount = (int)header->tempCount;
+    if (optimized != NULL)
+        *optimized = (header->flags & IR_FLAG_OPTIMIZED) != 0;
+    munmap((void *)data, size);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Error: %s is damaged\n", path);
+        freeTACList(head);
+        return NULL;
+    }
+    return head;
+}
+
+// ---- Text dumps ----
+
+static TAC *newInstruction(const char *op, const char *arg1, const char *arg2, const char *result)
+{
+    TAC *instr = (TAC *)malloc(sizeof(TAC));
+    instr->op = strdup(op);
+    instr->arg1 = arg1 ? strdup(arg1) : NULL;
+    instr->arg2 = arg2 ? strdup(arg2) : NULL;
+    instr->result = result ? strdup(result) : NULL;
+    instr->next = NULL;
+    return instr;
+}
+
+// Parse one line of a dump (the forms printTACToFile writes)
+static TAC *parseTextInstruction(char **tokens, int count)
+{
+    if (count == 1 && tokens[0][strlen(tokens[0]) - 1] == ':')
+    {
+        tokens[0][strlen(tokens[0]) - 1] = '\0';
+        return newInstruction("label", NULL, NULL, tokens[0]);
+    }
+    if (count == 2 && strcmp(tokens[0], "goto") == 0)
+        return newInstruction("goto", NULL, NULL, tokens[1]);
+    if (count == 2 && strcmp(tokens[0], "write") == 0)
+        return newInstruction("write", tokens[1], NULL, NULL);
+    if (count == 4 && strcmp(tokens[0], "ifFalse") == 0 && strcmp(tokens[2], "goto") == 0)
+        return newInstruction("ifFalse", tokens[1], NULL, tokens[3]);
+    if (count == 6 && strcmp(tokens[1], "[") == 0 && strcmp(tokens[3], "]") == 0 && strcmp(tokens[4], "=") == 0)
+        return newInstruction("[]=", tokens[2], tokens[5], tokens[0]);
+    if (count < 3 || strcmp(tokens[1], "=") != 0)
+        return NULL;
+    if (count == 3)
+        return newInstruction("=", tokens[2], NULL, tokens[0]);
+    if (count == 4 && strcmp(tokens[3], "(float)") == 0)
+        return newInstruction("fmov", tokens[2], NULL, tokens[0]);
+    if (count == 6 && strcmp(tokens[3], "[") == 0 && strcmp(tokens[5], "]") == 0)
+        return newInstruction("=[]", tokens[2], tokens[4], tokens[0]);
+    if (count == 5 && strcmp(tokens[3], "write_float") == 0)
+        return newInstruction("write_float", tokens[2], NULL, NULL);
+    if (count == 5 && findOpcode(tokens[3]) >= 0)
+        return newInstruction(tokens[3], tokens[2], tokens[4], tokens[0]);
+    return NULL;
+}
+
+// Apply a declaration line of a dump (the forms printDeclarationsToFile
+// writes). Returns false if the line is not a declaration; *ok is
+// cleared if it is one that cannot be applied.
+static bool parseTextDeclaration(char **tokens, int count, SymbolTable *symTab, bool *ok)
+{
+    if (count == 7 && strcmp(tokens[0], "data") == 0 && strcmp(tokens[2], "[") == 0 &&
+        strcmp(tokens[4], "]") == 0 && strcmp(tokens[5], "=") == 0)
+    {
+        Symbol *symbol = findSymbol(symTab, tokens[1]);
+        if (symbol == NULL || !symbol->isArray || symbol->arrayInfo == NULL || !isConstant(tokens[3]))
+        {
+            *ok = false;
+            return true;
+        }
+        ArrayValue value;
+        if (symbol->arrayInfo->isFloat)
+            value.floatValue = (float)atof(tokens[6]);
+        else
+            value.intValue = atoi(tokens[6]);
+        *ok = setArrayValue(symbol->arrayInfo, atoi(tokens[3]), value);
+        return true;
+    }
+
+    DataType type = dataTypeFromName(tokens[0]);
+    if (type == DataType_Unknown || type == DataType_Void)
+        return false;
+    Symbol *symbol = NULL;
+    if (count == 2 || (count == 4 && strcmp(tokens[2], "=") == 0))
+    {
+        symbol = insertSymbol(symTab, tokens[1], type, false, NULL);
+        if (symbol != NULL && count == 4)
+        {
+            free(symbol->value);
+            symbol->value = strdup(tokens[3]);
+        }
+    }
+    else if (count == 5 && strcmp(tokens[2], "[") == 0 && strcmp(tokens[4], "]") == 0 && isConstant(tokens[3]))
+    {
+        Array *array = createArray(type, atoi(tokens[3]));
+        symbol = array != NULL ? insertSymbol(symTab, tokens[1], type, true, array) : NULL;
+        if (symbol == NULL)
+            freeArray(array);
+    }
+    else
+    {
+        return false;
+    }
+    *ok = symbol != NULL;
+    return true;
+}
+
+// A variable name (not a constant, temporary or label)
+static bool isVariableName(const char *operand)
+{
+    return operand != NULL && isVariable(operand) && !isVirtualRegister(operand) && operand[0] != '_';
+}
+
+typedef struct
+{
+    char *name;
+    bool isArray;
+    bool isFloat;
+    bool variableIndex; // Indexed by something other than a constant
+    int size;           // Largest constant index seen plus one
+} InferredSymbol;
+
+static InferredSymbol *inferSymbol(InferredSymbol **symbols, int *count, int *capacity, const char *name)
+{
+    for (int i = 0; i < *count; i++)
+    {
+        if (strcmp((*symbols)[i].name, name) == 0)
+            return &(*symbols)[i];
+    }
+    if (*count == *capacity)
+    {
+        *capacity = *capacity ? *capacity * 2 : 64;
+        *symbols = (InferredSymbol *)realloc(*symbols, sizeof(InferredSymbol) * *capacity);
+    }
+    InferredSymbol *symbol = &(*symbols)[(*count)++];
+    symbol->name = (char *)name;
+    symbol->isArray = false;
+    symbol->isFloat = false;
+    symbol->variableIndex = false;
+    symbol->size = 1;
+    return symbol;
+}
+
+static void noteArrayIndex(InferredSymbol *symbol, const char *index)
+{
+    symbol->isArray = true;
+    if (!isConstant(index))
+        symbol->variableIndex = true;
+    else if (atoi(index) + 1 > symbol->size)
+        symbol->size = atoi(index) + 1;
+}
+
+// Declare every variable a dump mentions but does not declare, in order of
+// first use. False if an array's size cannot be inferred.
+static bool declareInferredSymbols(const char *path, TAC *head, SymbolTable *symTab)
+{
+    InferredSymbol *symbols = NULL;
+    int count = 0, capacity = 0;
+    int maxTemp = -1;
+    for (TAC *current = head; current != NULL; current = current->next)
+    {
+        char *operands[3] = {current->arg1, current->arg2, current->result};
+        for (int o = 0; o < 3; o++)
+        {
+            if (operands[o] != NULL && isVirtualRegister(operands[o]) && virtualRegisterNumber(operands[o]) > maxTemp)
+                maxTemp = virtualRegisterNumber(operands[o]);
+        }
+        if (isLabel(current) || isBranch(current))
+        {
+            if (current->arg1 != NULL && isVariableName(current->arg1))
+                inferSymbol(&symbols, &count, &capacity, current->arg1);
+            continue;
+        }
+
+        for (int o = 0; o < 3; o++)
+        {
+            if (isVariableName(operands[o]))
+                inferSymbol(&symbols, &count, &capacity, operands[o]);
+        }
+        if (strcmp(current->op, "[]=") == 0)
+            noteArrayIndex(inferSymbol(&symbols, &count, &capacity, current->result), current->arg1);
+        else if (strcmp(current->op, "=[]") == 0)
+            noteArrayIndex(inferSymbol(&symbols, &count, &capacity, current->arg1), current->arg2);
+        else if (strcmp(current->op, "fmov") == 0)
+            inferSymbol(&symbols, &count, &capacity, current->result)->isFloat = true;
+    }
+
+    bool ok = true;
+    for (int i = 0; i < count && ok; i++)
+    {
+        if (findSymbol(symTab, symbols[i].name) != NULL)
+            continue;
+        if (symbols[i].variableIndex)
+        {
+            // Only the constant indices bound the size, and they may not reach the end
+            fprintf(stderr, "Error: %s: Size of array %s cannot be inferred; it has no declaration\n",
+                    path, symbols[i].name);
+            ok = false;
+            break;
+        }
+        DataType type = symbols[i].isFloat ? DataType_Float : DataType_Int;
+        Array *array = symbols[i].isArray ? createArray(type, symbols[i].size) : NULL;
+        insertSymbol(symTab, symbols[i].name, type, symbols[i].isArray, array);
+    }
+    free(symbols);
+
+    if (maxTemp + 1 > tempCount)
+        tempCount = maxTemp + 1;
+    return ok;
+}
+
+TAC *readTextIR(const char *path, SymbolTable *symTab, bool *optimized)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    TAC *head = NULL;
+    TAC **tail = &head;
+    char *line = NULL;
+    size_t lineCapacity = 0;
+    int lineNumber = 0;
+    bool ok = true;
+    if (optimized != NULL)
+        *optimized = false;
+    while (getline(&line, &lineCapacity, file) != -1)
+    {
+        lineNumber++;
+        char *tokens[8];
+        int count = 0;
+        char *save = NULL;
+        for (char *token = strtok_r(line, " \t\r\n", &save); token != NULL; token = strtok_r(NULL, " \t\r\n", &save))
+        {
+            if (count == 8)
+            {
+                count = -1;
+                break;
+            }
+            tokens[count++] = token;
+        }
+        if (count == 0)
+            continue;
+        if (count == 1 && strcmp(tokens[0], "optimized") == 0 && lineNumber == 1)
+        {
+            if (optimized != NULL)
+                *optimized = true;
+            continue;
+        }
+        if (count > 0 && parseTextDeclaration(tokens, count, symTab, &ok))
+        {
+            if (!ok)
+            {
+                fprintf(stderr, "Error: %s:%d: Bad declaration\n", path, lineNumber);
+                break;
+            }
+            continue;
+        }
+
+        TAC *instr = count > 0 ? parseTextInstruction(tokens, count) : NULL;
+        if (instr == NULL)
+        {
+            fprintf(stderr, "Error: %s:%d: Unrecognised TAC\n", path, lineNumber);
+            ok = false;
+            break;
+        }
+        *tail = instr;
+        tail = &instr->next;
+    }
+    free(line);
+    fclose(file);
+
+    if (!ok || !declareInferredSymbols(path, head, symTab))
+    {
+        freeTACList(head);
+        return NULL;
+    }
+    return head;
+}
+
+TAC *loadIRFile(const char *path, SymbolTable *symTab, bool *optimized)
+{
+    char magic[8] = {0};
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+    size_t n = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    if (n == sizeof(magic) && memcmp(magic, IR_MAGIC, sizeof(magic)) == 0)
+        return loadBinaryIR(path, symTab, optimized);
+    return readTextIR(path, symTab, optimized);
+}
@@ -0,0 +1,47 @@
+// irfile.h
+
+#ifndef IRFILE_H
+#define IRFILE_H
+
+#include <stdbool.h>
+#include "semantic.h"
+#include "SymbolTable.h"
+
+// Saved IR, so the optimizer and code generator can be run on a program
+// without the front end.
+//
+// The binary format (native byte order) is a header, a string table, the
+// symbol table and the instructions. Each instruction is an opcode plus
+// three operands whose 2-bit tags say whether they hold a string table
+// index, a virtual register number or an integer constant. Unlike the
+// text dumps it carries the declarations, initial values and statically
+// known array elements. The header records whether the optimizer has
+// already run, so a loaded TACopt.tacb goes straight to code generation
+// and compiles like the original.
+#define IR_MAGIC "CMMTAC\0"
+#define IR_VERSION 1
+
+#define IR_FLAG_OPTIMIZED 1 // The instructions are the optimizer's output
+
+// Write head and the symbols it uses to path; false on failure
+bool writeBinaryIR(const char *path, TAC *head, SymbolTable *symTab, bool optimized);
+
+// Load a binary IR file through mmap, declaring its symbols in symTab,
+// which must be empty, and reporting through optimized (if not NULL)
+// whether the file was written after optimization. NULL on failure.
+TAC *loadBinaryIR(const char *path, SymbolTable *symTab, bool *optimized);
+
+// Read a text dump written by printTACToFile, reporting through optimized
+// (if not NULL) whether it opens with the "optimized" line. Its leading
+// declarations give the symbols and their initial values. Variables a dump does not
+// declare are inferred: those assigned through fmov are float, and an
+// array's size is one past the largest constant index used with it (an
+// undeclared array with a variable index is an error). Inferred variables
+// start at zero. NULL on failure.
+TAC *readTextIR(const char *path, SymbolTable *symTab, bool *optimized);
+
+// Load either format, recognising binary IR by its magic number. Either
+// way a TACopt dump reports itself optimized and is not optimized again.
+TAC *loadIRFile(const char *path, SymbolTable *symTab, bool *optimized);
+
+#endif // IRFILE_H
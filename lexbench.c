@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include "parser.tab.h"
+#include "intern.h"
+#include "source.h"
+
+// Standalone lexing benchmark: scans a source file repeatedly and reports
+// token throughput and peak memory, without running the parser.
+//
+// Usage: ./lexbench [file] [iterations] [mmap|stdio]
+//
+// "mmap" (the default) scans the file in place as the compiler does;
+// "stdio" reads it through flex's buffered YY_INPUT for comparison.
+
+extern int yylex();
+extern void yyrestart(FILE *file);
+extern int lexerVerbose;
+
+// The parser normally owns yylval; the benchmark links the lexer alone
+YYSTYPE yylval;
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "input.cmm";
+    int iterations = argc > 2 ? atoi(argv[2]) : 1000;
+    bool useStdio = argc > 3 && strcmp(argv[3], "stdio") == 0;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "Error: Iteration count must be positive\n");
+        return 1;
+    }
+
+    lexerVerbose = 0;
+
+    long long tokens = 0;
+    long long bytes = 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < iterations; i++)
+    {
+        if (useStdio)
+        {
+            FILE *file = fopen(path, "r");
+            if (!file)
+            {
+                perror(path);
+                return 1;
+            }
+            fseek(file, 0, SEEK_END);
+            bytes += ftell(file);
+            rewind(file);
+
+            yyrestart(file);
+            while (yylex() != 0)
+            {
+                tokens++;
+            }
+            fclose(file);
+        }
+        else
+        {
+            SourceBuffer *source = openSourceFile(path);
+            if (source == NULL || !beginSourceScan(source))
+            {
+                return 1;
+            }
+            bytes += source->length;
+
+            while (yylex() != 0)
+            {
+                tokens++;
+            }
+            endSourceScan();
+            closeSourceFile(source);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("File:            %s\n", path);
+    printf("Input:           %s\n", useStdio ? "stdio" : "mmap");
+    printf("Iterations:      %d\n", iterations);
+    printf("Tokens:          %lld\n", tokens);
+    printf("Interned names:  %d\n", getInternCount());
+    printf("Time:            %.3f s\n", seconds);
+    printf("Tokens/second:   %.0f\n", seconds > 0 ? tokens / seconds : 0.0);
+    printf("MB/second:       %.2f\n", seconds > 0 ? bytes / seconds / (1024.0 * 1024.0) : 0.0);
+    printf("Peak RSS:        %ld KB\n", usage.ru_maxrss);
+
+    freeInternTable();
+    return 0;
+}
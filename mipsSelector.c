@@ -0,0 +1,821 @@
+// mipsSelector.c
+
+#include "mipsSelector.h"
+#include "codeGenerator.h"
+#include "superopt.h"
+#include "utils.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <ctype.h>
+
+// Costs in cycles under the simulator's default cost model
+#define ALU_COST 1
+#define LOAD_COST 2
+#define STORE_COST 1
+#define MUL_COST 5
+#define DIV_COST 21 // div, then mflo
+#define BRANCH_COST 1
+
+#define INFINITE_COST (INT_MAX / 4)
+
+typedef enum
+{
+    Tree_Variable, // Leaf: variable or temporary
+    Tree_Constant, // Leaf: integer literal
+    Tree_Array,    // Leaf: address of an array
+    Tree_Add,
+    Tree_Sub,
+    Tree_Mul,
+    Tree_Div,
+    Tree_Lt,
+    Tree_Le,
+    Tree_Gt,
+    Tree_Ge,
+    Tree_Eq,
+    Tree_Ne,
+    Tree_Index,  // Address of element kids[1] of array kids[0]
+    Tree_Load,   // Word at address kids[0]
+    Tree_Set,    // Root: the window's result becomes kids[0]
+    Tree_Store,  // Root: store kids[0] at address kids[1]
+    Tree_Branch, // Root: jump to the label if kids[0] is zero
+    Tree_OpCount
+} TreeOp;
+
+// Names used in rule patterns
+static const char *treeOpNames[Tree_OpCount] = {
+    "Variable", "Constant", "Array", "Add", "Sub", "Mul", "Div", "Lt", "Le", "Gt", "Ge",
+    "Eq", "Ne", "Index", "Load", "Set", "Store", "Branch",
+};
+
+// TAC operators of Tree_Add through Tree_Ne
+static const char *binaryOperators[] = {"+", "-", "*", "/", "<", "<=", ">", ">=", "==", "!="};
+#define BINARY_OPERATOR_COUNT 10
+
+typedef enum
+{
+    NT_Reg,       // Value in a register
+    NT_Imm,       // Constant that fits a signed 16-bit immediate
+    NT_NegImm,    // Constant whose negation does
+    NT_Offset,    // Constant index whose byte offset does
+    NT_NegOffset, // Constant index whose negated byte offset does
+    NT_Symbol,    // Array name
+    NT_Addr,      // Memory operand: symbol+offset, optionally off $t9
+    NT_Stmt,
+    NT_Count
+} Nonterminal;
+
+static const char *nonterminalNames[NT_Count] = {"reg", "imm", "nimm", "off", "noff", "sym", "addr", "stmt"};
+
+// A rule rewrites the tree matched by its pattern to its nonterminal. In a
+// pattern, capitalised names are tree operators and lower-case names are
+// nonterminals, which bind %0, %1, ... from left to right. In code, %r is
+// the result register and %l the branch label.
+typedef struct
+{
+    Nonterminal lhs;
+    const char *pattern;
+    int cost;
+    const char *code;    // Instructions emitted, one per line
+    const char *operand; // For addr rules, the memory operand
+} SelectorRule;
+
+static const SelectorRule rules[] = {
+    // Arithmetic, with constants folded into immediates where MIPS has them
+    {NT_Reg, "Add(reg,reg)", ALU_COST, "add %r, %0, %1", NULL},
+    {NT_Reg, "Add(reg,imm)", ALU_COST, "addi %r, %0, %1", NULL},
+    {NT_Reg, "Add(imm,reg)", ALU_COST, "addi %r, %1, %0", NULL},
+    {NT_Reg, "Sub(reg,reg)", ALU_COST, "sub %r, %0, %1", NULL},
+    {NT_Reg, "Sub(reg,nimm)", ALU_COST, "addi %r, %0, %1", NULL},
+    {NT_Reg, "Mul(reg,reg)", MUL_COST, "mul %r, %0, %1", NULL},
+    {NT_Reg, "Mul(reg,imm)", MUL_COST, "mul %r, %0, %1", NULL},
+    {NT_Reg, "Mul(imm,reg)", MUL_COST, "mul %r, %1, %0", NULL},
+    {NT_Reg, "Div(reg,reg)", DIV_COST, "div %0, %1\nmflo %r", NULL},
+    {NT_Reg, "Div(reg,imm)", DIV_COST, "div %0, %1\nmflo %r", NULL},
+
+    // Comparisons; a constant on the left swaps the comparison
+    {NT_Reg, "Lt(reg,reg)", ALU_COST, "slt %r, %0, %1", NULL},
+    {NT_Reg, "Lt(reg,imm)", ALU_COST, "slti %r, %0, %1", NULL},
+    {NT_Reg, "Lt(imm,reg)", ALU_COST, "sgt %r, %1, %0", NULL},
+    {NT_Reg, "Gt(reg,reg)", ALU_COST, "sgt %r, %0, %1", NULL},
+    {NT_Reg, "Gt(reg,imm)", ALU_COST, "sgt %r, %0, %1", NULL},
+    {NT_Reg, "Gt(imm,reg)", ALU_COST, "slti %r, %1, %0", NULL},
+    {NT_Reg, "Le(reg,reg)", ALU_COST, "sle %r, %0, %1", NULL},
+    {NT_Reg, "Le(reg,imm)", ALU_COST, "sle %r, %0, %1", NULL},
+    {NT_Reg, "Le(imm,reg)", ALU_COST, "sge %r, %1, %0", NULL},
+    {NT_Reg, "Ge(reg,reg)", ALU_COST, "sge %r, %0, %1", NULL},
+    {NT_Reg, "Ge(reg,imm)", ALU_COST, "sge %r, %0, %1", NULL},
+    {NT_Reg, "Ge(imm,reg)", ALU_COST, "sle %r, %1, %0", NULL},
+    {NT_Reg, "Eq(reg,reg)", ALU_COST, "seq %r, %0, %1", NULL},
+    {NT_Reg, "Eq(reg,imm)", ALU_COST, "seq %r, %0, %1", NULL},
+    {NT_Reg, "Eq(imm,reg)", ALU_COST, "seq %r, %1, %0", NULL},
+    {NT_Reg, "Ne(reg,reg)", ALU_COST, "sne %r, %0, %1", NULL},
+    {NT_Reg, "Ne(reg,imm)", ALU_COST, "sne %r, %0, %1", NULL},
+    {NT_Reg, "Ne(imm,reg)", ALU_COST, "sne %r, %1, %0", NULL},
+
+    // Array elements are addressed as symbol+offset, off the scaled index
+    // in $t9 when it is not constant; a constant added to the index folds
+    // into the offset
+    {NT_Addr, "Index(sym,off)", 0, NULL, "%0%1"},
+    {NT_Addr, "Index(sym,reg)", ALU_COST, "sll $t9, %1, 2", "%0($t9)"},
+    {NT_Addr, "Index(sym,Add(reg,off))", ALU_COST, "sll $t9, %1, 2", "%0%2($t9)"},
+    {NT_Addr, "Index(sym,Add(off,reg))", ALU_COST, "sll $t9, %2, 2", "%0%1($t9)"},
+    {NT_Addr, "Index(sym,Sub(reg,noff))", ALU_COST, "sll $t9, %1, 2", "%0%2($t9)"},
+    {NT_Reg, "Load(addr)", LOAD_COST, "lw %r, %0", NULL},
+
+    // Statements
+    {NT_Stmt, "Set(reg)", 0, NULL, NULL},
+    {NT_Stmt, "Store(reg,addr)", STORE_COST, "sw %0, %1", NULL},
+    {NT_Stmt, "Branch(reg)", BRANCH_COST, "beqz %0, %l", NULL},
+    {NT_Stmt, "Branch(Eq(reg,reg))", BRANCH_COST, "bne %0, %1, %l", NULL},
+    {NT_Stmt, "Branch(Eq(reg,imm))", BRANCH_COST, "bne %0, %1, %l", NULL},
+    {NT_Stmt, "Branch(Ne(reg,reg))", BRANCH_COST, "beq %0, %1, %l", NULL},
+    {NT_Stmt, "Branch(Ne(reg,imm))", BRANCH_COST, "beq %0, %1, %l", NULL},
+};
+#define RULE_COUNT (int)(sizeof(rules) / sizeof(rules[0]))
+
+// Patterns are compiled once into prefix order
+#define MAX_PATTERN_ITEMS 16
+#define MAX_BINDINGS 4
+
+typedef struct
+{
+    bool isNonterminal;
+    int value; // TreeOp or Nonterminal
+    int arity;
+} PatternItem;
+
+static PatternItem patterns[RULE_COUNT][MAX_PATTERN_ITEMS];
+static bool patternsCompiled = false;
+
+typedef struct TreeNode
+{
+    TreeOp op;
+    const char *name; // Variable, Constant and Array leaves
+    long value;       // Constant leaves
+    struct TreeNode *kids[2];
+    int cost[NT_Count];
+    int rule[NT_Count];      // Index into rules, or SUPEROPT_CHOICE(index)
+    const char *allocated;   // Register allocated for the node's value
+    char text[64];           // Operand the node was reduced to
+} TreeNode;
+
+#define SUPEROPT_CHOICE(index) (-2 - (index))
+#define LEAF_CHOICE -1
+
+#define MAX_TREE_NODES (SELECTOR_MAX_WINDOW * 6)
+static TreeNode nodes[MAX_TREE_NODES];
+static int nodeCount;
+
+// ---- Patterns ----
+
+static int compileItems(const char **text, PatternItem *items, int count, const char *pattern)
+{
+    const char *start = *text;
+    while (isalpha((unsigned char)**text))
+        (*text)++;
+    int length = (int)(*text - start);
+    if (count == MAX_PATTERN_ITEMS || length == 0)
+    {
+        fprintf(stderr, "Error: Bad selector pattern '%s'\n", pattern);
+        exit(1);
+    }
+
+    PatternItem *item = &items[count++];
+    item->arity = 0;
+    item->isNonterminal = islower((unsigned char)start[0]);
+    item->value = -1;
+    const char **names = item->isNonterminal ? nonterminalNames : treeOpNames;
+    int nameCount = item->isNonterminal ? NT_Count : Tree_OpCount;
+    for (int i = 0; i < nameCount; i++)
+    {
+        if ((int)strlen(names[i]) == length && strncmp(names[i], start, length) == 0)
+            item->value = i;
+    }
+    if (item->value < 0)
+    {
+        fprintf(stderr, "Error: Unknown name in selector pattern '%s'\n", pattern);
+        exit(1);
+    }
+
+    if (**text == '(')
+    {
+        do
+        {
+            (*text)++;
+            item->arity++;
+            count = compileItems(text, items, count, pattern);
+        } while (**text == ',');
+        if (**text != ')')
+        {
+            fprintf(stderr, "Error: Bad selector pattern '%s'\n", pattern);
+            exit(1);
+        }
+        (*text)++;
+    }
+    return count;
+}
+
+static void compilePatterns()
+{
+    for (int r = 0; r < RULE_COUNT; r++)
+    {
+        const char *text = rules[r].pattern;
+        compileItems(&text, patterns[r], 0, rules[r].pattern);
+    }
+    patternsCompiled = true;
+}
+
+// Match the pattern items from *position against node, collecting the
+// nodes bound to nonterminals and adding their costs
+static bool matchPattern(const PatternItem *items, int *position, TreeNode *node,
+                         TreeNode **bound, Nonterminal *boundAs, int *boundCount, int *cost)
+{
+    const PatternItem *item = &items[(*position)++];
+    if (item->isNonterminal)
+    {
+        if (node->cost[item->value] >= INFINITE_COST || *boundCount == MAX_BINDINGS)
+            return false;
+        *cost += node->cost[item->value];
+        bound[*boundCount] = node;
+        boundAs[*boundCount] = (Nonterminal)item->value;
+        (*boundCount)++;
+        return true;
+    }
+    if (node->op != (TreeOp)item->value)
+        return false;
+    for (int k = 0; k < item->arity; k++)
+    {
+        if (!matchPattern(items, position, node->kids[k], bound, boundAs, boundCount, cost))
+            return false;
+    }
+    return true;
+}
+
+// ---- Trees ----
+
+static TreeNode *newNode(TreeOp op, TreeNode *left, TreeNode *right)
+{
+    TreeNode *node = &nodes[nodeCount++];
+    memset(node, 0, sizeof(TreeNode));
+    node->op = op;
+    node->kids[0] = left;
+    node->kids[1] = right;
+    return node;
+}
+
+static TreeNode *newLeaf(TreeOp op, const char *name)
+{
+    TreeNode *node = newNode(op, NULL, NULL);
+    node->name = name;
+    if (op == Tree_Constant)
+        node->value = strtol(name, NULL, 10);
+    return node;
+}
+
+// Tree for an operand: the window so far if it computes the operand
+static TreeNode *operandTree(const char *operand, TreeNode *carried, const char *carriedName)
+{
+    if (carried != NULL && strcmp(operand, carriedName) == 0)
+        return carried;
+    return newLeaf(isConstant(operand) ? Tree_Constant : Tree_Variable, operand);
+}
+
+static int binaryTreeOp(const char *op)
+{
+    for (int i = 0; i < BINARY_OPERATOR_COUNT; i++)
+    {
+        if (strcmp(op, binaryOperators[i]) == 0)
+            return Tree_Add + i;
+    }
+    return -1;
+}
+
+// Instructions whose value can feed the next one inside a tree
+static bool isValueInstruction(const char *op)
+{
+    return binaryTreeOp(op) >= 0 || strcmp(op, "=") == 0 || strcmp(op, "=[]") == 0;
+}
+
+static bool isSelectable(const char *op)
+{
+    return isValueInstruction(op) || strcmp(op, "[]=") == 0 || strcmp(op, "ifFalse") == 0;
+}
+
+// Float comparisons need the coprocessor compare, which the patterns lack
+static bool isFloatComparison(TAC *instr, SymbolTable *symTab)
+{
+    return getComparisonInstruction(instr->op) != NULL &&
+           (isFloatOperand(instr->arg1, symTab) || isFloatOperand(instr->arg2, symTab));
+}
+
+// Value computed by a value instruction
+static TreeNode *valueTree(TAC *instr, TreeNode *carried, const char *carriedName)
+{
+    if (strcmp(instr->op, "=") == 0)
+        return operandTree(instr->arg1, carried, carriedName);
+    if (strcmp(instr->op, "=[]") == 0)
+    {
+        TreeNode *address = newNode(Tree_Index, newLeaf(Tree_Array, instr->arg1),
+                                    operandTree(instr->arg2, carried, carriedName));
+        return newNode(Tree_Load, address, NULL);
+    }
+    return newNode((TreeOp)binaryTreeOp(instr->op), operandTree(instr->arg1, carried, carriedName),
+                   operandTree(instr->arg2, carried, carriedName));
+}
+
+// Root of the tree for the last instruction of a window
+static TreeNode *rootTree(TAC *instr, TreeNode *carried, const char *carriedName)
+{
+    if (strcmp(instr->op, "[]=") == 0)
+    {
+        TreeNode *address = newNode(Tree_Index, newLeaf(Tree_Array, instr->result),
+                                    operandTree(instr->arg1, carried, carriedName));
+        return newNode(Tree_Store, operandTree(instr->arg2, carried, carriedName), address);
+    }
+    if (strcmp(instr->op, "ifFalse") == 0)
+        return newNode(Tree_Branch, operandTree(instr->arg1, carried, carriedName), NULL);
+    return newNode(Tree_Set, valueTree(instr, carried, carriedName), NULL);
+}
+
+// Whether instr's result can be folded into next: a temporary that is not
+// in a register, read exactly once by next and never again
+static bool foldsIntoNext(TAC *instr, SymbolTable *symTab)
+{
+    TAC *next = instr->next;
+    const char *result = instr->result;
+    if (!isValueInstruction(instr->op) || result == NULL || !isTemporaryVariable(result) ||
+        next == NULL || next->op == NULL || !isSelectable(next->op) || isFloatComparison(next, symTab) ||
+        isVariableInRegisterMap(result))
+        return false;
+    int reads = (next->arg1 != NULL && strcmp(next->arg1, result) == 0) +
+                (next->arg2 != NULL && strcmp(next->arg2, result) == 0);
+    if (reads != 1 || (next->result != NULL && strcmp(next->result, result) == 0))
+        return false;
+    return !isVariableUsedLater(next, result);
+}
+
+static bool treeReads(TreeNode *node, const char *variable)
+{
+    if (node == NULL)
+        return false;
+    if (node->op == Tree_Variable)
+        return strcmp(node->name, variable) == 0;
+    return treeReads(node->kids[0], variable) || treeReads(node->kids[1], variable);
+}
+
+// ---- Labelling ----
+
+static bool fitsImmediate(long value)
+{
+    return value >= -32768 && value <= 32767;
+}
+
+static void labelLeaf(TreeNode *node)
+{
+    if (node->op == Tree_Array)
+    {
+        node->cost[NT_Symbol] = 0;
+    }
+    else if (node->op == Tree_Variable)
+    {
+        node->cost[NT_Reg] = isVariableInRegisterMap(node->name) ? 0 : LOAD_COST;
+    }
+    else
+    {
+        long value = node->value;
+        if (fitsImmediate(value))
+            node->cost[NT_Imm] = 0;
+        if (fitsImmediate(-value))
+            node->cost[NT_NegImm] = 0;
+        if (fitsImmediate(value * 4))
+            node->cost[NT_Offset] = 0;
+        if (fitsImmediate(-value * 4))
+            node->cost[NT_NegOffset] = 0;
+        // Zero is $zero; other constants need an li unless one is still loaded
+        node->cost[NT_Reg] = value == 0 || isVariableInRegisterMap(node->name) ? 0 : ALU_COST;
+    }
+    for (int nt = 0; nt < NT_Count; nt++)
+        node->rule[nt] = LEAF_CHOICE;
+}
+
+static bool isCommutative(TreeOp op)
+{
+    return op == Tree_Add || op == Tree_Mul || op == Tree_Eq || op == Tree_Ne;
+}
+
+// The input of a superoptimizer rule whose window ends at node, or NULL if
+// the rule does not match. The window's intermediate values must be
+// interior nodes, which the tree guarantees.
+static TreeNode *matchSuperoptRule(const SuperoptRule *rule, TreeNode *node, SymbolTable *symTab)
+{
+    for (int i = rule->windowLength - 1; i >= 0; i--)
+    {
+        const SuperoptTACStep *step = &rule->window[i];
+        if (node->op < Tree_Add || node->op > Tree_Ne || strcmp(binaryOperators[node->op - Tree_Add], step->op) != 0)
+            return NULL;
+        TreeNode *source = NULL;
+        for (int side = 0; side < 2 && source == NULL; side++)
+        {
+            // side is the position of the constant
+            if ((side == 0) != step->constantFirst && !isCommutative(node->op))
+                continue;
+            TreeNode *constant = node->kids[side];
+            if (constant->op == Tree_Constant && constant->value == step->constant)
+                source = node->kids[1 - side];
+        }
+        if (source == NULL)
+            return NULL;
+        node = source;
+    }
+    if (node->cost[NT_Reg] >= INFINITE_COST ||
+        node->op == Tree_Constant || (node->op == Tree_Variable && !isIntegerOperand(node->name, symTab)))
+        return NULL;
+    return node;
+}
+
+static void labelNode(TreeNode *node, SymbolTable *symTab)
+{
+    for (int nt = 0; nt < NT_Count; nt++)
+        node->cost[nt] = INFINITE_COST;
+    if (node->kids[0] == NULL)
+    {
+        labelLeaf(node);
+        return;
+    }
+    for (int k = 0; k < 2 && node->kids[k] != NULL; k++)
+        labelNode(node->kids[k], symTab);
+
+    for (int r = 0; r < RULE_COUNT; r++)
+    {
+        if (patterns[r][0].value != (int)node->op)
+            continue;
+        TreeNode *bound[MAX_BINDINGS];
+        Nonterminal boundAs[MAX_BINDINGS];
+        int position = 0, boundCount = 0, cost = rules[r].cost;
+        if (matchPattern(patterns[r], &position, node, bound, boundAs, &boundCount, &cost) &&
+            cost < node->cost[rules[r].lhs])
+        {
+            node->cost[rules[r].lhs] = cost;
+            node->rule[rules[r].lhs] = r;
+        }
+    }
+
+    // The superoptimizer's sequences are tiles for chains of constant operations
+    if (node->op >= Tree_Add && node->op <= Tree_Ne)
+    {
+        for (int r = 0; r < superoptRuleCount; r++)
+        {
+            const SuperoptRule *rule = &superoptRules[r];
+            if (rule->cost >= node->cost[NT_Reg])
+                continue;
+            TreeNode *input = matchSuperoptRule(rule, node, symTab);
+            if (input != NULL && rule->cost + input->cost[NT_Reg] < node->cost[NT_Reg])
+            {
+                node->cost[NT_Reg] = rule->cost + input->cost[NT_Reg];
+                node->rule[NT_Reg] = SUPEROPT_CHOICE(r);
+            }
+        }
+    }
+}
+
+// ---- Reduction ----
+
+// Expand a code or operand template
+static void expandTemplate(char *buffer, size_t size, const char *template, const char *result,
+                           TreeNode **bound, const char *label)
+{
+    size_t length = 0;
+    for (const char *p = template; *p != '\0' && length + 1 < size; p++)
+    {
+        const char *insert = NULL;
+        char single[2] = {*p, '\0'};
+        if (*p == '%' && p[1] == 'r')
+            insert = result;
+        else if (*p == '%' && p[1] == 'l')
+            insert = label;
+        else if (*p == '%' && p[1] >= '0' && p[1] <= '9')
+            insert = bound[p[1] - '0']->text;
+        else if (*p == '\n')
+            insert = "\n\t";
+        else
+            insert = single;
+        if (*p == '%')
+            p++;
+        length += snprintf(buffer + length, size - length, "%s", insert);
+    }
+    buffer[length < size ? length : size - 1] = '\0';
+}
+
+static void emitCode(const char *template, const char *result, TreeNode **bound, const char *label)
+{
+    char code[256];
+    expandTemplate(code, sizeof(code), template, result, bound, label);
+    fprintf(codeGeneratorOutput(), "\t%s\n", code);
+}
+
+// Register for a computed value: the hint, or a fresh one
+static const char *resultRegister(TreeNode *node, const char *hint)
+{
+    if (hint != NULL)
+        return hint;
+    const char *reg = allocateRegister();
+    if (!reg)
+    {
+        fprintf(stderr, "Error: No available registers for an intermediate value\n");
+        abortCompilation();
+    }
+    node->allocated = reg;
+    return reg;
+}
+
+static void releaseAllocated(TreeNode *node)
+{
+    if (node->allocated != NULL)
+    {
+        deallocateRegister(node->allocated);
+        node->allocated = NULL;
+    }
+}
+
+static void reduceLeaf(TreeNode *node, Nonterminal nt, const char *hint)
+{
+    const char *reg = NULL;
+    switch (nt)
+    {
+    case NT_Symbol:
+        snprintf(node->text, sizeof(node->text), "%s", node->name);
+        return;
+    case NT_Imm:
+        snprintf(node->text, sizeof(node->text), "%ld", node->value);
+        return;
+    case NT_NegImm:
+        snprintf(node->text, sizeof(node->text), "%ld", -node->value);
+        return;
+    case NT_Offset:
+        snprintf(node->text, sizeof(node->text), "%+ld", node->value * 4);
+        return;
+    case NT_NegOffset:
+        snprintf(node->text, sizeof(node->text), "%+ld", -node->value * 4);
+        return;
+    default:
+        break;
+    }
+
+    // Register operands stay where they are; new values go to the hint
+    if (node->op == Tree_Constant && node->value == 0)
+        reg = "$zero";
+    else if (isVariableInRegisterMap(node->name))
+        reg = getRegisterForVariable(node->name);
+    else if (hint != NULL)
+    {
+        loadOperand(node->name, hint);
+        reg = hint;
+    }
+    else
+        reg = getOperandRegister(node->name);
+    snprintf(node->text, sizeof(node->text), "%s", reg);
+}
+
+static void reduce(TreeNode *node, Nonterminal nt, const char *hint, SymbolTable *symTab);
+
+static void reduceSuperopt(TreeNode *node, const SuperoptRule *rule, const char *hint, SymbolTable *symTab)
+{
+    TreeNode *input = matchSuperoptRule(rule, node, symTab);
+    reduce(input, NT_Reg, NULL, symTab);
+    const char *result = resultRegister(node, hint);
+    for (int i = 0; i < rule->sequenceLength; i++)
+    {
+        const SuperoptMipsStep *step = &rule->sequence[i];
+        SuperoptOperand operands[2] = {step->source1, step->source2};
+        char sources[2][64];
+        for (int j = 0; j < 2; j++)
+        {
+            if (operands[j] == SuperoptOperand_Input)
+                snprintf(sources[j], sizeof(sources[j]), "%s", input->text);
+            else if (operands[j] == SuperoptOperand_Previous)
+                snprintf(sources[j], sizeof(sources[j]), "%s", result);
+            else if (operands[j] == SuperoptOperand_Zero)
+                snprintf(sources[j], sizeof(sources[j]), "$zero");
+            else
+                snprintf(sources[j], sizeof(sources[j]), "%d", step->immediate);
+        }
+        fprintf(codeGeneratorOutput(), "\t%s %s, %s, %s\n", step->mnemonic, result, sources[0], sources[1]);
+    }
+    releaseAllocated(input);
+    snprintf(node->text, sizeof(node->text), "%s", result);
+}
+
+// Bind a rule's nonterminals at node again for reduction
+static int bindRule(int r, TreeNode *node, TreeNode **bound, Nonterminal *boundAs)
+{
+    int position = 0, boundCount = 0, cost = 0;
+    matchPattern(patterns[r], &position, node, bound, boundAs, &boundCount, &cost);
+    return boundCount;
+}
+
+// Emit the code for node as nonterminal nt and leave the operand that
+// holds it in node->text. A register value goes to hint if one is given.
+static void reduce(TreeNode *node, Nonterminal nt, const char *hint, SymbolTable *symTab)
+{
+    int r = node->rule[nt];
+    if (r == LEAF_CHOICE)
+    {
+        reduceLeaf(node, nt, hint);
+        return;
+    }
+    if (r <= SUPEROPT_CHOICE(0))
+    {
+        reduceSuperopt(node, &superoptRules[SUPEROPT_CHOICE(0) - r], hint, symTab);
+        return;
+    }
+
+    TreeNode *bound[MAX_BINDINGS];
+    Nonterminal boundAs[MAX_BINDINGS];
+    int boundCount = bindRule(r, node, bound, boundAs);
+    for (int i = 0; i < boundCount; i++)
+        reduce(bound[i], boundAs[i], NULL, symTab);
+
+    // Every rule reads its operands before writing %r, so the result can
+    // take over an intermediate operand's register
+    const char *result = "";
+    if (nt == NT_Reg)
+    {
+        for (int i = 0; i < boundCount && hint == NULL && node->allocated == NULL; i++)
+        {
+            node->allocated = bound[i]->allocated;
+            bound[i]->allocated = NULL;
+        }
+        result = node->allocated != NULL ? node->allocated : resultRegister(node, hint);
+    }
+    if (rules[r].code != NULL)
+        emitCode(rules[r].code, result, bound, "");
+    for (int i = 0; i < boundCount; i++)
+        releaseAllocated(bound[i]);
+
+    if (nt == NT_Addr)
+        expandTemplate(node->text, sizeof(node->text), rules[r].operand, result, bound, "");
+    else
+        snprintf(node->text, sizeof(node->text), "%s", result);
+}
+
+// Whether a value tree yields the bits of a float: an element of a float
+// array, or an operand that holds a float
+static bool isFloatValue(TreeNode *value, SymbolTable *symTab)
+{
+    if (value->op == Tree_Load && value->kids[0]->kids[0]->op == Tree_Array)
+    {
+        Symbol *array = findSymbol(symTab, value->kids[0]->kids[0]->name);
+        return array != NULL && array->arrayInfo != NULL && array->arrayInfo->isFloat;
+    }
+    return value->op == Tree_Variable && isFloatOperand(value->name, symTab);
+}
+
+// Reduce a root. Branch operands are computed into the reserved registers,
+// since every register is written back before the jump.
+static void reduceRoot(TreeNode *root, TAC *last, SymbolTable *symTab)
+{
+    int r = root->rule[NT_Stmt];
+    if (r < 0)
+    {
+        fprintf(stderr, "Error: No instruction selector rule covers '%s'\n", last->op);
+        abortCompilation();
+    }
+    TreeNode *bound[MAX_BINDINGS];
+    Nonterminal boundAs[MAX_BINDINGS];
+    int boundCount = bindRule(r, root, bound, boundAs);
+
+    if (root->op == Tree_Set)
+    {
+        // Reuse the result's register unless the tree still reads the old
+        // value; otherwise a computed value keeps the register it was built
+        // in, and a leaf is loaded straight into a fresh one
+        TreeNode *value = bound[0];
+        const char *current = getRegisterForVariable(last->result);
+        char oldReg[64], dest[64] = "";
+        bool reuse = current != NULL && !treeReads(root, last->result);
+        bool isLeaf = value->kids[0] == NULL;
+        bool holdsFloat = isFloatValue(value, symTab);
+        if (reuse)
+        {
+            snprintf(dest, sizeof(dest), "%s", current);
+        }
+        else if (isLeaf)
+        {
+            const char *fresh = allocateRegister();
+            if (!fresh)
+            {
+                fprintf(stderr, "Error: No available registers for result %s\n", last->result);
+                abortCompilation();
+            }
+            snprintf(dest, sizeof(dest), "%s", fresh);
+        }
+
+        reduce(value, NT_Reg, dest[0] != '\0' ? dest : NULL, symTab);
+        if (dest[0] == '\0')
+        {
+            // Adopt the register the value was computed in
+            snprintf(dest, sizeof(dest), "%s", value->text);
+            value->allocated = NULL;
+        }
+        else if (strcmp(value->text, dest) != 0)
+        {
+            // The value may still be in a float register
+            moveRegister(dest, value->text);
+        }
+
+        if (!reuse)
+        {
+            // Reading the tree may have loaded the old value into a register
+            current = getRegisterForVariable(last->result);
+            if (current != NULL)
+            {
+                snprintf(oldReg, sizeof(oldReg), "%s", current);
+                removeVariableFromRegisterMap(last->result);
+                releaseRegister(oldReg);
+            }
+            setRegisterForVariable(last->result, dest);
+        }
+        setFloatBitsForVariable(last->result, holdsFloat);
+        return;
+    }
+
+    if (root->op == Tree_Branch)
+    {
+        static const char *branchRegisters[2] = {BASE_ADDRESS_REGISTER, ADDRESS_CALC_REGISTER};
+        for (int i = 0; i < boundCount; i++)
+        {
+            const char *hint = boundAs[i] == NT_Reg ? branchRegisters[2 - boundCount + i] : NULL;
+            reduce(bound[i], boundAs[i], hint, symTab);
+            releaseAllocated(bound[i]);
+        }
+        spillAllRegisters();
+        emitCode(rules[r].code, "", bound, last->result);
+        return;
+    }
+
+    for (int i = 0; i < boundCount; i++)
+        reduce(bound[i], boundAs[i], NULL, symTab);
+    // A float still in its floating-point register is stored from there
+    bool floatStore = root->op == Tree_Store && strncmp(bound[0]->text, "$f", 2) == 0;
+    emitCode(floatStore ? "s.s %0, %1" : rules[r].code, "", bound, "");
+    for (int i = 0; i < boundCount; i++)
+        releaseAllocated(bound[i]);
+}
+
+static const char *describeInstruction(TAC *instr)
+{
+    if (strcmp(instr->op, "=") == 0)
+        return "assignment";
+    if (strcmp(instr->op, "=[]") == 0)
+        return "array access";
+    if (strcmp(instr->op, "[]=") == 0)
+        return "array assignment";
+    if (strcmp(instr->op, "ifFalse") == 0)
+        return "conditional branch";
+    return NULL;
+}
+
+TAC *selectMIPSInstructions(TAC *current, SymbolTable *symTab)
+{
+    if (!isSelectable(current->op) || isFloatComparison(current, symTab))
+        return NULL;
+    if (!patternsCompiled)
+        compilePatterns();
+
+    // Grow the window while each result feeds only the next instruction
+    TAC *last = current;
+    int length = 1;
+    while (length < SELECTOR_MAX_WINDOW && foldsIntoNext(last, symTab))
+    {
+        last = last->next;
+        length++;
+    }
+    protectWindowOperands(last);
+
+    // Each instruction's tree takes the previous one's in place of its result
+    nodeCount = 0;
+    TreeNode *tree = NULL;
+    const char *carriedName = NULL;
+    for (TAC *instr = current; instr != last; instr = instr->next)
+    {
+        tree = valueTree(instr, tree, carriedName);
+        carriedName = instr->result;
+    }
+    TreeNode *root = rootTree(last, tree, carriedName);
+    labelNode(root, symTab);
+
+    FILE *out = codeGeneratorOutput();
+    const char *description = describeInstruction(last);
+    if (description != NULL)
+        fprintf(out, "# Generating MIPS code for %s", description);
+    else
+        fprintf(out, "# Generating MIPS code for operation %s", last->op);
+    if (length > 1)
+        fprintf(out, " (%d TAC instructions)", length);
+    fprintf(out, "\n");
+
+    reduceRoot(root, last, symTab);
+    return last;
+}
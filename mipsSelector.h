@@ -0,0 +1,24 @@
+// mipsSelector.h
+
+#ifndef MIPS_SELECTOR_H
+#define MIPS_SELECTOR_H
+
+#include "semantic.h"
+#include "SymbolTable.h"
+
+// Tree-pattern instruction selector for the MIPS backend. A window of TAC
+// in which each instruction's result is a temporary read only by the next
+// is combined into one expression tree, labelled bottom-up with the
+// cheapest rule of a cost table for every nonterminal (BURS-style dynamic
+// programming), and reduced top-down to code. Rules fold constants into
+// immediates and array elements into symbol+offset addresses; the
+// superoptimizer's rules (superopt.h) take part as further tiles.
+#define SELECTOR_MAX_WINDOW 4
+
+// Lower the integer arithmetic, comparison, assignment, array and
+// conditional-branch instructions starting at current. Returns the last
+// instruction translated, or NULL if current is not one the selector
+// handles.
+TAC *selectMIPSInstructions(TAC *current, SymbolTable *symTab);
+
+#endif // MIPS_SELECTOR_H
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simulator.h"
+
+// Standalone MIPS simulator for the code the compiler generates: runs an
+// assembly file and reports instruction counts by class, memory traffic and
+// cycles under a configurable pipeline cost model.
+//
+// Usage: ./mipsim [-q] [-n steps] [-m model] [-c name=value]... [file]
+//
+// The file defaults to output.asm. Program output goes to stdout and the
+// report to stderr. -m reads "name = value" lines from a cost model file and
+// -c overrides a single parameter; the parameters are alu, load, mul, div,
+// fpadd, fpmul, fpdiv, fpmove (latencies in cycles), branch (taken branch
+// penalty), syscall and depth (pipeline stages). -q discards the program's
+// output and -n caps the number of instructions executed.
+
+#define DEFAULT_MAX_STEPS 100000000LL
+
+static void usage()
+{
+    fprintf(stderr, "Usage: ./mipsim [-q] [-n steps] [-m model] [-c name=value]... [file]\n");
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "output.asm";
+    long long maxSteps = DEFAULT_MAX_STEPS;
+    bool quiet = false;
+
+    CostModel model;
+    defaultCostModel(&model);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+        {
+            quiet = true;
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            maxSteps = atoll(argv[++i]);
+            if (maxSteps <= 0)
+                usage();
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            if (!loadCostModel(&model, argv[++i]))
+                return 1;
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            char name[64];
+            int value;
+            if (sscanf(argv[++i], "%63[^=]=%d", name, &value) != 2 || !setCostParameter(&model, name, value))
+            {
+                fprintf(stderr, "Error: Bad cost parameter '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage();
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    MipsProgram *program = assembleMipsFile(path);
+    if (program == NULL)
+        return 1;
+
+    SimulatorStats stats;
+    bool ok = runMipsProgram(program, &model, quiet ? NULL : stdout, maxSteps, &stats);
+    fflush(stdout);
+
+    fprintf(stderr, "File:            %s\n", path);
+    printSimulatorStats(stderr, &stats);
+
+    freeMipsProgram(program);
+    return ok ? 0 : 1;
+}
@@ -1,23 +1,39 @@
 #include "optimizer.h"
 #include "utils.h"
+#include "cfg.h"
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 
-void optimizeTAC(TAC **head)
+// Set while optimizing a streamed window that more code follows: values
+// live at the end of the list may still be read by a later window
+static bool codeFollows = false;
+
+void optimizeTAC(TAC **head, SymbolTable *symTab)
 {
     printf("run optimizer\n");
-    int changes;
-    do
-    {
-        changes = 0;
-        changes += constantFolding(head);
-        changes += constantPropagation(head);
-        changes += copyPropagation(head);
-        changes += deadCodeElimination(head);
-    } while (changes > 0);
+    runPassPipeline(head, symTab, 0);
+}
+
+void optimizeTACWindow(TAC **head, SymbolTable *symTab, bool firstWindow, bool lastWindow)
+{
+    printf("run optimizer on window\n");
+
+    // Windows end between top-level statements, so no branch crosses one.
+    // Scalar replacement needs every access to an array and is skipped;
+    // dead stores are only judged against the end of the program, and
+    // only the first window starts from the zero-filled memory image.
+    int skipFlags = PASS_WHOLE_PROGRAM;
+    if (!lastWindow)
+        skipFlags |= PASS_PROGRAM_END;
+    if (!firstWindow)
+        skipFlags |= PASS_PROGRAM_START;
+    codeFollows = !lastWindow;
+    runPassPipeline(head, symTab, skipFlags);
+    codeFollows = false;
 }
 
 // Constant Folding Optimization
@@ -29,8 +45,7 @@ int constantFolding(TAC **head)
 
     while (current != NULL)
     {
-        if (current->op != NULL && (strcmp(current->op, "+") == 0 || strcmp(current->op, "-") == 0 ||
-                                    strcmp(current->op, "*") == 0 || strcmp(current->op, "/") == 0))
+        if (current->op != NULL && isIntegerBinaryOp(current->op))
         {
             // If both operands are constants
             if (isConstant(current->arg1) && isConstant(current->arg2))
@@ -39,30 +54,11 @@ int constantFolding(TAC **head)
                 int operand2 = atoi(current->arg2);
                 int result = 0;
 
-                if (strcmp(current->op, "+") == 0)
-                {
-                    result = operand1 + operand2;
-                }
-                else if (strcmp(current->op, "-") == 0)
+                if (!evaluateIntegerOp(current->op, operand1, operand2, &result))
                 {
-                    result = operand1 - operand2;
-                }
-                else if (strcmp(current->op, "*") == 0)
-                {
-                    result = operand1 * operand2;
-                }
-                else if (strcmp(current->op, "/") == 0)
-                {
-                    if (operand2 != 0)
-                    {
-                        result = operand1 / operand2;
-                    }
-                    else
-                    {
-                        fprintf(stderr, "Error: Division by zero\n");
-                        current = current->next;
-                        continue;
-                    }
+                    fprintf(stderr, "Error: Division by zero\n");
+                    current = current->next;
+                    continue;
                 }
 
                 char resultStr[20];
@@ -106,6 +102,9 @@ int constantPropagation(TAC **head)
                 TAC *temp = current->next;
                 while (temp != NULL)
                 {
+                    // Other paths may reach a label with a different value
+                    if (isLabel(temp))
+                        break;
                     if (temp->result != NULL && strcmp(temp->result, varName) == 0)
                     {
                         // Variable is redefined
@@ -123,6 +122,9 @@ int constantPropagation(TAC **head)
                         temp->arg2 = strdup(constValue);
                         changes++;
                     }
+                    // Stop at the end of the basic block
+                    if (isBranch(temp))
+                        break;
                     temp = temp->next;
                 }
             }
@@ -142,8 +144,8 @@ int copyPropagation(TAC **head)
     {
         if (current->op != NULL && strcmp(current->op, "=") == 0)
         {
-            // Check if arg1 is a variable
-            if (isVariable(current->arg1))
+            // Check if arg1 is a variable; a self-copy has nothing to propagate
+            if (isVariable(current->arg1) && strcmp(current->arg1, current->result) != 0)
             {
                 // Propagate the variable value to all uses of the variable until it's redefined
                 char *sourceVar = current->arg1;
@@ -151,11 +153,9 @@ int copyPropagation(TAC **head)
                 TAC *temp = current->next;
                 while (temp != NULL)
                 {
-                    if (temp->result != NULL && strcmp(temp->result, destVar) == 0)
-                    {
-                        // Variable is redefined
+                    // Other paths may reach a label with a different value
+                    if (isLabel(temp))
                         break;
-                    }
                     if (temp->arg1 != NULL && strcmp(temp->arg1, destVar) == 0)
                     {
                         free(temp->arg1);
@@ -168,6 +168,15 @@ int copyPropagation(TAC **head)
                         temp->arg2 = strdup(sourceVar);
                         changes++;
                     }
+                    if (temp->result != NULL && (strcmp(temp->result, destVar) == 0 ||
+                                                 strcmp(temp->result, sourceVar) == 0))
+                    {
+                        // Either side of the copy is redefined
+                        break;
+                    }
+                    // Stop at the end of the basic block
+                    if (isBranch(temp))
+                        break;
                     temp = temp->next;
                 }
             }
@@ -210,6 +219,13 @@ int deadCodeElimination(TAC **head)
                     isUsed = 1;
                     break;
                 }
+                // Control may leave the block or loop back; assume it is used,
+                // unless it is a temporary, which never outlives its block
+                if (isControlFlow(temp))
+                {
+                    isUsed = !isVirtualRegister(current->result);
+                    break;
+                }
                 // If the variable is redefined
                 if (temp->result != NULL && strcmp(temp->result, current->result) == 0)
                 {
@@ -217,6 +233,11 @@ int deadCodeElimination(TAC **head)
                 }
                 temp = temp->next;
             }
+            // A later window may still read a variable left live at the end
+            if (temp == NULL && codeFollows && !isVirtualRegister(current->result))
+            {
+                isUsed = 1;
+            }
             if (!isUsed)
             {
                 // Remove current instruction from the linked list
@@ -237,15 +258,7 @@ int deadCodeElimination(TAC **head)
                 current = current->next;
 
                 // Free the memory allocated for the instruction
-                if (toDelete->op)
-                    free(toDelete->op);
-                if (toDelete->arg1)
-                    free(toDelete->arg1);
-                if (toDelete->arg2)
-                    free(toDelete->arg2);
-                if (toDelete->result)
-                    free(toDelete->result);
-                free(toDelete);
+                freeInstruction(toDelete);
 
                 changes++;
                 continue; // Skip prev update
@@ -262,12 +275,1676 @@ bool hasSideEffect(TAC *instr)
     if (instr == NULL || instr->op == NULL)
         return false;
 
-    // Instructions that modify memory or have side effects
+    // Instructions that modify memory or have side effects; dead array
+    // stores are removed separately by deadArrayStoreElimination
     if (strcmp(instr->op, "[]=") == 0) // Array assignment
         return true;
     if (strcmp(instr->op, "write") == 0) // Write operation
         return true;
+    if (isControlFlow(instr)) // Labels and branches
+        return true;
     // Add other side-effecting operations if needed
 
     return false;
 }
+
+void freeInstruction(TAC *instr)
+{
+    if (instr->op)
+        free(instr->op);
+    if (instr->arg1)
+        free(instr->arg1);
+    if (instr->arg2)
+        free(instr->arg2);
+    if (instr->result)
+        free(instr->result);
+    free(instr);
+}
+
+bool isIntegerBinaryOp(const char *op)
+{
+    return strcmp(op, "+") == 0 || strcmp(op, "-") == 0 ||
+           strcmp(op, "*") == 0 || strcmp(op, "/") == 0 ||
+           strcmp(op, "<") == 0 || strcmp(op, "<=") == 0 ||
+           strcmp(op, ">") == 0 || strcmp(op, ">=") == 0 ||
+           strcmp(op, "==") == 0 || strcmp(op, "!=") == 0;
+}
+
+// Evaluate an integer operator on constant operands; fails on division by zero
+bool evaluateIntegerOp(const char *op, int operand1, int operand2, int *result)
+{
+    if (strcmp(op, "+") == 0)
+        *result = operand1 + operand2;
+    else if (strcmp(op, "-") == 0)
+        *result = operand1 - operand2;
+    else if (strcmp(op, "*") == 0)
+        *result = operand1 * operand2;
+    else if (strcmp(op, "/") == 0)
+    {
+        if (operand2 == 0)
+            return false;
+        *result = operand1 / operand2;
+    }
+    else if (strcmp(op, "<") == 0)
+        *result = operand1 < operand2;
+    else if (strcmp(op, "<=") == 0)
+        *result = operand1 <= operand2;
+    else if (strcmp(op, ">") == 0)
+        *result = operand1 > operand2;
+    else if (strcmp(op, ">=") == 0)
+        *result = operand1 >= operand2;
+    else if (strcmp(op, "==") == 0)
+        *result = operand1 == operand2;
+    else if (strcmp(op, "!=") == 0)
+        *result = operand1 != operand2;
+    else
+        return false;
+    return true;
+}
+
+/* Sparse Conditional Constant Propagation */
+
+// Lattice value: TOP (no information yet), CONST (a known integer), BOTTOM (varies)
+typedef enum
+{
+    LATTICE_TOP,
+    LATTICE_CONST,
+    LATTICE_BOTTOM
+} LatticeKind;
+
+typedef struct
+{
+    LatticeKind kind;
+    int value;
+} LatticeValue;
+
+// Maps each variable defined in the TAC to a dense index
+typedef struct
+{
+    const char **names;
+    int *ids;
+    int capacity;
+    int count;
+} VarIndex;
+
+typedef struct
+{
+    int from; // Source block (-1 for the entry pseudo-edge)
+    int slot; // Index into the source block's successor array
+    int to;   // Destination block
+} CFGEdge;
+
+static bool definesValue(TAC *instr)
+{
+    return instr->op != NULL && instr->result != NULL &&
+           !isControlFlow(instr) && strcmp(instr->op, "[]=") != 0;
+}
+
+static int lookupVar(VarIndex *index, const char *name)
+{
+    if (name == NULL || index->capacity == 0)
+        return -1;
+    unsigned int i = hashFunction(name, index->capacity);
+    while (index->names[i] != NULL)
+    {
+        if (strcmp(index->names[i], name) == 0)
+            return index->ids[i];
+        i = (i + 1) % index->capacity;
+    }
+    return -1;
+}
+
+// False if the index cannot be allocated
+static bool buildVarIndex(VarIndex *index, TAC *head)
+{
+    size_t defs = 0;
+    for (TAC *current = head; current != NULL; current = current->next)
+    {
+        if (definesValue(current))
+            defs++;
+    }
+
+    index->capacity = 0;
+    index->count = 0;
+    index->names = NULL;
+    index->ids = NULL;
+    if (defs > (size_t)(INT_MAX - 1) / 2)
+        return false;
+    size_t capacity = defs * 2 + 1;
+    index->names = (const char **)calloc(capacity, sizeof(char *));
+    index->ids = (int *)calloc(capacity, sizeof(int));
+    if (index->names == NULL || index->ids == NULL)
+    {
+        free(index->names);
+        free(index->ids);
+        index->names = NULL;
+        index->ids = NULL;
+        return false;
+    }
+    index->capacity = (int)capacity;
+
+    for (TAC *current = head; current != NULL; current = current->next)
+    {
+        if (!definesValue(current))
+            continue;
+        unsigned int i = hashFunction(current->result, index->capacity);
+        while (index->names[i] != NULL && strcmp(index->names[i], current->result) != 0)
+        {
+            i = (i + 1) % index->capacity;
+        }
+        if (index->names[i] == NULL)
+        {
+            index->names[i] = current->result;
+            index->ids[i] = index->count++;
+        }
+    }
+    return true;
+}
+
+// SSA form of a TAC list, kept in side tables instead of being written
+// into the TAC. Every definition and every phi defines an SSA value, and
+// each read of a tracked variable records the value that reaches it, or
+// -1 where only the variable's value on entry does (which is BOTTOM).
+// Phis go only where a variable read across blocks needs one, so the
+// tables grow with the program rather than with variables times blocks.
+typedef struct
+{
+    int var;         // Variable the phi merges
+    int value;       // SSA value it defines
+    int block;       // Join block it heads
+    size_t firstArg; // Its argument from block->preds[p] is args[firstArg + p]
+} PhiNode;
+
+typedef struct
+{
+    CFG *cfg;
+    VarIndex index;
+    size_t numInstrs;
+    TAC **instrs;       // Instructions in program order
+    size_t *blockStart; // Block b holds instrs[blockStart[b]] .. instrs[blockStart[b + 1] - 1]
+    int *instrBlock;
+    int *useVar;        // Tracked variable read as arg1 and as arg2 (two per instruction, -1 if none)
+    int *useValue;      // SSA value reaching each of those reads
+    int *defValue;      // SSA value an instruction defines, or -1
+    int *defVar;
+    PhiNode *phis;
+    size_t numPhis;
+    int *args;
+    size_t *phiStart;   // Block b's phis are phiOrder[phiStart[b]] .. phiOrder[phiStart[b + 1] - 1]
+    int *phiOrder;
+    size_t numValues;   // Definitions first, then phis
+    size_t *useStart;   // Readers of value v are users[useStart[v]] .. users[useStart[v + 1] - 1]
+    int *users;         // An instruction index, or numInstrs plus a phi index
+} SSAForm;
+
+static void freeSSA(SSAForm *ssa)
+{
+    free(ssa->index.names);
+    free(ssa->index.ids);
+    free(ssa->instrs);
+    free(ssa->blockStart);
+    free(ssa->instrBlock);
+    free(ssa->useVar);
+    free(ssa->useValue);
+    free(ssa->defValue);
+    free(ssa->defVar);
+    free(ssa->phis);
+    free(ssa->args);
+    free(ssa->phiStart);
+    free(ssa->phiOrder);
+    free(ssa->useStart);
+    free(ssa->users);
+    freeCFG(ssa->cfg);
+}
+
+// Immediate dominators (Cooper, Harvey and Kennedy) over the blocks
+// reachable from the entry; idom is -1 for the others
+static bool computeDominators(CFG *cfg, int *idom, int *rpoNumber)
+{
+    int numBlocks = cfg->numBlocks;
+    int *rpo = (int *)calloc(numBlocks, sizeof(int));
+    int *stackBlock = (int *)calloc(numBlocks, sizeof(int));
+    int *stackSlot = (int *)calloc(numBlocks, sizeof(int));
+    if (rpo == NULL || stackBlock == NULL || stackSlot == NULL)
+    {
+        free(rpo);
+        free(stackBlock);
+        free(stackSlot);
+        return false;
+    }
+
+    // Depth-first postorder without recursion, reversed afterwards
+    int reachable = 0;
+    int depth = 0;
+    for (int b = 0; b < numBlocks; b++)
+    {
+        rpoNumber[b] = -1;
+        idom[b] = -1;
+    }
+    rpoNumber[0] = 0;
+    stackBlock[depth] = 0;
+    stackSlot[depth++] = 0;
+    while (depth > 0)
+    {
+        BasicBlock *block = &cfg->blocks[stackBlock[depth - 1]];
+        if (stackSlot[depth - 1] < block->numSucc)
+        {
+            int succ = block->succ[stackSlot[depth - 1]++];
+            if (rpoNumber[succ] < 0)
+            {
+                rpoNumber[succ] = 0;
+                stackBlock[depth] = succ;
+                stackSlot[depth++] = 0;
+            }
+            continue;
+        }
+        rpo[reachable++] = block->id;
+        depth--;
+    }
+    for (int i = 0; i < reachable / 2; i++)
+    {
+        int swap = rpo[i];
+        rpo[i] = rpo[reachable - 1 - i];
+        rpo[reachable - 1 - i] = swap;
+    }
+    for (int i = 0; i < reachable; i++)
+        rpoNumber[rpo[i]] = i;
+
+    idom[0] = 0;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int i = 1; i < reachable; i++)
+        {
+            BasicBlock *block = &cfg->blocks[rpo[i]];
+            int newIdom = -1;
+            for (int p = 0; p < block->numPreds; p++)
+            {
+                int other = block->preds[p];
+                if (idom[other] < 0)
+                    continue;
+                if (newIdom < 0)
+                {
+                    newIdom = other;
+                    continue;
+                }
+                // Walk both fingers up the tree until they meet
+                while (other != newIdom)
+                {
+                    while (rpoNumber[other] > rpoNumber[newIdom])
+                        other = idom[other];
+                    while (rpoNumber[newIdom] > rpoNumber[other])
+                        newIdom = idom[newIdom];
+                }
+            }
+            if (newIdom != idom[block->id])
+            {
+                idom[block->id] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    free(rpo);
+    free(stackBlock);
+    free(stackSlot);
+    return true;
+}
+
+// Append a pair to a growable array of ints; false if it cannot grow
+static bool appendPair(int **pairs, size_t *count, size_t *capacity, int first, int second)
+{
+    if (*count == *capacity)
+    {
+        size_t grown = *capacity ? *capacity * 2 : 64;
+        int *items = (int *)realloc(*pairs, grown * 2 * sizeof(int));
+        if (items == NULL)
+            return false;
+        *pairs = items;
+        *capacity = grown;
+    }
+    (*pairs)[*count * 2] = first;
+    (*pairs)[*count * 2 + 1] = second;
+    (*count)++;
+    return true;
+}
+
+// Group pairs by their first element: the second elements of the pairs
+// whose first is k end up in list[start[k]] .. list[start[k + 1] - 1]
+static bool groupPairs(const int *pairs, size_t count, size_t numKeys, size_t **start, int **list)
+{
+    *start = (size_t *)calloc(numKeys + 1, sizeof(size_t));
+    *list = (int *)calloc(count + 1, sizeof(int));
+    size_t *fill = (size_t *)calloc(numKeys + 1, sizeof(size_t));
+    if (*start == NULL || *list == NULL || fill == NULL)
+    {
+        free(fill);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+        (*start)[pairs[i * 2] + 1]++;
+    for (size_t k = 0; k < numKeys; k++)
+        (*start)[k + 1] += (*start)[k];
+    memcpy(fill, *start, numKeys * sizeof(size_t));
+    for (size_t i = 0; i < count; i++)
+        (*list)[fill[pairs[i * 2]]++] = pairs[i * 2 + 1];
+    free(fill);
+    return true;
+}
+
+// Place phis with iterated dominance frontiers (Cytron et al.) for the
+// variables read in some block before that block defines them
+static bool placePhis(SSAForm *ssa, const int *idom, const int *rpoNumber)
+{
+    CFG *cfg = ssa->cfg;
+    size_t numBlocks = cfg->numBlocks;
+    size_t numVars = ssa->index.count;
+    int *frontierPairs = NULL, *defPairs = NULL, *phiPairs = NULL;
+    size_t numFrontier = 0, frontierCapacity = 0, numDefs = 0, defCapacity = 0, phiCapacity = 0;
+    size_t *frontierStart = NULL, *defStart = NULL;
+    int *frontier = NULL, *defBlocks = NULL;
+    int *blockStamp = (int *)calloc(numBlocks, sizeof(int));
+    int *workStamp = (int *)calloc(numBlocks, sizeof(int));
+    int *work = (int *)calloc(numBlocks, sizeof(int));
+    int *varStamp = (int *)calloc(numVars + 1, sizeof(int));
+    bool *global = (bool *)calloc(numVars + 1, sizeof(bool));
+    bool ok = blockStamp != NULL && workStamp != NULL && work != NULL && varStamp != NULL && global != NULL;
+
+    // Dominance frontiers; the entry never gets phis, its values on entry
+    // are BOTTOM and so is anything merged with them
+    for (size_t b = 0; ok && b < numBlocks; b++)
+        blockStamp[b] = -1;
+    for (int b = 1; ok && b < (int)numBlocks; b++)
+    {
+        BasicBlock *block = &cfg->blocks[b];
+        if (rpoNumber[b] < 0 || block->numPreds < 2)
+            continue;
+        for (int p = 0; ok && p < block->numPreds; p++)
+        {
+            for (int runner = block->preds[p]; ok && rpoNumber[runner] >= 0 && runner != idom[b]; runner = idom[runner])
+            {
+                if (blockStamp[runner] == b)
+                    continue;
+                blockStamp[runner] = b;
+                ok = appendPair(&frontierPairs, &numFrontier, &frontierCapacity, runner, b);
+            }
+        }
+    }
+    ok = ok && groupPairs(frontierPairs, numFrontier, numBlocks, &frontierStart, &frontier);
+
+    // Blocks defining each variable, and the variables live into some block
+    for (size_t v = 0; ok && v < numVars; v++)
+        varStamp[v] = -1;
+    for (size_t i = 0; ok && i < ssa->numInstrs; i++)
+    {
+        int b = ssa->instrBlock[i];
+        for (int k = 0; k < 2; k++)
+        {
+            int var = ssa->useVar[i * 2 + k];
+            if (var >= 0 && varStamp[var] != b)
+                global[var] = true;
+        }
+        int var = ssa->defVar[i];
+        if (var >= 0 && varStamp[var] != b)
+        {
+            varStamp[var] = b;
+            ok = appendPair(&defPairs, &numDefs, &defCapacity, var, b);
+        }
+    }
+    ok = ok && groupPairs(defPairs, numDefs, numVars, &defStart, &defBlocks);
+
+    for (size_t b = 0; ok && b < numBlocks; b++)
+        blockStamp[b] = workStamp[b] = -1;
+    for (int v = 0; ok && v < (int)numVars; v++)
+    {
+        if (!global[v])
+            continue;
+        size_t numWork = 0;
+        for (size_t d = defStart[v]; d < defStart[v + 1]; d++)
+        {
+            workStamp[defBlocks[d]] = v;
+            work[numWork++] = defBlocks[d];
+        }
+        while (ok && numWork > 0)
+        {
+            int x = work[--numWork];
+            for (size_t f = frontierStart[x]; ok && f < frontierStart[x + 1]; f++)
+            {
+                int y = frontier[f];
+                if (blockStamp[y] != v)
+                {
+                    blockStamp[y] = v;
+                    ok = appendPair(&phiPairs, &ssa->numPhis, &phiCapacity, v, y);
+                }
+                if (workStamp[y] != v)
+                {
+                    workStamp[y] = v;
+                    work[numWork++] = y;
+                }
+            }
+        }
+    }
+
+    // Phi values follow the definitions; arguments start unknown
+    size_t numArgs = 0;
+    for (size_t p = 0; ok && p < ssa->numPhis; p++)
+        numArgs += cfg->blocks[phiPairs[p * 2 + 1]].numPreds;
+    if (ok)
+    {
+        ssa->phis = (PhiNode *)calloc(ssa->numPhis + 1, sizeof(PhiNode));
+        ssa->args = (int *)calloc(numArgs + 1, sizeof(int));
+        ok = ssa->phis != NULL && ssa->args != NULL;
+    }
+    size_t firstArg = 0;
+    for (size_t p = 0; ok && p < ssa->numPhis; p++)
+    {
+        PhiNode *phi = &ssa->phis[p];
+        phi->var = phiPairs[p * 2];
+        phi->block = phiPairs[p * 2 + 1];
+        phi->value = (int)(ssa->numValues + p);
+        phi->firstArg = firstArg;
+        firstArg += cfg->blocks[phi->block].numPreds;
+    }
+    for (size_t a = 0; ok && a < numArgs; a++)
+        ssa->args[a] = -1;
+    if (ok)
+    {
+        ssa->numValues += ssa->numPhis;
+        // Reuse the pairs as (block, phi) to group the phis by block
+        for (size_t p = 0; p < ssa->numPhis; p++)
+        {
+            phiPairs[p * 2] = ssa->phis[p].block;
+            phiPairs[p * 2 + 1] = (int)p;
+        }
+        ok = groupPairs(phiPairs, ssa->numPhis, numBlocks, &ssa->phiStart, &ssa->phiOrder);
+    }
+
+    free(frontierPairs);
+    free(defPairs);
+    free(phiPairs);
+    free(frontierStart);
+    free(frontier);
+    free(defStart);
+    free(defBlocks);
+    free(blockStamp);
+    free(workStamp);
+    free(work);
+    free(varStamp);
+    free(global);
+    return ok;
+}
+
+// Give every read the SSA value reaching it by walking the dominator tree,
+// with each variable's current value kept in an undo chain (prevValue)
+// rather than a stack per variable
+static bool renameVariables(SSAForm *ssa, const int *idom)
+{
+    CFG *cfg = ssa->cfg;
+    size_t numBlocks = cfg->numBlocks;
+    int *current = (int *)calloc(ssa->index.count + 1, sizeof(int));
+    int *prevValue = (int *)calloc(ssa->numValues + 1, sizeof(int));
+    int *stack = (int *)calloc(numBlocks * 2, sizeof(int));
+    int *childPairs = NULL;
+    size_t numChildren = 0, childCapacity = 0;
+    size_t *childStart = NULL;
+    int *children = NULL;
+    bool ok = current != NULL && prevValue != NULL && stack != NULL;
+    for (int b = 1; ok && b < (int)numBlocks; b++)
+    {
+        if (idom[b] >= 0)
+            ok = appendPair(&childPairs, &numChildren, &childCapacity, idom[b], b);
+    }
+    ok = ok && groupPairs(childPairs, numChildren, numBlocks, &childStart, &children);
+    for (size_t v = 0; ok && v < (size_t)ssa->index.count; v++)
+        current[v] = -1;
+
+    // Entries >= 0 enter a block; -1 - b leaves block b
+    size_t depth = 0;
+    if (ok)
+        stack[depth++] = 0;
+    while (depth > 0)
+    {
+        int item = stack[--depth];
+        if (item >= 0)
+        {
+            int b = item;
+            for (size_t k = ssa->phiStart[b]; k < ssa->phiStart[b + 1]; k++)
+            {
+                PhiNode *phi = &ssa->phis[ssa->phiOrder[k]];
+                prevValue[phi->value] = current[phi->var];
+                current[phi->var] = phi->value;
+            }
+            for (size_t i = ssa->blockStart[b]; i < ssa->blockStart[b + 1]; i++)
+            {
+                for (int k = 0; k < 2; k++)
+                {
+                    if (ssa->useVar[i * 2 + k] >= 0)
+                        ssa->useValue[i * 2 + k] = current[ssa->useVar[i * 2 + k]];
+                }
+                if (ssa->defVar[i] >= 0)
+                {
+                    prevValue[ssa->defValue[i]] = current[ssa->defVar[i]];
+                    current[ssa->defVar[i]] = ssa->defValue[i];
+                }
+            }
+
+            // Fill in this block's arguments to the phis of its successors
+            BasicBlock *block = &cfg->blocks[b];
+            for (int s = 0; s < block->numSucc; s++)
+            {
+                if (s == 1 && block->succ[1] == block->succ[0])
+                    break;
+                BasicBlock *succ = &cfg->blocks[block->succ[s]];
+                for (int p = 0; p < succ->numPreds; p++)
+                {
+                    if (succ->preds[p] != b)
+                        continue;
+                    for (size_t k = ssa->phiStart[succ->id]; k < ssa->phiStart[succ->id + 1]; k++)
+                    {
+                        PhiNode *phi = &ssa->phis[ssa->phiOrder[k]];
+                        ssa->args[phi->firstArg + p] = current[phi->var];
+                    }
+                }
+            }
+
+            stack[depth++] = -1 - b;
+            for (size_t c = childStart[b]; c < childStart[b + 1]; c++)
+                stack[depth++] = children[c];
+        }
+        else
+        {
+            // Undo the block's definitions, latest first
+            int b = -1 - item;
+            for (size_t i = ssa->blockStart[b + 1]; i > ssa->blockStart[b]; i--)
+            {
+                if (ssa->defVar[i - 1] >= 0)
+                    current[ssa->defVar[i - 1]] = prevValue[ssa->defValue[i - 1]];
+            }
+            for (size_t k = ssa->phiStart[b + 1]; k > ssa->phiStart[b]; k--)
+            {
+                PhiNode *phi = &ssa->phis[ssa->phiOrder[k - 1]];
+                current[phi->var] = prevValue[phi->value];
+            }
+        }
+    }
+
+    free(current);
+    free(prevValue);
+    free(stack);
+    free(childPairs);
+    free(childStart);
+    free(children);
+    return ok;
+}
+
+// Readers of each SSA value, for the value worklist
+static bool buildUseLists(SSAForm *ssa)
+{
+    int *pairs = NULL;
+    size_t count = 0, capacity = 0;
+    bool ok = true;
+    for (size_t i = 0; ok && i < ssa->numInstrs * 2; i++)
+    {
+        if (ssa->useValue[i] >= 0)
+            ok = appendPair(&pairs, &count, &capacity, ssa->useValue[i], (int)(i / 2));
+    }
+    for (size_t p = 0; ok && p < ssa->numPhis; p++)
+    {
+        PhiNode *phi = &ssa->phis[p];
+        for (int a = 0; ok && a < ssa->cfg->blocks[phi->block].numPreds; a++)
+        {
+            if (ssa->args[phi->firstArg + a] >= 0)
+                ok = appendPair(&pairs, &count, &capacity, ssa->args[phi->firstArg + a], (int)(ssa->numInstrs + p));
+        }
+    }
+    ok = ok && groupPairs(pairs, count, ssa->numValues, &ssa->useStart, &ssa->users);
+    free(pairs);
+    return ok;
+}
+
+// Build the SSA form of a non-empty TAC list; false if memory runs out
+static bool buildSSA(SSAForm *ssa, TAC *head)
+{
+    memset(ssa, 0, sizeof(SSAForm));
+    ssa->cfg = buildCFG(head);
+    if (!buildVarIndex(&ssa->index, head))
+        return false;
+
+    CFG *cfg = ssa->cfg;
+    size_t numBlocks = cfg->numBlocks;
+    for (TAC *current = head; current != NULL; current = current->next)
+        ssa->numInstrs++;
+    if (ssa->numInstrs > INT_MAX / 2)
+        return false;
+    ssa->instrs = (TAC **)calloc(ssa->numInstrs, sizeof(TAC *));
+    ssa->blockStart = (size_t *)calloc(numBlocks + 1, sizeof(size_t));
+    ssa->instrBlock = (int *)calloc(ssa->numInstrs, sizeof(int));
+    ssa->useVar = (int *)calloc(ssa->numInstrs * 2, sizeof(int));
+    ssa->useValue = (int *)calloc(ssa->numInstrs * 2, sizeof(int));
+    ssa->defValue = (int *)calloc(ssa->numInstrs, sizeof(int));
+    ssa->defVar = (int *)calloc(ssa->numInstrs, sizeof(int));
+    if (ssa->instrs == NULL || ssa->blockStart == NULL || ssa->instrBlock == NULL || ssa->useVar == NULL ||
+        ssa->useValue == NULL || ssa->defValue == NULL || ssa->defVar == NULL)
+        return false;
+
+    size_t i = 0;
+    for (size_t b = 0; b < numBlocks; b++)
+    {
+        BasicBlock *block = &cfg->blocks[b];
+        ssa->blockStart[b] = i;
+        for (TAC *instr = block->first;; instr = instr->next)
+        {
+            ssa->instrs[i] = instr;
+            ssa->instrBlock[i] = (int)b;
+            ssa->useVar[i * 2] = lookupVar(&ssa->index, instr->arg1);
+            ssa->useVar[i * 2 + 1] = lookupVar(&ssa->index, instr->arg2);
+            ssa->useValue[i * 2] = ssa->useValue[i * 2 + 1] = -1;
+            ssa->defVar[i] = definesValue(instr) ? lookupVar(&ssa->index, instr->result) : -1;
+            ssa->defValue[i] = ssa->defVar[i] >= 0 ? (int)ssa->numValues++ : -1;
+            i++;
+            if (instr == block->last)
+                break;
+        }
+    }
+    ssa->blockStart[numBlocks] = i;
+
+    int *idom = (int *)calloc(numBlocks, sizeof(int));
+    int *rpoNumber = (int *)calloc(numBlocks, sizeof(int));
+    bool ok = idom != NULL && rpoNumber != NULL && computeDominators(cfg, idom, rpoNumber) &&
+              placePhis(ssa, idom, rpoNumber) && renameVariables(ssa, idom) && buildUseLists(ssa);
+    free(idom);
+    free(rpoNumber);
+    return ok;
+}
+
+// Lattice value of an instruction's arg1 (k = 0) or arg2 (k = 1)
+static LatticeValue operandValue(SSAForm *ssa, LatticeValue *values, size_t i, int k)
+{
+    const char *operand = k == 0 ? ssa->instrs[i]->arg1 : ssa->instrs[i]->arg2;
+    LatticeValue value = {LATTICE_BOTTOM, 0};
+    if (isConstant(operand))
+    {
+        value.kind = LATTICE_CONST;
+        value.value = atoi(operand);
+        return value;
+    }
+    int ssaValue = ssa->useValue[i * 2 + k];
+    return ssaValue >= 0 ? values[ssaValue] : value;
+}
+
+// Value an instruction defines, from the values of its operands
+static LatticeValue transferInstruction(SSAForm *ssa, LatticeValue *values, size_t i)
+{
+    TAC *instr = ssa->instrs[i];
+    LatticeValue value = {LATTICE_BOTTOM, 0};
+
+    if (strcmp(instr->op, "=") == 0)
+    {
+        value = operandValue(ssa, values, i, 0);
+    }
+    else if (isIntegerBinaryOp(instr->op))
+    {
+        LatticeValue left = operandValue(ssa, values, i, 0);
+        LatticeValue right = operandValue(ssa, values, i, 1);
+        if (left.kind == LATTICE_CONST && right.kind == LATTICE_CONST)
+        {
+            if (evaluateIntegerOp(instr->op, left.value, right.value, &value.value))
+                value.kind = LATTICE_CONST;
+        }
+        else if (left.kind != LATTICE_BOTTOM && right.kind != LATTICE_BOTTOM)
+        {
+            value.kind = LATTICE_TOP;
+        }
+    }
+    // Array loads and float operations are never tracked
+
+    return value;
+}
+
+static LatticeValue meetValues(LatticeValue a, LatticeValue b)
+{
+    if (a.kind == LATTICE_TOP)
+        return b;
+    if (b.kind == LATTICE_TOP)
+        return a;
+    if (a.kind == LATTICE_CONST && b.kind == LATTICE_CONST && a.value == b.value)
+        return a;
+    LatticeValue bottom = {LATTICE_BOTTOM, 0};
+    return bottom;
+}
+
+// Replace a use with its constant value if the lattice proves one
+static int substituteOperand(SSAForm *ssa, LatticeValue *values, size_t i, int k)
+{
+    char **operand = k == 0 ? &ssa->instrs[i]->arg1 : &ssa->instrs[i]->arg2;
+    int ssaValue = ssa->useValue[i * 2 + k];
+    if (*operand == NULL || isConstant(*operand) || ssaValue < 0 || values[ssaValue].kind != LATTICE_CONST)
+        return 0;
+
+    char valueStr[20];
+    sprintf(valueStr, "%d", values[ssaValue].value);
+    free(*operand);
+    *operand = strdup(valueStr);
+    return 1;
+}
+
+static int substituteUses(SSAForm *ssa, LatticeValue *values, size_t i)
+{
+    TAC *instr = ssa->instrs[i];
+    int changes = 0;
+    if (instr->op == NULL)
+        return 0;
+
+    if (strcmp(instr->op, "=") == 0 || strcmp(instr->op, "write") == 0 ||
+        strcmp(instr->op, "ifFalse") == 0)
+    {
+        changes += substituteOperand(ssa, values, i, 0);
+    }
+    else if (isIntegerBinaryOp(instr->op) || strcmp(instr->op, "[]=") == 0)
+    {
+        changes += substituteOperand(ssa, values, i, 0);
+        changes += substituteOperand(ssa, values, i, 1);
+    }
+    else if (strcmp(instr->op, "=[]") == 0)
+    {
+        changes += substituteOperand(ssa, values, i, 1);
+    }
+    return changes;
+}
+
+// Remove "goto L" directly followed by "L:" and labels that nothing branches to
+static int removeRedundantJumps(TAC **head)
+{
+    int changes = 0;
+    TAC *current = *head;
+    TAC *prev = NULL;
+
+    while (current != NULL)
+    {
+        if (current->op != NULL && strcmp(current->op, "goto") == 0 &&
+            isLabel(current->next) && strcmp(current->next->result, current->result) == 0)
+        {
+            TAC *toDelete = current;
+            current = current->next;
+            if (prev == NULL)
+                *head = current;
+            else
+                prev->next = current;
+            freeInstruction(toDelete);
+            changes++;
+            continue;
+        }
+        prev = current;
+        current = current->next;
+    }
+
+    // Collect every branch target into a hash set
+    int numBranches = 0;
+    for (current = *head; current != NULL; current = current->next)
+    {
+        if (isBranch(current))
+            numBranches++;
+    }
+    int capacity = numBranches * 2 + 1;
+    const char **targets = (const char **)calloc(capacity, sizeof(char *));
+    for (current = *head; current != NULL; current = current->next)
+    {
+        if (!isBranch(current))
+            continue;
+        unsigned int i = hashFunction(current->result, capacity);
+        while (targets[i] != NULL && strcmp(targets[i], current->result) != 0)
+            i = (i + 1) % capacity;
+        targets[i] = current->result;
+    }
+
+    current = *head;
+    prev = NULL;
+    while (current != NULL)
+    {
+        bool referenced = true;
+        if (isLabel(current))
+        {
+            unsigned int i = hashFunction(current->result, capacity);
+            while (targets[i] != NULL && strcmp(targets[i], current->result) != 0)
+                i = (i + 1) % capacity;
+            referenced = targets[i] != NULL;
+        }
+        if (!referenced)
+        {
+            TAC *toDelete = current;
+            current = current->next;
+            if (prev == NULL)
+                *head = current;
+            else
+                prev->next = current;
+            freeInstruction(toDelete);
+            changes++;
+            continue;
+        }
+        prev = current;
+        current = current->next;
+    }
+    free(targets);
+    return changes;
+}
+
+// Solver state: a lattice value per SSA value, executable flags per block
+// and per CFG edge, and the two worklists
+typedef struct
+{
+    SSAForm *ssa;
+    LatticeValue *values;
+    bool *blockExecutable;
+    bool *executable; // Edge from block b through successor slot s is b * 2 + s
+    int *valueWork;
+    size_t numValueWork;
+    CFGEdge *edgeWork;
+    size_t numEdgeWork;
+} SCCPState;
+
+// Lower an SSA value, queueing its readers if it changed. Meeting with the
+// old value keeps every value to at most two drops (TOP, CONST, BOTTOM),
+// which bounds the worklist.
+static void lowerValue(SCCPState *state, int ssaValue, LatticeValue value)
+{
+    LatticeValue old = state->values[ssaValue];
+    value = meetValues(old, value);
+    if (old.kind == value.kind && (value.kind != LATTICE_CONST || old.value == value.value))
+        return;
+    state->values[ssaValue] = value;
+    state->valueWork[state->numValueWork++] = ssaValue;
+}
+
+static void visitPhi(SCCPState *state, const PhiNode *phi)
+{
+    CFG *cfg = state->ssa->cfg;
+    BasicBlock *block = &cfg->blocks[phi->block];
+    LatticeValue value = {LATTICE_TOP, 0};
+    LatticeValue bottom = {LATTICE_BOTTOM, 0};
+    for (int p = 0; p < block->numPreds; p++)
+    {
+        // Only arguments from edges that can be taken count
+        BasicBlock *pred = &cfg->blocks[block->preds[p]];
+        bool taken = false;
+        for (int slot = 0; slot < pred->numSucc; slot++)
+            taken = taken || (pred->succ[slot] == phi->block && state->executable[pred->id * 2 + slot]);
+        if (!taken)
+            continue;
+        int arg = state->ssa->args[phi->firstArg + p];
+        value = meetValues(value, arg >= 0 ? state->values[arg] : bottom);
+    }
+    lowerValue(state, phi->value, value);
+}
+
+static void visitInstruction(SCCPState *state, size_t i)
+{
+    SSAForm *ssa = state->ssa;
+    if (ssa->defValue[i] >= 0)
+        lowerValue(state, ssa->defValue[i], transferInstruction(ssa, state->values, i));
+
+    BasicBlock *block = &ssa->cfg->blocks[ssa->instrBlock[i]];
+    if (ssa->instrs[i] != block->last)
+        return;
+
+    // Only follow the branch edges the condition allows
+    bool follow[2] = {true, true};
+    if (block->last->op != NULL && strcmp(block->last->op, "ifFalse") == 0)
+    {
+        LatticeValue cond = operandValue(ssa, state->values, i, 0);
+        if (cond.kind == LATTICE_TOP)
+        {
+            follow[0] = follow[1] = false;
+        }
+        else if (cond.kind == LATTICE_CONST)
+        {
+            follow[0] = cond.value != 0;
+            follow[1] = cond.value == 0;
+        }
+    }
+    for (int slot = 0; slot < block->numSucc; slot++)
+    {
+        if (!follow[slot] || state->executable[block->id * 2 + slot])
+            continue;
+        state->executable[block->id * 2 + slot] = true;
+        CFGEdge next = {block->id, slot, block->succ[slot]};
+        state->edgeWork[state->numEdgeWork++] = next;
+    }
+}
+
+// Wegman-Zadeck SCCP over an SSA form of the TAC: one lattice value per
+// SSA value, so the work and memory grow with the size of the program
+int sparseConditionalConstantPropagation(TAC **head)
+{
+    printf("Sparse Conditional Constant Propagation \n");
+    if (*head == NULL)
+        return 0;
+
+    SSAForm ssa;
+    SCCPState state;
+    memset(&state, 0, sizeof(SCCPState));
+    bool *dropLast = NULL;
+    bool ok = buildSSA(&ssa, *head);
+    size_t numBlocks = ssa.cfg != NULL ? (size_t)ssa.cfg->numBlocks : 0;
+    if (ok)
+    {
+        state.ssa = &ssa;
+        state.values = (LatticeValue *)calloc(ssa.numValues + 1, sizeof(LatticeValue));
+        state.blockExecutable = (bool *)calloc(numBlocks, sizeof(bool));
+        state.executable = (bool *)calloc(numBlocks * 2, sizeof(bool));
+        state.valueWork = (int *)calloc(ssa.numValues * 2 + 1, sizeof(int));
+        state.edgeWork = (CFGEdge *)calloc(numBlocks * 2 + 1, sizeof(CFGEdge));
+        dropLast = (bool *)calloc(numBlocks, sizeof(bool));
+        ok = state.values != NULL && state.blockExecutable != NULL && state.executable != NULL &&
+             state.valueWork != NULL && state.edgeWork != NULL && dropLast != NULL;
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "Warning: Not enough memory for sparse conditional constant propagation; skipping it\n");
+        free(state.values);
+        free(state.blockExecutable);
+        free(state.executable);
+        free(state.valueWork);
+        free(state.edgeWork);
+        free(dropLast);
+        freeSSA(&ssa);
+        return 0;
+    }
+
+    for (size_t v = 0; v < ssa.numValues; v++)
+        state.values[v].kind = LATTICE_TOP;
+    CFGEdge entry = {-1, 0, 0};
+    state.edgeWork[state.numEdgeWork++] = entry;
+
+    while (state.numEdgeWork > 0 || state.numValueWork > 0)
+    {
+        if (state.numEdgeWork > 0)
+        {
+            // A new edge into b gives its phis another argument; the first
+            // one makes its instructions run
+            int b = state.edgeWork[--state.numEdgeWork].to;
+            for (size_t k = ssa.phiStart[b]; k < ssa.phiStart[b + 1]; k++)
+                visitPhi(&state, &ssa.phis[ssa.phiOrder[k]]);
+            if (!state.blockExecutable[b])
+            {
+                state.blockExecutable[b] = true;
+                for (size_t i = ssa.blockStart[b]; i < ssa.blockStart[b + 1]; i++)
+                    visitInstruction(&state, i);
+            }
+            continue;
+        }
+
+        // A value dropped: revisit its readers in blocks that run
+        int v = state.valueWork[--state.numValueWork];
+        for (size_t u = ssa.useStart[v]; u < ssa.useStart[v + 1]; u++)
+        {
+            size_t user = ssa.users[u];
+            if (user < ssa.numInstrs)
+            {
+                if (state.blockExecutable[ssa.instrBlock[user]])
+                    visitInstruction(&state, user);
+            }
+            else
+            {
+                PhiNode *phi = &ssa.phis[user - ssa.numInstrs];
+                if (state.blockExecutable[phi->block])
+                    visitPhi(&state, phi);
+            }
+        }
+    }
+
+    // Rewrite uses with proven constants and fold decided branches
+    CFG *cfg = ssa.cfg;
+    int changes = 0;
+    for (size_t b = 0; b < numBlocks; b++)
+    {
+        if (!state.blockExecutable[b])
+            continue;
+        for (size_t i = ssa.blockStart[b]; i < ssa.blockStart[b + 1]; i++)
+            changes += substituteUses(&ssa, state.values, i);
+
+        TAC *last = cfg->blocks[b].last;
+        if (last->op != NULL && strcmp(last->op, "ifFalse") == 0 && isConstant(last->arg1))
+        {
+            if (atoi(last->arg1) != 0)
+            {
+                // Condition always holds: fall through
+                dropLast[b] = true;
+            }
+            else
+            {
+                // Condition never holds: always branch
+                free(last->op);
+                free(last->arg1);
+                last->op = strdup("goto");
+                last->arg1 = NULL;
+            }
+            changes++;
+        }
+    }
+
+    // Unlink blocks that are never executed
+    TAC *newHead = NULL;
+    TAC *tail = NULL;
+    for (size_t b = 0; b < numBlocks; b++)
+    {
+        BasicBlock *block = &cfg->blocks[b];
+        TAC *instr = block->first;
+        TAC *end = block->last->next;
+        while (instr != end)
+        {
+            TAC *next = instr->next;
+            if (!state.blockExecutable[b] || (instr == block->last && dropLast[b]))
+            {
+                freeInstruction(instr);
+                changes++;
+            }
+            else
+            {
+                if (tail == NULL)
+                    newHead = instr;
+                else
+                    tail->next = instr;
+                tail = instr;
+            }
+            instr = next;
+        }
+    }
+    if (tail != NULL)
+        tail->next = NULL;
+    *head = newHead;
+
+    free(state.values);
+    free(state.blockExecutable);
+    free(state.executable);
+    free(state.valueWork);
+    free(state.edgeWork);
+    free(dropLast);
+    freeSSA(&ssa);
+
+    changes += removeRedundantJumps(head);
+    return changes;
+}
+
+/* Array Memory Optimizations */
+
+// Decide whether two array accesses can touch the same element. Identical
+// variable indices are a must-alias only if the caller knows the index
+// was not redefined between the two accesses.
+AliasResult arrayAccessAlias(const char *array1, const char *index1, const char *array2, const char *index2)
+{
+    // Distinct arrays never overlap
+    if (strcmp(array1, array2) != 0)
+        return ALIAS_NO;
+
+    if (isConstant(index1) && isConstant(index2))
+        return atoi(index1) == atoi(index2) ? ALIAS_MUST : ALIAS_NO;
+
+    if (strcmp(index1, index2) == 0)
+        return ALIAS_MUST;
+
+    return ALIAS_MAY;
+}
+
+// A value known to be held by an array element: either the operand last
+// stored there or the variable it was last loaded into
+typedef struct
+{
+    char *array;
+    char *index;
+    char *value;
+} AvailableAccess;
+
+#define MAX_AVAILABLE_ACCESSES 64
+
+static void removeAvailableAccess(AvailableAccess *available, int *count, int i)
+{
+    free(available[i].array);
+    free(available[i].index);
+    free(available[i].value);
+    available[i] = available[--(*count)];
+}
+
+static void clearAvailableAccesses(AvailableAccess *available, int *count)
+{
+    while (*count > 0)
+        removeAvailableAccess(available, count, *count - 1);
+}
+
+static void addAvailableAccess(AvailableAccess *available, int *count, const char *array, const char *index, const char *value)
+{
+    if (*count == MAX_AVAILABLE_ACCESSES)
+        removeAvailableAccess(available, count, 0);
+    available[*count].array = strdup(array);
+    available[*count].index = strdup(index);
+    available[*count].value = strdup(value);
+    (*count)++;
+}
+
+// Store-to-load forwarding and redundant load elimination within basic blocks
+int arrayStoreForwarding(TAC **head)
+{
+    printf("Array Store Forwarding \n");
+    int changes = 0;
+    AvailableAccess available[MAX_AVAILABLE_ACCESSES];
+    int count = 0;
+
+    for (TAC *current = *head; current != NULL; current = current->next)
+    {
+        if (current->op == NULL)
+            continue;
+
+        // Nothing is known about memory on entry to a block
+        if (isControlFlow(current))
+        {
+            clearAvailableAccesses(available, &count);
+            continue;
+        }
+
+        if (strcmp(current->op, "=[]") == 0)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                if (arrayAccessAlias(available[i].array, available[i].index, current->arg1, current->arg2) == ALIAS_MUST)
+                {
+                    // The element's value is already in a variable or constant
+                    free(current->op);
+                    free(current->arg1);
+                    free(current->arg2);
+                    current->op = strdup("=");
+                    current->arg1 = strdup(available[i].value);
+                    current->arg2 = NULL;
+                    changes++;
+                    break;
+                }
+            }
+        }
+
+        // Anything that mentions a redefined variable is no longer valid
+        if (current->result != NULL && strcmp(current->op, "[]=") != 0)
+        {
+            for (int i = count - 1; i >= 0; i--)
+            {
+                if (strcmp(available[i].index, current->result) == 0 ||
+                    strcmp(available[i].value, current->result) == 0)
+                {
+                    removeAvailableAccess(available, &count, i);
+                }
+            }
+        }
+
+        if (strcmp(current->op, "[]=") == 0)
+        {
+            // The store overwrites every element it may alias
+            for (int i = count - 1; i >= 0; i--)
+            {
+                if (arrayAccessAlias(available[i].array, available[i].index, current->result, current->arg1) != ALIAS_NO)
+                {
+                    removeAvailableAccess(available, &count, i);
+                }
+            }
+            if (!isFloatConstant(current->arg2))
+                addAvailableAccess(available, &count, current->result, current->arg1, current->arg2);
+        }
+        else if (strcmp(current->op, "=[]") == 0 && strcmp(current->arg2, current->result) != 0)
+        {
+            addAvailableAccess(available, &count, current->arg1, current->arg2, current->result);
+        }
+    }
+
+    clearAvailableAccesses(available, &count);
+    return changes;
+}
+
+// Set of array elements that may still be read; index -1 stands for any element
+typedef struct
+{
+    const char *array;
+    int index;
+} LiveElement;
+
+typedef struct
+{
+    LiveElement *items;
+    int count;
+    int capacity;
+} ElementSet;
+
+static void elementSetAdd(ElementSet *set, const char *array, int index)
+{
+    for (int i = 0; i < set->count; i++)
+    {
+        if (set->items[i].index == index && strcmp(set->items[i].array, array) == 0)
+            return;
+    }
+    if (set->count == set->capacity)
+    {
+        set->capacity = set->capacity ? set->capacity * 2 : 8;
+        set->items = (LiveElement *)realloc(set->items, sizeof(LiveElement) * set->capacity);
+    }
+    set->items[set->count].array = array;
+    set->items[set->count].index = index;
+    set->count++;
+}
+
+static void elementSetKill(ElementSet *set, const char *array, int index)
+{
+    for (int i = set->count - 1; i >= 0; i--)
+    {
+        if (set->items[i].index == index && strcmp(set->items[i].array, array) == 0)
+            set->items[i] = set->items[--set->count];
+    }
+}
+
+static bool elementSetMayRead(ElementSet *set, const char *array, int index)
+{
+    for (int i = 0; i < set->count; i++)
+    {
+        if (strcmp(set->items[i].array, array) == 0 &&
+            (set->items[i].index < 0 || index < 0 || set->items[i].index == index))
+            return true;
+    }
+    return false;
+}
+
+static int constantIndex(const char *index)
+{
+    return isConstant(index) && atoi(index) >= 0 ? atoi(index) : -1;
+}
+
+// Backward transfer through one instruction; returns true if it is a dead store
+static bool transferLiveElements(ElementSet *live, TAC *instr)
+{
+    if (instr->op == NULL)
+        return false;
+
+    if (strcmp(instr->op, "=[]") == 0)
+    {
+        elementSetAdd(live, instr->arg1, constantIndex(instr->arg2));
+    }
+    else if (strcmp(instr->op, "[]=") == 0)
+    {
+        int index = constantIndex(instr->arg1);
+        if (!elementSetMayRead(live, instr->result, index))
+            return true;
+        // A store to a known element hides it from earlier stores
+        if (index >= 0)
+            elementSetKill(live, instr->result, index);
+    }
+    return false;
+}
+
+// Remove array stores that no later load can observe. Memory is not
+// observable after the program ends, so nothing is live on exit.
+int deadArrayStoreElimination(TAC **head)
+{
+    printf("Dead Array Store Elimination \n");
+    CFG *cfg = buildCFG(*head);
+    if (cfg == NULL)
+        return 0;
+
+    int numBlocks = cfg->numBlocks;
+    ElementSet *liveIn = (ElementSet *)calloc(numBlocks, sizeof(ElementSet));
+    ElementSet live = {NULL, 0, 0};
+
+    // Collect each block's instructions so they can be walked backwards
+    int maxLength = 0;
+    for (int b = 0; b < numBlocks; b++)
+    {
+        int length = 1;
+        for (TAC *instr = cfg->blocks[b].first; instr != cfg->blocks[b].last; instr = instr->next)
+            length++;
+        if (length > maxLength)
+            maxLength = length;
+    }
+    TAC **instrs = (TAC **)malloc(sizeof(TAC *) * maxLength);
+    bool *dead = (bool *)malloc(sizeof(bool) * maxLength);
+
+    // Iterate the backward dataflow to a fixpoint
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int b = numBlocks - 1; b >= 0; b--)
+        {
+            BasicBlock *block = &cfg->blocks[b];
+            live.count = 0;
+            for (int s = 0; s < block->numSucc; s++)
+            {
+                ElementSet *succIn = &liveIn[block->succ[s]];
+                for (int i = 0; i < succIn->count; i++)
+                    elementSetAdd(&live, succIn->items[i].array, succIn->items[i].index);
+            }
+
+            int length = 0;
+            for (TAC *instr = block->first;; instr = instr->next)
+            {
+                instrs[length++] = instr;
+                if (instr == block->last)
+                    break;
+            }
+            for (int i = length - 1; i >= 0; i--)
+                transferLiveElements(&live, instrs[i]);
+
+            // Live sets only grow, so a larger set means a change
+            if (live.count != liveIn[b].count)
+            {
+                changed = true;
+                liveIn[b].count = 0;
+                for (int i = 0; i < live.count; i++)
+                    elementSetAdd(&liveIn[b], live.items[i].array, live.items[i].index);
+            }
+        }
+    }
+
+    // Remove the dead stores block by block
+    int changes = 0;
+    TAC *newHead = NULL;
+    TAC *tail = NULL;
+    for (int b = 0; b < numBlocks; b++)
+    {
+        BasicBlock *block = &cfg->blocks[b];
+        live.count = 0;
+        for (int s = 0; s < block->numSucc; s++)
+        {
+            ElementSet *succIn = &liveIn[block->succ[s]];
+            for (int i = 0; i < succIn->count; i++)
+                elementSetAdd(&live, succIn->items[i].array, succIn->items[i].index);
+        }
+
+        int length = 0;
+        for (TAC *instr = block->first;; instr = instr->next)
+        {
+            instrs[length++] = instr;
+            if (instr == block->last)
+                break;
+        }
+        for (int i = length - 1; i >= 0; i--)
+            dead[i] = transferLiveElements(&live, instrs[i]);
+
+        for (int i = 0; i < length; i++)
+        {
+            if (dead[i])
+            {
+                freeInstruction(instrs[i]);
+                changes++;
+                continue;
+            }
+            if (tail == NULL)
+                newHead = instrs[i];
+            else
+                tail->next = instrs[i];
+            tail = instrs[i];
+        }
+    }
+    if (tail != NULL)
+        tail->next = NULL;
+    *head = newHead;
+
+    for (int b = 0; b < numBlocks; b++)
+        free(liveIn[b].items);
+    free(liveIn);
+    free(live.items);
+    free(instrs);
+    free(dead);
+    freeCFG(cfg);
+    return changes;
+}
+
+// Name of the variable that replaces one element of a scalar-replaced array
+static char *scalarElementName(const char *array, int index)
+{
+    // '_' cannot appear in source identifiers, so this never clashes
+    char *name = malloc(strlen(array) + 16);
+    sprintf(name, "%s_%d", array, index);
+    return name;
+}
+
+// Replace small arrays that are only indexed by in-bounds constants with
+// one variable per element, which later passes can keep in registers
+int scalarReplaceArrays(TAC **head, SymbolTable *symTab)
+{
+    printf("Array Scalar Replacement \n");
+    int changes = 0;
+
+    for (int i = 0; i < symTab->size; i++)
+    {
+        for (Symbol *symbol = symTab->table[i]; symbol != NULL; symbol = symbol->next)
+        {
+            if (!symbol->isArray || symbol->arrayInfo == NULL ||
+                symbol->arrayInfo->size > SCALAR_REPLACEMENT_LIMIT)
+                continue;
+
+            // Every access must use an in-bounds constant index
+            bool promotable = true;
+            bool accessed = false;
+            for (TAC *current = *head; current != NULL && promotable; current = current->next)
+            {
+                const char *index = NULL;
+                if (current->op != NULL && strcmp(current->op, "[]=") == 0 && strcmp(current->result, symbol->name) == 0)
+                    index = current->arg1;
+                else if (current->op != NULL && strcmp(current->op, "=[]") == 0 && strcmp(current->arg1, symbol->name) == 0)
+                    index = current->arg2;
+                else
+                    continue;
+
+                accessed = true;
+                if (!isConstant(index) || atoi(index) < 0 || atoi(index) >= symbol->arrayInfo->size)
+                    promotable = false;
+            }
+            if (!promotable || !accessed)
+                continue;
+
+            // Declare one variable per element, starting from the element's
+            // static value if the array has one in .data (zero otherwise)
+            for (int e = 0; e < symbol->arrayInfo->size; e++)
+            {
+                char *element = scalarElementName(symbol->name, e);
+                Symbol *scalar = findSymbol(symTab, element);
+                if (scalar == NULL)
+                    scalar = insertSymbol(symTab, element, symbol->type, false, NULL);
+                const ArrayValue *value = getArrayValue(symbol->arrayInfo, e);
+                if (scalar != NULL && scalar->value == NULL && value != NULL)
+                {
+                    char text[32];
+                    if (symbol->arrayInfo->isFloat)
+                        snprintf(text, sizeof(text), "%.9g", value->floatValue);
+                    else
+                        snprintf(text, sizeof(text), "%d", value->intValue);
+                    scalar->value = strdup(text);
+                }
+                free(element);
+            }
+
+            for (TAC *current = *head; current != NULL; current = current->next)
+            {
+                if (current->op == NULL)
+                    continue;
+                if (strcmp(current->op, "[]=") == 0 && strcmp(current->result, symbol->name) == 0)
+                {
+                    // arr[c] = v  ->  arr_c = v
+                    char *element = scalarElementName(symbol->name, atoi(current->arg1));
+                    free(current->op);
+                    free(current->arg1);
+                    free(current->result);
+                    current->op = strdup("=");
+                    current->arg1 = current->arg2;
+                    current->arg2 = NULL;
+                    current->result = element;
+                    changes++;
+                }
+                else if (strcmp(current->op, "=[]") == 0 && strcmp(current->arg1, symbol->name) == 0)
+                {
+                    // t = arr[c]  ->  t = arr_c
+                    char *element = scalarElementName(symbol->name, atoi(current->arg2));
+                    free(current->op);
+                    free(current->arg1);
+                    free(current->arg2);
+                    current->op = strdup("=");
+                    current->arg1 = element;
+                    current->arg2 = NULL;
+                    changes++;
+                }
+            }
+        }
+    }
+    return changes;
+}
+
+/* Static Data Initialization */
+
+static bool isBlockedArray(Symbol **blocked, int numBlocked, Symbol *array)
+{
+    for (int i = 0; i < numBlocked; i++)
+    {
+        if (blocked[i] == array)
+            return true;
+    }
+    return false;
+}
+
+// Move constant first definitions that run exactly once, before anything
+// reads the location, out of the code and into the .data section. Scalars
+// record their initializer in Symbol->value and array elements in their
+// Array's element table. Initializers already recorded by an earlier run,
+// or restored from a binary IR file, are kept and only added to.
+int staticDataInitialization(TAC **head, SymbolTable *symTab)
+{
+    printf("Static Data Initialization \n");
+    int changes = 0;
+
+    // A scalar is touched once it has been read or written
+    VarIndex index;
+    bool *touched = NULL;
+    if (!buildVarIndex(&index, *head) || (touched = (bool *)calloc(index.count + 1, sizeof(bool))) == NULL)
+    {
+        fprintf(stderr, "Warning: Not enough memory for static data initialization; skipping it\n");
+        free(index.names);
+        free(index.ids);
+        return 0;
+    }
+    Symbol **blocked = NULL;
+    int numBlocked = 0;
+    // The index borrows names from the TAC, so removed instructions are
+    // freed only after the scan
+    TAC *removed = NULL;
+
+    TAC *current = *head;
+    TAC *prev = NULL;
+    // Only the straight-line code before the first label or branch runs exactly once
+    while (current != NULL && !isControlFlow(current))
+    {
+        bool remove = false;
+
+        if ((strcmp(current->op, "=") == 0 && isConstant(current->arg1)) ||
+            (strcmp(current->op, "fmov") == 0 && (isConstant(current->arg1) || isFloatConstant(current->arg1))))
+        {
+            int id = lookupVar(&index, current->result);
+            Symbol *symbol = findSymbol(symTab, current->result);
+            if (id >= 0 && !touched[id] && symbol != NULL && !symbol->isArray)
+            {
+                // The store runs before any read, so it replaces an earlier initializer
+                free(symbol->value);
+                symbol->value = strdup(current->arg1);
+                remove = true;
+            }
+        }
+        else if (strcmp(current->op, "[]=") == 0)
+        {
+            Symbol *symbol = findSymbol(symTab, current->result);
+            if (symbol != NULL && symbol->isArray && !isBlockedArray(blocked, numBlocked, symbol))
+            {
+                int element = constantIndex(current->arg1);
+                Array *array = symbol->arrayInfo;
+                if (element < 0 || element >= array->size)
+                {
+                    // Any element may change from here on
+                    blocked = (Symbol **)realloc(blocked, sizeof(Symbol *) * (numBlocked + 1));
+                    blocked[numBlocked++] = symbol;
+                }
+                else if (getArrayValue(array, element) == NULL &&
+                         (isConstant(current->arg2) || (array->isFloat && isFloatConstant(current->arg2))))
+                {
+                    ArrayValue value;
+                    if (array->isFloat)
+                        value.floatValue = (float)atof(current->arg2);
+                    else
+                        value.intValue = atoi(current->arg2);
+                    setArrayValue(array, element, value);
+                    remove = true;
+                }
+                else if (getArrayValue(array, element) == NULL)
+                {
+                    // The element is written at runtime; keep its zero
+                    ArrayValue zero = {0};
+                    setArrayValue(array, element, zero);
+                }
+            }
+        }
+        else if (strcmp(current->op, "=[]") == 0)
+        {
+            Symbol *symbol = findSymbol(symTab, current->arg1);
+            if (symbol != NULL && symbol->isArray && !isBlockedArray(blocked, numBlocked, symbol))
+            {
+                int element = constantIndex(current->arg2);
+                if (element < 0 || element >= symbol->arrayInfo->size)
+                {
+                    blocked = (Symbol **)realloc(blocked, sizeof(Symbol *) * (numBlocked + 1));
+                    blocked[numBlocked++] = symbol;
+                }
+                else if (getArrayValue(symbol->arrayInfo, element) == NULL)
+                {
+                    // Read before any store, so it must stay zero
+                    ArrayValue zero = {0};
+                    setArrayValue(symbol->arrayInfo, element, zero);
+                }
+            }
+        }
+
+        if (!remove)
+        {
+            // Mark every scalar this instruction reads or writes
+            const char *operands[] = {current->arg1, current->arg2, current->result};
+            for (int i = 0; i < 3; i++)
+            {
+                int id = lookupVar(&index, operands[i]);
+                if (id >= 0)
+                    touched[id] = true;
+            }
+        }
+        else
+        {
+            int id = lookupVar(&index, current->result);
+            if (id >= 0)
+                touched[id] = true;
+        }
+
+        if (remove)
+        {
+            TAC *toDelete = current;
+            current = current->next;
+            if (prev == NULL)
+                *head = current;
+            else
+                prev->next = current;
+            toDelete->next = removed;
+            removed = toDelete;
+            changes++;
+            continue;
+        }
+        prev = current;
+        current = current->next;
+    }
+
+    while (removed != NULL)
+    {
+        TAC *next = removed->next;
+        freeInstruction(removed);
+        removed = next;
+    }
+    free(blocked);
+    free(touched);
+    free(index.names);
+    free(index.ids);
+    return changes;
+}
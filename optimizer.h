@@ -2,11 +2,26 @@
 #define OPTIMIZER_H
 
 #include "semantic.h"
+#include "passManager.h"
 #include <stdbool.h>
 #include <ctype.h>
 
-// Function to optimize the TAC instructions
-void optimizeTAC(TAC **head);
+// Arrays with at most this many elements may be replaced by scalars
+#define SCALAR_REPLACEMENT_LIMIT 8
+
+// Result of comparing two array accesses
+typedef enum
+{
+    ALIAS_NO,   // The accesses never touch the same element
+    ALIAS_MAY,  // The accesses might touch the same element
+    ALIAS_MUST  // The accesses always touch the same element
+} AliasResult;
+
+// Optimize the TAC instructions with the current pass pipeline
+void optimizeTAC(TAC **head, SymbolTable *symTab);
+
+// Optimize one window of a program compiled in streaming mode
+void optimizeTACWindow(TAC **head, SymbolTable *symTab, bool firstWindow, bool lastWindow);
 
 // Utility functions to check if a string is a constant or a variable
 bool hasSideEffect(TAC *instr);
@@ -14,9 +29,22 @@ bool hasSideEffect(TAC *instr);
 // Optimization functions that return the number of changes made
 int constantFolding(TAC **head);
 int constantPropagation(TAC **head);
+int sparseConditionalConstantPropagation(TAC **head);
+int arrayStoreForwarding(TAC **head);
+int deadArrayStoreElimination(TAC **head);
+int scalarReplaceArrays(TAC **head, SymbolTable *symTab);
+int staticDataInitialization(TAC **head, SymbolTable *symTab);
+
+// Array alias analysis
+AliasResult arrayAccessAlias(const char *array1, const char *index1, const char *array2, const char *index2);
 int copyPropagation(TAC **head);
 int deadCodeElimination(TAC **head);
 
+// Helpers shared by the optimization passes
+void freeInstruction(TAC *instr);
+bool isIntegerBinaryOp(const char *op);
+bool evaluateIntegerOp(const char *op, int operand1, int operand2, int *result);
+
 // Functions to print the optimized TAC
 void printOptimizedTAC(const char *filename, TAC *head);
 void printCurrentOptimizedTAC(TAC *current);
@@ -1,45 +1,19 @@
 .data
-spill_area: .word 0
-t0: .word 0
-t1: .word 0
-t2: .word 0
-t3: .word 0
-t4: .word 0
-t5: .word 0
-t6: .word 0
-t7: .word 0
-x: .word 0
-y: .word 0
-z: .space 16
+x: .word 25
+y: .word 90
+z_0: .word 3
+z_1: .word 5
+z_2: .word 7
+z_3: .word 9
 floatA: .float 1.234000
 angel: .word 0
-adon: .word 0
-a: .word 0
-b: .word 0
-c: .word 0
+adon: .word 1
+a: .word 12
+b: .word 33
+c: .word 3
 .text
 .globl main
 main:
-# Generating MIPS code for array assignment
-	la $t8, z
-# Spilling register $t0 to memory
-	sw $t0, spill_area
-	li $t0, 3
-	sw $t0, 0($t8)
-# Generating MIPS code for array assignment
-	la $t8, z
-# Spilling register $t0 to memory
-	sw $t0, spill_area
-	li $t0, 5
-	sw $t0, 4($t8)
-# Generating MIPS code for array assignment
-	la $t8, z
-	li $t0, 7
-	sw $t0, 8($t8)
-# Generating MIPS code for array assignment
-	la $t8, z
-	li $t0, 9
-	sw $t0, 12($t8)
 # Generating MIPS code for write operation
 	li $a0, 25
 	li $v0, 1
@@ -54,54 +28,34 @@ main:
 	li $a0, 10
 	li $v0, 11
 	syscall
-# Generating MIPS code for array access
-	la $t8, z
-	lw $t0, 0($t8)
 # Generating MIPS code for write operation
-	move $a0, $t0
+	li $a0, 3
 	li $v0, 1
 	syscall
 	li $a0, 10
 	li $v0, 11
 	syscall
-# Storing variable t1 back to memory
-	sw $t0, t1
-# Generating MIPS code for array access
-	la $t8, z
-	lw $t0, 4($t8)
 # Generating MIPS code for write operation
-	move $a0, $t0
+	li $a0, 5
 	li $v0, 1
 	syscall
 	li $a0, 10
 	li $v0, 11
 	syscall
-# Storing variable t3 back to memory
-	sw $t0, t3
-# Generating MIPS code for array access
-	la $t8, z
-	lw $t0, 8($t8)
 # Generating MIPS code for write operation
-	move $a0, $t0
+	li $a0, 7
 	li $v0, 1
 	syscall
 	li $a0, 10
 	li $v0, 11
 	syscall
-# Storing variable t5 back to memory
-	sw $t0, t5
-# Generating MIPS code for array access
-	la $t8, z
-	lw $t0, 12($t8)
 # Generating MIPS code for write operation
-	move $a0, $t0
+	li $a0, 9
 	li $v0, 1
 	syscall
 	li $a0, 10
 	li $v0, 11
 	syscall
-# Storing variable t7 back to memory
-	sw $t0, t7
 # Generating MIPS code for write operation
 	li $a0, 1
 	li $v0, 1
@@ -123,5 +77,42 @@ main:
 	li $a0, 10
 	li $v0, 11
 	syscall
+_L0:
+# Generating MIPS code for float comparison <
+	l.s $f16, floatA
+	li.s $f18, 12.0
+	li $t0, 1
+	c.lt.s $f16, $f18
+	movf $t0, $zero
+# Generating MIPS code for conditional branch
+	beqz $t0, _L1
+# Generating MIPS code for operation fmul
+	l.s $f16, floatA
+	li.s $f18, 2.0
+	mul.s $f0, $f16, $f18
+# Generating MIPS code for float assignment
+	s.s $f0, floatA
+# Generating MIPS code for assignment (2 TAC instructions)
+	lw $t0, b
+	addi $t1, $t0, 1
+# Generating MIPS code for jump
+# Storing variable b back to memory
+	sw $t1, b
+	j _L0
+_L1:
+# Generating MIPS code for write_float operation
+	l.s $f12, floatA
+	li $v0, 2
+	syscall
+	li $a0, 10
+	li $v0, 11
+	syscall
+# Generating MIPS code for write operation
+	lw $a0, b
+	li $v0, 1
+	syscall
+	li $a0, 10
+	li $v0, 11
+	syscall
 	li $v0, 10
 	syscall
@@ -8,6 +8,17 @@
 #include "optimizer.h"
 #include "codeGenerator.h"
 #include "utils.h"
+#include "intern.h"
+#include "source.h"
+#include "resolve.h"
+#include "stream.h"
+#include "interpreter.h"
+#include "x86Generator.h"
+#include "compile.h"
+#include "server.h"
+#include "cache.h"
+#include "irfile.h"
+#include <time.h>
 
 #define TABLE_SIZE 101
 
@@ -18,11 +29,15 @@ extern int yylineno;
 void yyerror(const char *s);
 void fatalError(const char *s);
 
-ASTNode* root = NULL;
+NodeIndex root = NULL_NODE;
 SymbolTable* symTab = NULL;
 
 %}
 
+%code requires {
+#include "AST.h"
+}
+
 %union 
 {
     int number;
@@ -30,16 +45,18 @@ SymbolTable* symTab = NULL;
     char character;
     char* string;
     char* operator;
-    struct ASTNode* ast;
+    NodeIndex ast;
 }
          
 %token <number> NUMBER       
 %token <float_number> FLOAT_NUMBER
-%token <string> IF ELSE WHILE RETURN WRITE ID TYPE
-%token <operator> ASSIGNOP PLUS MINUS MUL LOGICOP
-%token <character> SEMICOLON '(' ')' '[' ']' '{' '}'
+%token <string> ID TYPE
+%token <operator> ASSIGNOP LOGICOP
+%token IF ELSE WHILE RETURN WRITE PLUS MINUS MUL
+%token SEMICOLON '(' ')' '[' ']' '{' '}'
 %token THEN DO TRUE FALSE
 
+%nonassoc LOGICOP
 %left '+' '-'
 %left '*' '/'
 %nonassoc UMINUS
@@ -54,13 +71,20 @@ SymbolTable* symTab = NULL;
 %% 
 
 Program:
-   VarDeclList Block 
+   VarDeclList
+    {
+        // Streaming compiles statements as they are parsed, so every
+        // variable has to be declared up front
+        if (streamingMode)
+            beginStreaming($1, symTab);
+    }
+   Block 
     {
         printf("Parsed Program\n");
-        root = malloc(sizeof(ASTNode));
-        root->type = NodeType_Program;
-        root->program.varDeclList = $1;
-        root->program.block = $2;
+        root = createNode(NodeType_Program);
+        ASTNode *node = getNode(root);
+        node->program.varDeclList = $1;
+        node->program.block = $3;
     }
     ;
 // FuncDeclList:
@@ -109,19 +133,17 @@ Program:
     
 
 VarDeclList:
-    VarDecl VarDeclList 
+    VarDeclList VarDecl 
     {
-        // Handle recursive variable declaration list.
-        $$ = createNode(NodeType_VarDeclList);
-        $$->varDeclList.varDecl = $1;
-        $$->varDeclList.varDeclList = $2;
+        // Left recursion keeps the parser stack flat; append in place.
+        $$ = $1;
+        appendListItem($$, $2);
     }
     | VarDecl 
     {
         // Handle single variable declaration.
         $$ = createNode(NodeType_VarDeclList);
-        $$->varDeclList.varDecl = $1;
-        $$->varDeclList.varDeclList = NULL;
+        appendListItem($$, $1);
     }
     ;
 
@@ -129,27 +151,17 @@ VarDecl:
     TYPE ID SEMICOLON
     {
         $$ = createNode(NodeType_VarDecl);
-        $$->varDecl.varType = strdup($1);
-        $$->varDecl.varName = strdup($2);
-
-        if (strcmp($1, "float") == 0) {
-            $$->varDecl.isFloat = true;  // Add a flag to indicate float
-        } else {
-            $$->varDecl.isFloat = false;
-        }
+        ASTNode *node = getNode($$);
+        node->dataType = dataTypeFromName($1);
+        node->varDecl.varName = $2;
     }
     | TYPE ID '[' NUMBER ']' SEMICOLON
     {
         $$ = createNode(NodeType_ArrayDecl);
-        $$->arrayDecl.varType = strdup($1);
-        $$->arrayDecl.varName = strdup($2);
-        $$->arrayDecl.size = $4;
-
-        if (strcmp($1, "float") == 0) {
-            $$->arrayDecl.isFloat = true;  // Handle float arrays
-        } else {
-            $$->arrayDecl.isFloat = false;
-        }
+        ASTNode *node = getNode($$);
+        node->dataType = dataTypeFromName($1);
+        node->arrayDecl.varName = $2;
+        node->arrayDecl.size = $4;
     }
     | TYPE ID '[' FLOAT_NUMBER ']' SEMICOLON
     {
@@ -158,6 +170,7 @@ VarDecl:
     | TYPE ID
     {
         printf("Missing semicolon after declaring variable: %s\n", $2);
+        $$ = NULL_NODE;
     }
     ;
 
@@ -166,23 +179,28 @@ Block:
     {
         printf("Parsed Block\n");
         $$ = createNode(NodeType_Block);
-        $$->block.stmtList = $1;
+        getNode($$)->block.stmtList = $1;
     }
     ;
 
 StmtList:
-    Stmt StmtList 
+    StmtList Stmt 
     {
+        // Left recursion keeps the parser stack flat; append in place.
         printf("Parsed Statement List\n");
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_StmtList;
-        $$->stmtList.stmt = $1;
-        $$->stmtList.stmtList = $2;
+        $$ = $1;
+        if ($1 == streamStmtList)
+            streamStatement($2, symTab);
+        else
+            appendListItem($$, $2);
     }
     | /* empty */ 
     {
         printf("Parsed Empty Statement List\n");
-        $$ = NULL;
+        $$ = createNode(NodeType_StmtList);
+        // Nested lists come later, so the first one is the top level
+        if (streamingMode && streamStmtList == NULL_NODE)
+            streamStmtList = $$;
     }
     ;
 
@@ -191,50 +209,61 @@ Stmt:
     {
         printf("Parsed Assignment Statement: %s = ...\n", $1);
 
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_AssignStmt;
-        $$->assignStmt.varName = strdup($1);
-        $$->assignStmt.operator = strdup($2);
-        $$->assignStmt.expr = $3;
+        $$ = createNode(NodeType_AssignStmt);
+        ASTNode *node = getNode($$);
+        node->assignStmt.varName = $1;
+        node->assignStmt.expr = $3;
     }
     | ID '[' Expr ']' ASSIGNOP Expr SEMICOLON
     {
-        if ($3->type == NodeType_SimpleExpr && $3->simpleExpr.isFloat) 
+        if (getNode($3)->type == NodeType_SimpleExpr && getNode($3)->dataType == DataType_Float) 
         {
             fatalError("Array index must be an integer, not a floating-point number.");
         }
-        printf("Parsed Array Assignment: %s[%s] = ...\n", $1, $3);
+        printf("Parsed Array Assignment: %s[...] = ...\n", $1);
         $$ = createNode(NodeType_ArrayAssign);
-        $$->arrayAssign.arrayName = strdup($1);
-        $$->arrayAssign.index = $3;
-        $$->arrayAssign.expr = $6;
+        ASTNode *node = getNode($$);
+        node->arrayAssign.arrayName = $1;
+        node->arrayAssign.index = $3;
+        node->arrayAssign.expr = $6;
     }
     | WRITE Expr SEMICOLON 
     {
-        printf("Parsed Write Statement: %s\n", $2);
+        printf("Parsed Write Statement\n");
         $$ = createNode(NodeType_WriteStmt);
-        $$->writeStmt.expr = $2;
+        getNode($$)->writeStmt.expr = $2;
     }
-    | IF Expr THEN Block ELSE Block 
+    | IF '(' Expr ')' '{' Block '}' ELSE '{' Block '}'
     {
         printf("Parsed If-Else Statement\n");
         $$ = createNode(NodeType_IfStmt);
-        $$->ifStmt.condition = $2;
-        $$->ifStmt.thenBlock = $4;
-        $$->ifStmt.elseBlock = $6;
+        ASTNode *node = getNode($$);
+        node->ifStmt.condition = $3;
+        node->ifStmt.thenBlock = $6;
+        node->ifStmt.elseBlock = $10;
     }
-    | WHILE Expr DO Block 
+    | IF '(' Expr ')' '{' Block '}'
+    {
+        printf("Parsed If Statement\n");
+        $$ = createNode(NodeType_IfStmt);
+        ASTNode *node = getNode($$);
+        node->ifStmt.condition = $3;
+        node->ifStmt.thenBlock = $6;
+        node->ifStmt.elseBlock = NULL_NODE;
+    }
+    | WHILE '(' Expr ')' '{' Block '}'
     {
         printf("Parsed While Statement\n");
         $$ = createNode(NodeType_WhileStmt);
-        $$->whileStmt.condition = $2;
-        $$->whileStmt.block = $4;
+        ASTNode *node = getNode($$);
+        node->whileStmt.condition = $3;
+        node->whileStmt.block = $6;
     }
     | RETURN Expr SEMICOLON 
     {
         printf("Parsed Return Statement\n");
         $$ = createNode(NodeType_ReturnStmt);
-        $$->returnStmt.expr = $2;
+        getNode($$)->returnStmt.expr = $2;
     }
     ;
 
@@ -242,37 +271,38 @@ Expr:
     Expr PLUS Expr 
     {
         printf("PARSER: Recognized addition expression\n");
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_BinOp;
-        $$->binOp.operator = '+';
-        $$->binOp.left = $1;
-        $$->binOp.right = $3;
+        $$ = createNode(NodeType_BinOp);
+        ASTNode *node = getNode($$);
+        node->binOp.operator = '+';
+        node->binOp.left = $1;
+        node->binOp.right = $3;
     }
     | Expr MINUS Expr 
     {
         printf("PARSER: Recognized subtraction expression\n");
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_BinOp;
-        $$->binOp.operator = '-';
-        $$->binOp.left = $1;
-        $$->binOp.right = $3;
+        $$ = createNode(NodeType_BinOp);
+        ASTNode *node = getNode($$);
+        node->binOp.operator = '-';
+        node->binOp.left = $1;
+        node->binOp.right = $3;
     }
     | Expr MUL Expr 
     {
         printf("PARSER: Recognized multiplication expression\n");
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_BinOp;
-        $$->binOp.operator = '*';
-        $$->binOp.left = $1;
-        $$->binOp.right = $3;
+        $$ = createNode(NodeType_BinOp);
+        ASTNode *node = getNode($$);
+        node->binOp.operator = '*';
+        node->binOp.left = $1;
+        node->binOp.right = $3;
     }
     | Expr LOGICOP Expr 
     {
-        printf("Parsed Logical Expression: %s %s %s\n", $1, $2, $3);
+        printf("Parsed Logical Expression: ... %s ...\n", $2);
         $$ = createNode(NodeType_LogicalOp);
-        $$->logicalOp.logicalOp = strdup($2);  // Store the operator string
-        $$->logicalOp.left = $1;
-        $$->logicalOp.right = $3;
+        ASTNode *node = getNode($$);
+        node->logicalOp.logicalOp = $2;  // Store the operator string
+        node->logicalOp.left = $1;
+        node->logicalOp.right = $3;
     }
     | '(' Expr ')' 
     {
@@ -282,50 +312,52 @@ Expr:
     | ID 
     {
         printf("Parsed Identifier: %s\n", $1);
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_SimpleID;
-        $$->simpleID.name = strdup($1);
+        $$ = createNode(NodeType_SimpleID);
+        getNode($$)->simpleID.name = $1;
     } 
     | FLOAT_NUMBER
     {
         printf("Parsed Float Number: %f\n", $1);
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_SimpleExpr;
-        $$->simpleExpr.floatValue = $1;
-        $$->simpleExpr.isFloat = true;
+        $$ = createNode(NodeType_SimpleExpr);
+        ASTNode *node = getNode($$);
+        node->dataType = DataType_Float;
+        node->simpleExpr.floatValue = $1;
     }
     | NUMBER 
     {
         printf("Parsed Number: %d\n", $1);
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_SimpleExpr;
-        $$->simpleExpr.number = $1;
-        $$->simpleExpr.isFloat = false;
+        $$ = createNode(NodeType_SimpleExpr);
+        ASTNode *node = getNode($$);
+        node->dataType = DataType_Int;
+        node->simpleExpr.number = $1;
     }
     | ID '[' Expr ']'
     {
-        if ($3->type == NodeType_SimpleExpr && $3->simpleExpr.isFloat) 
+        if (getNode($3)->type == NodeType_SimpleExpr && getNode($3)->dataType == DataType_Float) 
         {
             fatalError("Array index must be an integer, not a floating-point number.");
         }
-        printf("Parsed Array Access: %s[%s]\n", $1, $3);
+        printf("Parsed Array Access: %s[...]\n", $1);
         $$ = createNode(NodeType_ArrayAccess);
-        $$->arrayAccess.arrayName = strdup($1);
-        $$->arrayAccess.index = $3;
+        ASTNode *node = getNode($$);
+        node->arrayAccess.arrayName = $1;
+        node->arrayAccess.index = $3;
     }
     | TRUE
     {
         printf("Parsed TRUE bool\n");
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_SimpleExpr;
-        $$->simpleExpr.number = 1;
+        $$ = createNode(NodeType_SimpleExpr);
+        ASTNode *node = getNode($$);
+        node->dataType = DataType_Int;
+        node->simpleExpr.number = 1;
     }
     | FALSE
     {
         printf("Parsed FALSE bool\n");
-        $$ = malloc(sizeof(ASTNode));
-        $$->type = NodeType_SimpleExpr;
-        $$->simpleExpr.number = 0;
+        $$ = createNode(NodeType_SimpleExpr);
+        ASTNode *node = getNode($$);
+        node->dataType = DataType_Int;
+        node->simpleExpr.number = 0;
     }
     ;
 
@@ -334,68 +366,466 @@ Expr:
 void yyerror(const char *s) 
 {
     printf("Error: %s\n", s);
-    exit(1);
+    abortCompilation();
 }
 
 void fatalError(const char *s) 
 {
     fprintf(stderr, "Fatal Error at line %d: %s\n", yylineno, s);
-    exit(1);  // Exit the program with a non-zero status
+    abortCompilation();
 }
 
-int main() 
+// Start code generation into the output the options name
+static void beginOutput(const CompileOptions *options)
 {
-    // Initialize the input source
-    yyin = fopen("input.cmm", "r");
+    if (options->output != NULL)
+    {
+        initCodeGeneratorOutput(options->output);
+    }
+    else
+    {
+        initCodeGenerator(options->outputFile);
+    }
+}
 
-    // Initialize symbol table
-    symTab = createSymbolTable(TABLE_SIZE);
-    if (symTab == NULL) 
+int compileSource(SourceBuffer *source, SymbolTable *table, const CompileOptions *options)
+{
+    int status = 0;
+    symTab = table;
+    root = NULL_NODE;
+    setCodeGenTarget(options->target);
+
+    // The scanner reads the source text in place
+    if (!beginSourceScan(source))
     {
-        fprintf(stderr, "Error: Unable to initialize symbol table\n");
-        exit(1);
+        fprintf(stderr, "Error: Unable to scan the source\n");
+        return 1;
     }
 
-    // Initialize temporary variables
-    initializeTempVars();
+    // Start numbering temporaries and labels from zero
+    resetTACGeneration();
+    if (!setOptimizationPipeline(options->passPipeline))
+    {
+        return 1;
+    }
+    resetPassStatistics();
 
-    if (yyparse() == 0) 
+    if (streamingMode)
+    {
+        // Code is generated while parsing; no whole-program TAC is kept
+        beginOutput(options);
+        if (yyparse() == 0)
+        {
+            finishStreaming(symTab);
+            if (options->passStats)
+            {
+                printPassStatistics(stderr);
+            }
+        }
+        else
+        {
+            status = 1;
+        }
+        finalizeCodeGenerator(options->outputFile);
+    }
+    else if (yyparse() == 0) 
     {
         printf("=================Semantic=================\n");
 
-        // Semantic Analysis
-        semanticAnalysis(root, symTab);
+        // Name Resolution and Semantic Analysis
+        resolveNames(root, symTab);
+        semanticAnalysis(getNode(root), symTab);
+
+        if (options->dumpIR)
+        {
+            printTACToFile("TACsem.ir", tacHead, symTab, false);
+        }
+        if (options->emitBinaryIR)
+        {
+            writeBinaryIR("TACsem.tacb", tacHead, symTab, false);
+        }
 
-        printTACToFile("TACsem.ir", tacHead);
+        // Check every optimization pass against the unoptimized program
+        if (options->interpret)
+        {
+            beginPassComparison(symTab);
+            comparePass("semantic analysis", tacHead);
+            setPassObserver(comparePass);
+        }
 
         printf("=================Optimizer=================\n");
         // TAC Optimization
-        optimizeTAC(&tacHead);  // 'tacHead' is the global head of the TAC linked list
+        optimizeTAC(&tacHead, symTab);  // 'tacHead' is the global head of the TAC linked list
+        if (options->passStats)
+        {
+            printPassStatistics(stderr);
+        }
 
-        printTACToFile("TACopt.ir", tacHead);
+        if (options->dumpIR)
+        {
+            printTACToFile("TACopt.ir", tacHead, symTab, true);
+        }
+        if (options->emitBinaryIR)
+        {
+            writeBinaryIR("TACopt.tacb", tacHead, symTab, true);
+        }
         // Optionally print the optimized TAC to console
         // printCurrentOptimizedTAC(&tacHead);
 
-        printf("=================Code Generation=================\n");
+        if (options->interpret)
+        {
+            setPassObserver(NULL);
+            endPassComparison();
+
+            printf("=================Interpreter=================\n");
+            InterpreterStats stats;
+            bool ok = interpretTAC(tacHead, symTab, stdout, INTERPRETER_MAX_STEPS, &stats);
+            fflush(stdout);
+            fprintf(stderr, "Executed %lld TAC instructions (%d in program)\n", stats.executed, stats.instructions);
+            if (!ok)
+            {
+                status = 1;
+            }
+        }
+        else
+        {
+            printf("=================Code Generation=================\n");
+
+            // Code Generation
+            beginOutput(options);
+            generateCode(tacHead, symTab);  // Generate target code from optimized TAC
+            finalizeCodeGenerator(options->outputFile);
+            if (options->dumpIR)
+            {
+                printTACToFile("TACgen.ir", tacHead, symTab, true);
+            }
+        }
+    }
+    else
+    {
+        status = 1;
+    }
 
-        // Code Generation
-        initCodeGenerator("output.asm");
-        generateMIPS(tacHead, symTab);  // Generate MIPS code from optimized TAC
-        finalizeCodeGenerator("output.asm");
-        printTACToFile("TACgen.ir", tacHead);
+    // Print the AST
+    if (root != NULL_NODE) 
+    {
+        printf("Starting to free AST\n");
+        traverseAST(root, 0);
+    }
+    return status;
+}
+
+static double secondsNow()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int compileIRFile(const char *path, SymbolTable *table, const CompileOptions *options)
+{
+    int status = 0;
+    symTab = table;
+    setCodeGenTarget(options->target);
+    resetTACGeneration();
+    if (!setOptimizationPipeline(options->passPipeline))
+    {
+        return 1;
+    }
+    resetPassStatistics();
+
+    double start = secondsNow();
+    bool alreadyOptimized = false;
+    tacHead = loadIRFile(path, symTab, &alreadyOptimized);
+    if (tacHead == NULL)
+    {
+        return 1;
     }
+    double loaded = secondsNow();
 
+    printf("=================Optimizer=================\n");
+    // Optimized IR only goes through the optimizer again when a pipeline is asked for
+    if (alreadyOptimized && options->passPipeline == NULL)
+    {
+        printf("%s is already optimized\n", path);
+    }
+    else
+    {
+        optimizeTAC(&tacHead, symTab);
+    }
+    if (options->passStats)
+    {
+        printPassStatistics(stderr);
+    }
+    double optimized = secondsNow();
+
+    if (options->interpret)
+    {
+        printf("=================Interpreter=================\n");
+        InterpreterStats stats;
+        bool ok = interpretTAC(tacHead, symTab, stdout, INTERPRETER_MAX_STEPS, &stats);
+        fflush(stdout);
+        fprintf(stderr, "Executed %lld TAC instructions (%d in program)\n", stats.executed, stats.instructions);
+        if (!ok)
+        {
+            status = 1;
+        }
+    }
+    else
+    {
+        printf("=================Code Generation=================\n");
+        beginOutput(options);
+        generateCode(tacHead, symTab);
+        finalizeCodeGenerator(options->outputFile);
+        if (options->dumpIR)
+        {
+            printTACToFile("TACgen.ir", tacHead, symTab, true);
+        }
+    }
+    double generated = secondsNow();
+
+    fprintf(stderr, "%s: load %.3f ms, optimize %.3f ms, %s %.3f ms\n", path,
+            (loaded - start) * 1000.0, (optimized - loaded) * 1000.0,
+            options->interpret ? "interpret" : "codegen", (generated - optimized) * 1000.0);
+    return status;
+}
+
+void resetCompileState(SymbolTable *table)
+{
     freeTACList(tacHead);
+    tacHead = NULL;
+    setPassObserver(NULL);
+    resetCodeGenerator();
+    releaseNodesFrom(1);
+    root = NULL_NODE;
+    resetSymbolTable(table);
+    endSourceScan();
+}
 
-    // Traverse and free the AST
-    if (root != NULL) 
+int main(int argc, char **argv) 
+{
+    // --stream compiles statement by statement in bounded memory;
+    // --interpret runs the optimized TAC instead of generating MIPS;
+    // --target=x86-64 writes x86-64 assembly to output.s;
+    // --serve keeps the compiler running as a compile server;
+    // --cache[=dir] reuses the output of earlier identical compiles;
+    // --emit-ir also writes TACsem.tacb and TACopt.tacb;
+    // --load-ir=file compiles saved IR (binary or a text dump) instead of input.cmm;
+    // -O0/-O1/-O2/-Os or --passes=pipeline choose the optimizer passes
+    CompileOptions options = {false, true, &mipsTarget, "output.asm", NULL, false, NULL, false};
+    const char *socketPath = NULL;
+    const char *irPath = NULL;
+    char *pipelineText = NULL;
+    const char *cacheDir = NULL;
+    long long cacheBytes = DEFAULT_CACHE_MAX_BYTES;
+    bool cacheStats = false;
+    for (int i = 1; i < argc; i++)
     {
-        printf("Starting to free AST\n");
-        traverseAST(root, 0);
-        freeAST(root);
+        if (strcmp(argv[i], "--stream") == 0)
+        {
+            streamingMode = true;
+        }
+        else if (strcmp(argv[i], "--interpret") == 0)
+        {
+            options.interpret = true;
+        }
+        else if (strcmp(argv[i], "--target=mips") == 0)
+        {
+            options.target = &mipsTarget;
+            options.outputFile = "output.asm";
+        }
+        else if (strcmp(argv[i], "--target=x86-64") == 0)
+        {
+            options.target = &x86Target;
+            options.outputFile = "output.s";
+        }
+        else if (strcmp(argv[i], "--serve") == 0)
+        {
+            socketPath = COMPILE_SERVER_SOCKET;
+        }
+        else if (strncmp(argv[i], "--serve=", 8) == 0)
+        {
+            socketPath = argv[i] + 8;
+        }
+        else if (strcmp(argv[i], "--cache") == 0)
+        {
+            cacheDir = DEFAULT_CACHE_DIR;
+        }
+        else if (strncmp(argv[i], "--cache=", 8) == 0)
+        {
+            cacheDir = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--cache-size=", 13) == 0)
+        {
+            // Megabytes
+            cacheBytes = atoll(argv[i] + 13) * 1024 * 1024;
+        }
+        else if (strcmp(argv[i], "--cache-stats") == 0)
+        {
+            cacheStats = true;
+        }
+        else if (strcmp(argv[i], "--emit-ir") == 0)
+        {
+            options.emitBinaryIR = true;
+        }
+        else if (strncmp(argv[i], "--load-ir=", 10) == 0)
+        {
+            irPath = argv[i] + 10;
+        }
+        else if (strcmp(argv[i], "--no-optimize") == 0)
+        {
+            options.passPipeline = optimizationLevelPipeline("0");
+        }
+        else if (strncmp(argv[i], "-O", 2) == 0 && optimizationLevelPipeline(argv[i] + 2) != NULL)
+        {
+            options.passPipeline = optimizationLevelPipeline(argv[i] + 2);
+        }
+        else if (strncmp(argv[i], "--passes=@", 10) == 0)
+        {
+            // A pipeline saved to a file, such as a cmmtune preset
+            free(pipelineText);
+            pipelineText = readPipelineFile(argv[i] + 10);
+            if (pipelineText == NULL)
+            {
+                exit(1);
+            }
+            options.passPipeline = pipelineText;
+        }
+        else if (strncmp(argv[i], "--passes=", 9) == 0)
+        {
+            options.passPipeline = argv[i] + 9;
+        }
+        else if (strcmp(argv[i], "--pass-stats") == 0)
+        {
+            options.passStats = true;
+        }
+        else if (strcmp(argv[i], "--list-passes") == 0)
+        {
+            printPassRegistry(stdout);
+            return 0;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--stream | --interpret] [--target=mips | --target=x86-64] [--serve[=socket]]\n"
+                            "       [--cache[=dir]] [--cache-size=MB] [--cache-stats]\n"
+                            "       [--emit-ir] [--load-ir=file] [--no-optimize]\n"
+                            "       [-O0 | -O1 | -O2 | -Os | --passes=pipeline | --passes=@file] [--pass-stats] [--list-passes]\n", argv[0]);
+            exit(1);
+        }
     }
+    if (streamingMode && options.interpret)
+    {
+        fprintf(stderr, "Error: --stream and --interpret cannot be combined\n");
+        exit(1);
+    }
+    if (streamingMode && options.target != &mipsTarget)
+    {
+        fprintf(stderr, "Error: --stream only generates MIPS\n");
+        exit(1);
+    }
+    if (socketPath != NULL && (streamingMode || options.interpret))
+    {
+        fprintf(stderr, "Error: --serve cannot be combined with --stream or --interpret\n");
+        exit(1);
+    }
+    if (streamingMode && (irPath != NULL || options.emitBinaryIR))
+    {
+        fprintf(stderr, "Error: --stream keeps no whole-program IR to save or load\n");
+        exit(1);
+    }
+    if (options.passPipeline != NULL && !setOptimizationPipeline(options.passPipeline))
+    {
+        exit(1);
+    }
+    if (irPath != NULL && (socketPath != NULL || cacheDir != NULL))
+    {
+        fprintf(stderr, "Error: --load-ir cannot be combined with --serve or --cache\n");
+        exit(1);
+    }
+
+    // --cache-stats only reports on the cache
+    if (cacheStats)
+    {
+        CompileCache *cache = openCompileCache(cacheDir ? cacheDir : DEFAULT_CACHE_DIR, cacheBytes);
+        if (cache == NULL)
+        {
+            exit(1);
+        }
+        printCacheStats(cache, stdout);
+        closeCompileCache(cache);
+        return 0;
+    }
+
+    // Initialize symbol table
+    symTab = createSymbolTable(TABLE_SIZE);
+    if (symTab == NULL) 
+    {
+        fprintf(stderr, "Error: Unable to initialize symbol table\n");
+        exit(1);
+    }
+
+    int status = 0;
+    if (socketPath != NULL)
+    {
+        status = runCompileServer(socketPath, symTab);
+    }
+    else if (irPath != NULL)
+    {
+        status = compileIRFile(irPath, symTab, &options);
+        resetCompileState(symTab);
+    }
+    else
+    {
+        // Initialize the input source; the scanner reads the file in place
+        SourceBuffer *source = openSourceFile("input.cmm");
+        if (source == NULL)
+        {
+            fprintf(stderr, "Error: Unable to open input.cmm\n");
+            exit(1);
+        }
+
+        // The interpreter's output is the program's, and pass statistics
+        // describe this run, so neither is ever cached
+        CompileCache *cache = NULL;
+        char key[CACHE_KEY_LENGTH + 1];
+        if (cacheDir != NULL && !options.interpret && !options.passStats)
+        {
+            // The pipeline has no length limit, so it is hashed as a key part of its own
+            char optionString[128];
+            snprintf(optionString, sizeof(optionString), "target=%s stream=%d emit-ir=%d",
+                     options.target->name, streamingMode, options.emitBinaryIR);
+            cache = openCompileCache(cacheDir, cacheBytes);
+            if (cache != NULL)
+            {
+                computeCacheKey(source, optionString,
+                                options.passPipeline ? options.passPipeline : optimizationLevelPipeline("2"), key);
+            }
+        }
 
+        if (cache != NULL && restoreCacheEntry(cache, key))
+        {
+            // A hit skips parsing, analysis, optimization and code generation
+            printf("Cache hit: %s restored from %s\n", options.outputFile, cacheDir);
+        }
+        else
+        {
+            status = compileSource(source, symTab, &options);
+            if (cache != NULL && status == 0)
+            {
+                // Streaming compiles write no TAC dumps
+                const char *files[] = {options.outputFile, "TACsem.ir", "TACopt.ir", "TACgen.ir", "TACsem.tacb", "TACopt.tacb"};
+                storeCacheEntry(cache, key, files, streamingMode ? 1 : options.emitBinaryIR ? 6 : 4);
+            }
+        }
+        closeCompileCache(cache);
+        resetCompileState(symTab);
+        closeSourceFile(source);
+    }
+
+    freeAST();
     freeSymbolTable(symTab);
-    fclose(yyin);
-    return 0;
+    freeInternTable();
+    free(pipelineText);
+    return status;
 }
+
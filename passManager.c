@@ -0,0 +1,372 @@
+#include "passManager.h"
+#include "optimizer.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <time.h>
+
+// Adapters for the passes that do not need the symbol table
+static int runConstantFolding(TAC **head, SymbolTable *symTab) { (void)symTab; return constantFolding(head); }
+static int runSparseConstantPropagation(TAC **head, SymbolTable *symTab) { (void)symTab; return sparseConditionalConstantPropagation(head); }
+static int runConstantPropagation(TAC **head, SymbolTable *symTab) { (void)symTab; return constantPropagation(head); }
+static int runArrayStoreForwarding(TAC **head, SymbolTable *symTab) { (void)symTab; return arrayStoreForwarding(head); }
+static int runDeadArrayStoreElimination(TAC **head, SymbolTable *symTab) { (void)symTab; return deadArrayStoreElimination(head); }
+static int runCopyPropagation(TAC **head, SymbolTable *symTab) { (void)symTab; return copyPropagation(head); }
+static int runDeadCodeElimination(TAC **head, SymbolTable *symTab) { (void)symTab; return deadCodeElimination(head); }
+
+static const PassInfo passRegistry[] = {
+    {"scalar-replace", "scalar replacement", scalarReplaceArrays, PASS_WHOLE_PROGRAM},
+    {"fold", "constant folding", runConstantFolding, 0},
+    {"sccp", "sparse constant propagation", runSparseConstantPropagation, 0},
+    {"const-prop", "constant propagation", runConstantPropagation, 0},
+    {"store-forward", "array store forwarding", runArrayStoreForwarding, 0},
+    {"dead-store", "dead array store elimination", runDeadArrayStoreElimination, PASS_PROGRAM_END},
+    {"copy-prop", "copy propagation", runCopyPropagation, 0},
+    {"dce", "dead code elimination", runDeadCodeElimination, 0},
+    {"static-data", "static data initialization", staticDataInitialization, PASS_PROGRAM_START},
+};
+#define PASS_COUNT (int)(sizeof(passRegistry) / sizeof(passRegistry[0]))
+
+// -O0 generates code straight from the front end's TAC; -O1 makes one
+// sweep of the cheap local passes; -O2 iterates every pass to a fixed
+// point. -Os leaves out scalar replacement, which gives each replaced
+// element a .data word of its own without shortening the .text.
+#define O2_PIPELINE "scalar-replace,{fold,sccp,const-prop,store-forward,dead-store,copy-prop,dce},static-data"
+#define OS_PIPELINE "{fold,sccp,const-prop,store-forward,dead-store,copy-prop,dce},static-data"
+
+static const struct
+{
+    const char *level;
+    const char *pipeline;
+} optimizationLevels[] = {
+    {"0", ""},
+    {"1", "fold,const-prop,copy-prop,dce"},
+    {"2", O2_PIPELINE},
+    {"s", OS_PIPELINE},
+};
+
+static Pipeline currentPipeline;
+static bool pipelineSet = false;
+
+static PassObserver passObserver = NULL;
+
+// Statistics since the last reset
+static long long passRuns[PASS_COUNT];
+static long long passChanges[PASS_COUNT];
+static long long passExhausted[PASS_COUNT]; // Runs skipped for lack of budget
+static double passSeconds[PASS_COUNT];
+static long long *iterationRuns = NULL;     // Indexed by iteration within a group
+static long long *iterationChanges = NULL;
+static double *iterationSeconds = NULL;
+static int iterationCapacity = 0;
+static int iterationCount = 0;
+static long long pipelineRuns = 0;
+static long long unconvergedGroups = 0;
+static double pipelineSeconds = 0.0;
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void setPassObserver(PassObserver observer)
+{
+    passObserver = observer;
+}
+
+const PassInfo *findPass(const char *name)
+{
+    for (int i = 0; i < PASS_COUNT; i++)
+    {
+        if (strcmp(passRegistry[i].name, name) == 0)
+            return &passRegistry[i];
+    }
+    return NULL;
+}
+
+void printPassRegistry(FILE *out)
+{
+    fprintf(out, "Passes:\n");
+    for (int i = 0; i < PASS_COUNT; i++)
+        fprintf(out, "  %-16s %s\n", passRegistry[i].name, passRegistry[i].description);
+    fprintf(out, "Levels:\n");
+    for (size_t i = 0; i < sizeof(optimizationLevels) / sizeof(optimizationLevels[0]); i++)
+        fprintf(out, "  -O%s %s\n", optimizationLevels[i].level, optimizationLevels[i].pipeline);
+}
+
+char *readPipelineFile(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    // Join the lines that are not comments, dropping whitespace
+    size_t length = 0, capacity = 256;
+    char *description = (char *)malloc(capacity);
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] == '#')
+            continue;
+        for (char *c = line; *c != '\0'; c++)
+        {
+            if (isspace((unsigned char)*c))
+                continue;
+            if (length + 2 > capacity)
+            {
+                capacity *= 2;
+                description = (char *)realloc(description, capacity);
+            }
+            description[length++] = *c;
+        }
+    }
+    description[length] = '\0';
+    fclose(file);
+    return description;
+}
+
+const char *optimizationLevelPipeline(const char *level)
+{
+    for (size_t i = 0; i < sizeof(optimizationLevels) / sizeof(optimizationLevels[0]); i++)
+    {
+        if (strcmp(optimizationLevels[i].level, level) == 0)
+            return optimizationLevels[i].pipeline;
+    }
+    return NULL;
+}
+
+static bool pipelineError(const char *description, const char *at, const char *message)
+{
+    fprintf(stderr, "Error: %s at column %d of pipeline \"%s\"\n", message, (int)(at - description) + 1, description);
+    return false;
+}
+
+// Read a positive decimal number; NULL if there is none
+static const char *parseCount(const char *p, int *count)
+{
+    if (!isdigit((unsigned char)*p))
+        return NULL;
+    long value = 0;
+    while (isdigit((unsigned char)*p))
+    {
+        value = value * 10 + (*p++ - '0');
+        if (value > PASS_DEFAULT_BUDGET)
+            return NULL;
+    }
+    if (value == 0)
+        return NULL;
+    *count = (int)value;
+    return p;
+}
+
+bool parsePipeline(const char *description, Pipeline *pipeline)
+{
+    pipeline->stepCount = 0;
+    pipeline->groupCount = 0;
+    int group = -1;
+    const char *p = description;
+    while (*p != '\0')
+    {
+        if (*p == ' ' || *p == ',')
+        {
+            p++;
+        }
+        else if (*p == '{')
+        {
+            if (group >= 0)
+                return pipelineError(description, p, "Nested pass group");
+            group = pipeline->groupCount++;
+            pipeline->groups[group].first = pipeline->stepCount;
+            pipeline->groups[group].count = 0;
+            pipeline->groups[group].maxIterations = PIPELINE_MAX_ITERATIONS;
+            p++;
+        }
+        else if (*p == '}')
+        {
+            if (group < 0)
+                return pipelineError(description, p, "Unmatched '}'");
+            PipelineGroup *current = &pipeline->groups[group];
+            current->count = pipeline->stepCount - current->first;
+            if (current->count == 0)
+                return pipelineError(description, p, "Empty pass group");
+            const char *end = p++;
+            if (*p == '*' && (p = parseCount(p + 1, &current->maxIterations)) == NULL)
+                return pipelineError(description, end, "Bad iteration limit");
+            group = -1;
+        }
+        else
+        {
+            char name[32];
+            size_t length = 0;
+            const char *start = p;
+            while (isalnum((unsigned char)*p) || *p == '-')
+            {
+                if (length + 1 < sizeof(name))
+                    name[length++] = *p;
+                p++;
+            }
+            name[length] = '\0';
+            const PassInfo *pass = length > 0 ? findPass(name) : NULL;
+            if (pass == NULL)
+                return pipelineError(description, start, "Unknown pass");
+            if (pipeline->stepCount == PIPELINE_MAX_STEPS)
+                return pipelineError(description, start, "Too many passes");
+
+            PipelineStep *step = &pipeline->steps[pipeline->stepCount++];
+            step->pass = pass;
+            step->budget = PASS_DEFAULT_BUDGET;
+            step->group = group;
+            if (*p == ':' && (p = parseCount(p + 1, &step->budget)) == NULL)
+                return pipelineError(description, start, "Bad change budget");
+        }
+    }
+    if (group >= 0)
+        return pipelineError(description, p, "Unclosed pass group");
+    return true;
+}
+
+bool setOptimizationPipeline(const char *description)
+{
+    Pipeline pipeline;
+    if (!parsePipeline(description != NULL ? description : O2_PIPELINE, &pipeline))
+        return false;
+    currentPipeline = pipeline;
+    pipelineSet = true;
+    return true;
+}
+
+static void recordIteration(int iteration, int changes, double seconds)
+{
+    if (iteration == iterationCapacity)
+    {
+        iterationCapacity = iterationCapacity ? iterationCapacity * 2 : 16;
+        iterationRuns = (long long *)realloc(iterationRuns, sizeof(long long) * iterationCapacity);
+        iterationChanges = (long long *)realloc(iterationChanges, sizeof(long long) * iterationCapacity);
+        iterationSeconds = (double *)realloc(iterationSeconds, sizeof(double) * iterationCapacity);
+    }
+    if (iteration == iterationCount)
+    {
+        iterationRuns[iteration] = 0;
+        iterationChanges[iteration] = 0;
+        iterationSeconds[iteration] = 0.0;
+        iterationCount++;
+    }
+    iterationRuns[iteration]++;
+    iterationChanges[iteration] += changes;
+    iterationSeconds[iteration] += seconds;
+}
+
+// Run one step unless it is excluded or out of budget
+static int runStep(const PipelineStep *step, int *remaining, TAC **head, SymbolTable *symTab, int skipFlags)
+{
+    const PassInfo *pass = step->pass;
+    int index = (int)(pass - passRegistry);
+    if (pass->flags & skipFlags)
+        return 0;
+    if (*remaining <= 0)
+    {
+        passExhausted[index]++;
+        return 0;
+    }
+
+    double start = now();
+    int changes = pass->run(head, symTab);
+    passSeconds[index] += now() - start;
+    passRuns[index]++;
+    passChanges[index] += changes;
+
+    // The list head is read only once the pass has run
+    if (changes > 0 && passObserver != NULL)
+        passObserver(pass->description, *head);
+
+    *remaining -= changes;
+    if (*remaining <= 0)
+        fprintf(stderr, "Warning: Pass %s used up its budget of %d changes\n", pass->name, step->budget);
+    return changes;
+}
+
+void runPassPipeline(TAC **head, SymbolTable *symTab, int skipFlags)
+{
+    if (!pipelineSet)
+        setOptimizationPipeline(NULL);
+    const Pipeline *pipeline = &currentPipeline;
+    double start = now();
+
+    int remaining[PIPELINE_MAX_STEPS];
+    for (int i = 0; i < pipeline->stepCount; i++)
+        remaining[i] = pipeline->steps[i].budget;
+
+    int i = 0;
+    while (i < pipeline->stepCount)
+    {
+        if (pipeline->steps[i].group < 0)
+        {
+            runStep(&pipeline->steps[i], &remaining[i], head, symTab, skipFlags);
+            i++;
+            continue;
+        }
+
+        // Repeat the group until an iteration changes nothing
+        const PipelineGroup *group = &pipeline->groups[pipeline->steps[i].group];
+        int iteration = 0;
+        int changes;
+        do
+        {
+            double iterationStart = now();
+            changes = 0;
+            for (int s = group->first; s < group->first + group->count; s++)
+                changes += runStep(&pipeline->steps[s], &remaining[s], head, symTab, skipFlags);
+            recordIteration(iteration, changes, now() - iterationStart);
+            iteration++;
+        } while (changes > 0 && iteration < group->maxIterations);
+
+        if (changes > 0)
+        {
+            fprintf(stderr, "Warning: Pass group did not converge after %d iterations\n", group->maxIterations);
+            unconvergedGroups++;
+        }
+        i = group->first + group->count;
+    }
+
+    pipelineRuns++;
+    pipelineSeconds += now() - start;
+}
+
+void resetPassStatistics()
+{
+    memset(passRuns, 0, sizeof(passRuns));
+    memset(passChanges, 0, sizeof(passChanges));
+    memset(passExhausted, 0, sizeof(passExhausted));
+    memset(passSeconds, 0, sizeof(passSeconds));
+    iterationCount = 0;
+    pipelineRuns = 0;
+    unconvergedGroups = 0;
+    pipelineSeconds = 0.0;
+}
+
+void printPassStatistics(FILE *out)
+{
+    fprintf(out, "Pass statistics (%lld pipeline runs, %.3f ms):\n", pipelineRuns, pipelineSeconds * 1000.0);
+    fprintf(out, "  %-16s %8s %10s %12s\n", "pass", "runs", "changes", "time (ms)");
+    for (int i = 0; i < PASS_COUNT; i++)
+    {
+        if (passRuns[i] == 0 && passExhausted[i] == 0)
+            continue;
+        fprintf(out, "  %-16s %8lld %10lld %12.3f", passRegistry[i].name, passRuns[i], passChanges[i], passSeconds[i] * 1000.0);
+        if (passExhausted[i] > 0)
+            fprintf(out, "  (%lld runs skipped, budget spent)", passExhausted[i]);
+        fprintf(out, "\n");
+    }
+    for (int i = 0; i < iterationCount; i++)
+    {
+        fprintf(out, "  iteration %-6d %8lld %10lld %12.3f\n", i + 1, iterationRuns[i], iterationChanges[i],
+                iterationSeconds[i] * 1000.0);
+    }
+    if (unconvergedGroups > 0)
+        fprintf(out, "  %lld pass group runs did not converge\n", unconvergedGroups);
+}
@@ -0,0 +1,96 @@
+#ifndef PASSMANAGER_H
+#define PASSMANAGER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "semantic.h"
+#include "SymbolTable.h"
+
+// The optimizer runs a pipeline of named passes. A pipeline description
+// is a comma-separated list of pass names; passes in braces form a group
+// that is repeated until an iteration changes nothing, at most
+// PIPELINE_MAX_ITERATIONS times unless the group is written {...}*N. A
+// pass written name:N may make at most N changes in one run of the
+// pipeline and is skipped once its budget is spent. For example the -O2
+// preset is
+//
+//   scalar-replace,{fold,sccp,const-prop,store-forward,dead-store,copy-prop,dce},static-data
+#define PIPELINE_MAX_ITERATIONS 64
+#define PIPELINE_MAX_STEPS 64
+#define PASS_DEFAULT_BUDGET 1000000
+
+// Pass properties that decide whether a pass may run on a streamed window
+#define PASS_WHOLE_PROGRAM 1 // Needs every instruction of the program
+#define PASS_PROGRAM_END 2   // Assumes no code follows the list
+#define PASS_PROGRAM_START 4 // Assumes the list starts the program
+
+// A pass returns the number of changes it made
+typedef int (*PassFunction)(TAC **head, SymbolTable *symTab);
+
+typedef struct
+{
+    const char *name;        // Name used in pipeline descriptions
+    const char *description; // Name shown to the pass observer and in statistics
+    PassFunction run;
+    int flags;               // PASS_* properties
+} PassInfo;
+
+typedef struct
+{
+    const PassInfo *pass;
+    int budget;    // Changes allowed per run of the pipeline
+    int group;     // Index of the enclosing group, or -1
+} PipelineStep;
+
+typedef struct
+{
+    int first;         // First step of the group
+    int count;         // Number of steps in the group
+    int maxIterations;
+} PipelineGroup;
+
+typedef struct
+{
+    PipelineStep steps[PIPELINE_MAX_STEPS];
+    int stepCount;
+    PipelineGroup groups[PIPELINE_MAX_STEPS];
+    int groupCount;
+} Pipeline;
+
+// Called after every pass that changed the list
+typedef void (*PassObserver)(const char *passName, TAC *head);
+void setPassObserver(PassObserver observer);
+
+// Look up a registered pass by name; NULL if there is none
+const PassInfo *findPass(const char *name);
+
+// Print the registered passes and the optimization levels' pipelines
+void printPassRegistry(FILE *out);
+
+// Read a pipeline saved in a file (as written by cmmtune): lines starting
+// with '#' are comments and the rest are joined. Returns a malloc'd
+// description, or NULL if the file cannot be read.
+char *readPipelineFile(const char *path);
+
+// Pipeline description of an optimization level ("0", "1", "2" or "s");
+// NULL for an unknown level
+const char *optimizationLevelPipeline(const char *level);
+
+// Parse a pipeline description, printing an error and returning false if
+// it is malformed
+bool parsePipeline(const char *description, Pipeline *pipeline);
+
+// Use the given description (NULL for -O2) for the following runs;
+// false if it does not parse
+bool setOptimizationPipeline(const char *description);
+
+// Run the current pipeline over a list. skipFlags holds the PASS_*
+// properties a pass must not have to run (used for streamed windows).
+void runPassPipeline(TAC **head, SymbolTable *symTab, int skipFlags);
+
+// Per-pass and per-iteration statistics, accumulated over every run since
+// the last reset
+void resetPassStatistics();
+void printPassStatistics(FILE *out);
+
+#endif // PASSMANAGER_H
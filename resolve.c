@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "resolve.h"
+#include "utils.h"
+
+static void declare(ASTNode *node, SymbolTable *symTab)
+{
+    if (node == NULL)
+        return;
+
+    if (node->type == NodeType_VarDecl)
+    {
+        // Check for valid
+        if (node->dataType == DataType_Unknown)
+        {
+            fprintf(stderr, "Semantic error: Invalid type for %s\n", node->varDecl.varName);
+        }
+        else if (findSymbol(symTab, node->varDecl.varName) != NULL)
+        {
+            fprintf(stderr, "Semantic error: Variable %s is already declared\n", node->varDecl.varName);
+        }
+        else
+        {
+            // For simple variable declarations, isArray is false, arrayInfo is NULL
+            node->symbol = insertSymbol(symTab, node->varDecl.varName, node->dataType, false, NULL)->id;
+        }
+    }
+    else if (node->type == NodeType_ArrayDecl)
+    {
+        if (node->dataType == DataType_Unknown)
+        {
+            fprintf(stderr, "Semantic error: Invalid type for %s\n", node->arrayDecl.varName);
+        }
+        else if (findSymbol(symTab, node->arrayDecl.varName) != NULL)
+        {
+            fprintf(stderr, "Semantic error: Array %s is already declared\n", node->arrayDecl.varName);
+            abortCompilation();
+        }
+        else
+        {
+            Array *arrayInfo = createArray(node->dataType, node->arrayDecl.size);
+            node->symbol = insertSymbol(symTab, node->arrayDecl.varName, node->dataType, true, arrayInfo)->id;
+        }
+    }
+}
+
+// Bind a name to the symbol it refers to (NO_SYMBOL if undeclared)
+static uint32_t bind(SymbolTable *symTab, const char *name)
+{
+    Symbol *symbol = findSymbol(symTab, name);
+    return symbol != NULL ? (uint32_t)symbol->id : NO_SYMBOL;
+}
+
+static void resolveNode(NodeIndex index, SymbolTable *symTab)
+{
+    ASTNode *node = getNode(index);
+    if (node == NULL)
+        return;
+
+    switch (node->type)
+    {
+    case NodeType_Program:
+        resolveNode(node->program.varDeclList, symTab);
+        resolveNode(node->program.block, symTab);
+        break;
+    case NodeType_VarDeclList:
+        for (int i = 0; i < node->varDeclList.count; i++)
+        {
+            declare(getNode(node->varDeclList.items[i]), symTab);
+        }
+        break;
+    case NodeType_StmtList:
+        for (int i = 0; i < node->stmtList.count; i++)
+        {
+            resolveNode(node->stmtList.items[i], symTab);
+        }
+        break;
+    case NodeType_Block:
+        resolveNode(node->block.stmtList, symTab);
+        break;
+    case NodeType_SimpleID:
+        node->symbol = bind(symTab, node->simpleID.name);
+        break;
+    case NodeType_AssignStmt:
+        node->symbol = bind(symTab, node->assignStmt.varName);
+        resolveNode(node->assignStmt.expr, symTab);
+        break;
+    case NodeType_ArrayAssign:
+        node->symbol = bind(symTab, node->arrayAssign.arrayName);
+        resolveNode(node->arrayAssign.index, symTab);
+        resolveNode(node->arrayAssign.expr, symTab);
+        break;
+    case NodeType_ArrayAccess:
+        node->symbol = bind(symTab, node->arrayAccess.arrayName);
+        resolveNode(node->arrayAccess.index, symTab);
+        break;
+    case NodeType_BinOp:
+        resolveNode(node->binOp.left, symTab);
+        resolveNode(node->binOp.right, symTab);
+        break;
+    case NodeType_LogicalOp:
+        resolveNode(node->logicalOp.left, symTab);
+        resolveNode(node->logicalOp.right, symTab);
+        break;
+    case NodeType_WriteStmt:
+        resolveNode(node->writeStmt.expr, symTab);
+        break;
+    case NodeType_ReturnStmt:
+        resolveNode(node->returnStmt.expr, symTab);
+        break;
+    case NodeType_IfStmt:
+        resolveNode(node->ifStmt.condition, symTab);
+        resolveNode(node->ifStmt.thenBlock, symTab);
+        resolveNode(node->ifStmt.elseBlock, symTab);
+        break;
+    case NodeType_WhileStmt:
+        resolveNode(node->whileStmt.condition, symTab);
+        resolveNode(node->whileStmt.block, symTab);
+        break;
+    default:
+        // Declarations and literals have nothing to resolve here
+        break;
+    }
+}
+
+void resolveNames(NodeIndex root, SymbolTable *symTab)
+{
+    resolveNode(root, symTab);
+}
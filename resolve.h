@@ -0,0 +1,14 @@
+#ifndef RESOLVE_H
+#define RESOLVE_H
+
+#include "AST.h"
+#include "SymbolTable.h"
+
+// Enter every declaration into the symbol table and bind each declaration
+// and each use of a name (SimpleID, AssignStmt, ArrayAssign, ArrayAccess)
+// to its symbol id in ASTNode::symbol. Later phases read the binding
+// instead of looking names up again; a use of an undeclared name stays
+// NO_SYMBOL and is reported by semantic analysis.
+void resolveNames(NodeIndex root, SymbolTable *symTab);
+
+#endif // RESOLVE_H
@@ -0,0 +1,471 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "parser.tab.h"
+#include "intern.h"
+#include "source.h"
+
+// Hand-written replacement for the flex scanner in lexer.l. It returns the
+// same token stream (including the trace output and the handling of stray
+// characters) but classifies identifier, number, blank and comment runs a
+// whole vector at a time. Build with `make SCANNER=simd` to link it instead
+// of lex.yy.o; compile with -mavx2 for 32-byte vectors, and define
+// SCANNER_SCALAR to force the byte-at-a-time fallback.
+
+#if defined(SCANNER_SCALAR)
+#define SCANNER_VECTOR_WIDTH 0
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SCANNER_VECTOR_WIDTH 32
+typedef __m256i Vector;
+#define loadVector(p) _mm256_loadu_si256((const __m256i *)(p))
+#define splatVector(c) _mm256_set1_epi8((char)(c))
+#define equalBytes(a, b) _mm256_cmpeq_epi8(a, b)
+#define greaterBytes(a, b) _mm256_cmpgt_epi8(a, b)
+#define andVector(a, b) _mm256_and_si256(a, b)
+#define orVector(a, b) _mm256_or_si256(a, b)
+#define vectorMask(v) ((uint32_t)_mm256_movemask_epi8(v))
+#define FULL_MASK 0xFFFFFFFFu
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCANNER_VECTOR_WIDTH 16
+typedef __m128i Vector;
+#define loadVector(p) _mm_loadu_si128((const __m128i *)(p))
+#define splatVector(c) _mm_set1_epi8((char)(c))
+#define equalBytes(a, b) _mm_cmpeq_epi8(a, b)
+#define greaterBytes(a, b) _mm_cmpgt_epi8(a, b)
+#define andVector(a, b) _mm_and_si128(a, b)
+#define orVector(a, b) _mm_or_si128(a, b)
+#define vectorMask(v) ((uint32_t)_mm_movemask_epi8(v))
+#define FULL_MASK 0xFFFFu
+#else
+#define SCANNER_VECTOR_WIDTH 0
+#endif
+
+// Interface shared with the flex scanner
+FILE *yyin = NULL;
+int yylineno = 1;
+int lexerVerbose = 1;
+
+static int words = 0;
+static int chars = 0;
+static int lines = 0;
+
+// Current input: [cursor, limit) is still to be scanned
+static const char *cursor = NULL;
+static const char *limit = NULL;
+static char *ownedText = NULL; // Buffer filled by yyrestart, if any
+
+#define TRACE_TOKEN(start, length, kind) \
+    do { if (lexerVerbose) printf("%.*s : %s\n", (int)(length), start, kind); } while (0)
+
+typedef enum
+{
+    CLASS_ALNUM, // [a-zA-Z0-9], the tail of an identifier
+    CLASS_DIGIT, // [0-9]
+    CLASS_BLANK  // [ \t\n]
+} CharClass;
+
+static int isInClass(unsigned char c, CharClass charClass)
+{
+    switch (charClass)
+    {
+    case CLASS_ALNUM:
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+    case CLASS_DIGIT:
+        return c >= '0' && c <= '9';
+    case CLASS_BLANK:
+        return c == ' ' || c == '\t' || c == '\n';
+    }
+    return 0;
+}
+
+#if SCANNER_VECTOR_WIDTH
+// Bytes in [low, high]; bytes >= 0x80 compare as negative and never match
+static Vector inRange(Vector v, char low, char high)
+{
+    return andVector(greaterBytes(v, splatVector(low - 1)), greaterBytes(splatVector(high + 1), v));
+}
+
+// One bit per byte of the vector that belongs to the class
+static uint32_t classMask(Vector v, CharClass charClass)
+{
+    switch (charClass)
+    {
+    case CLASS_ALNUM:
+        // Setting bit 5 folds upper case onto lower case
+        return vectorMask(orVector(inRange(orVector(v, splatVector(0x20)), 'a', 'z'),
+                                   inRange(v, '0', '9')));
+    case CLASS_DIGIT:
+        return vectorMask(inRange(v, '0', '9'));
+    case CLASS_BLANK:
+        return vectorMask(orVector(orVector(equalBytes(v, splatVector(' ')), equalBytes(v, splatVector('\t'))),
+                                   equalBytes(v, splatVector('\n'))));
+    }
+    return 0;
+}
+#endif
+
+// Return the end of the run of class characters starting at p
+static const char *skipClass(const char *p, CharClass charClass)
+{
+#if SCANNER_VECTOR_WIDTH
+    while (limit - p >= SCANNER_VECTOR_WIDTH)
+    {
+        uint32_t outside = ~classMask(loadVector(p), charClass) & FULL_MASK;
+        if (outside != 0)
+            return p + __builtin_ctz(outside);
+        p += SCANNER_VECTOR_WIDTH;
+    }
+#endif
+    while (p < limit && isInClass((unsigned char)*p, charClass))
+        p++;
+    return p;
+}
+
+// Count newlines in [p, end)
+static int countNewlines(const char *p, const char *end)
+{
+    int count = 0;
+#if SCANNER_VECTOR_WIDTH
+    Vector newline = splatVector('\n');
+    while (end - p >= SCANNER_VECTOR_WIDTH)
+    {
+        count += __builtin_popcount(vectorMask(equalBytes(loadVector(p), newline)));
+        p += SCANNER_VECTOR_WIDTH;
+    }
+#endif
+    while ((p = memchr(p, '\n', end - p)) != NULL)
+    {
+        count++;
+        p++;
+    }
+    return count;
+}
+
+// Find the "*/" closing a comment whose body starts at p, or NULL
+static const char *findCommentEnd(const char *p)
+{
+#if SCANNER_VECTOR_WIDTH
+    Vector star = splatVector('*');
+    Vector slash = splatVector('/');
+    while (limit - p > SCANNER_VECTOR_WIDTH)
+    {
+        // A '*' at byte i closes the comment when byte i + 1 is '/'
+        uint32_t closing = vectorMask(andVector(equalBytes(loadVector(p), star),
+                                                equalBytes(loadVector(p + 1), slash)));
+        if (closing != 0)
+            return p + __builtin_ctz(closing);
+        p += SCANNER_VECTOR_WIDTH;
+    }
+#endif
+    while ((p = memchr(p, '*', limit - p)) != NULL && p + 1 < limit)
+    {
+        if (p[1] == '/')
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
+// Length of the string literal starting at p (the opening quote), or 0 if
+// it is not terminated; an escape may not be followed by a newline
+static size_t matchStringLiteral(const char *p)
+{
+    const char *q = p + 1;
+    while (q < limit)
+    {
+        if (*q == '"')
+            return q + 1 - p;
+        if (*q == '\\')
+        {
+            if (q + 1 >= limit || q[1] == '\n')
+                return 0;
+            q += 2;
+        }
+        else
+        {
+            q++;
+        }
+    }
+    return 0;
+}
+
+// Length of the number starting at p; sets *isFloat when it has a
+// fraction or an exponent
+static size_t matchNumber(const char *p, int *isFloat)
+{
+    const char *q = skipClass(p, CLASS_DIGIT);
+    *isFloat = 0;
+
+    if (q + 1 < limit && *q == '.' && isInClass((unsigned char)q[1], CLASS_DIGIT))
+    {
+        q = skipClass(q + 1, CLASS_DIGIT);
+        *isFloat = 1;
+    }
+    if (q < limit && (*q == 'e' || *q == 'E'))
+    {
+        const char *exponent = q + 1;
+        if (exponent < limit && (*exponent == '+' || *exponent == '-'))
+            exponent++;
+        if (exponent < limit && isInClass((unsigned char)*exponent, CLASS_DIGIT))
+        {
+            q = skipClass(exponent, CLASS_DIGIT);
+            *isFloat = 1;
+        }
+    }
+    return q - p;
+}
+
+static float parseFloat(const char *p, size_t length)
+{
+    char buffer[64];
+    char *text = length < sizeof(buffer) ? buffer : (char *)malloc(length + 1);
+    memcpy(text, p, length);
+    text[length] = '\0';
+    float value = atof(text);
+    if (text != buffer)
+        free(text);
+    return value;
+}
+
+static int parseInteger(const char *p, size_t length)
+{
+    unsigned int value = 0;
+    for (size_t i = 0; i < length; i++)
+        value = value * 10 + (unsigned int)(p[i] - '0');
+    return (int)value;
+}
+
+typedef struct
+{
+    const char *text;
+    size_t length;
+    int token;
+    const char *kind;
+} Keyword;
+
+static const Keyword keywords[] = {
+    {"int", 3, TYPE, "TYPE"},
+    {"float", 5, TYPE, "TYPE"},
+    {"char", 4, TYPE, "TYPE"},
+    {"bool", 4, TYPE, "TYPE"},
+    {"void", 4, TYPE, "TYPE"},
+    {"if", 2, IF, "IF"},
+    {"else", 4, ELSE, "ELSE"},
+    {"while", 5, WHILE, "WHILE"},
+    {"write", 5, WRITE, "WRITE"},
+    {"true", 4, TRUE, "TRUE"},
+    {"false", 5, FALSE, "FALSE"},
+};
+
+static int scanWord(const char *start, size_t length)
+{
+    words++;
+    chars += length;
+
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++)
+    {
+        if (keywords[i].length == length && memcmp(keywords[i].text, start, length) == 0)
+        {
+            TRACE_TOKEN(start, length, keywords[i].kind);
+            if (keywords[i].token == TYPE)
+                yylval.string = internString(start, length);
+            return keywords[i].token;
+        }
+    }
+
+    TRACE_TOKEN(start, length, "ID");
+    yylval.string = internString(start, length);
+    return ID;
+}
+
+// Single-character tokens: the returned token and its trace name
+static int punctuation(char c, const char **kind)
+{
+    switch (c)
+    {
+    case ';': *kind = "SEMICOLON"; return SEMICOLON;
+    case '+': *kind = "PLUS"; return PLUS;
+    case '-': *kind = "MINUS"; return MINUS;
+    case '*': *kind = "MUL"; return MUL;
+    case '(': *kind = "'('"; return '(';
+    case ')': *kind = "')'"; return ')';
+    case '[': *kind = "'['"; return '[';
+    case ']': *kind = "']'"; return ']';
+    case '{': *kind = "'{'"; return '{';
+    case '}': *kind = "'}'"; return '}';
+    }
+    return 0;
+}
+
+void yyrestart(FILE *file)
+{
+    // Read the whole stream so the scanner always works on one buffer
+    size_t length = 0;
+    size_t capacity = 65536;
+    char *text = (char *)malloc(capacity);
+    size_t n;
+    while (text != NULL && (n = fread(text + length, 1, capacity - length, file)) > 0)
+    {
+        length += n;
+        if (length == capacity)
+        {
+            capacity *= 2;
+            text = (char *)realloc(text, capacity);
+        }
+    }
+    if (text == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for scanner input\n");
+        exit(1);
+    }
+
+    free(ownedText);
+    ownedText = text;
+    cursor = text;
+    limit = text + length;
+}
+
+bool beginSourceScan(SourceBuffer *source)
+{
+    cursor = source->data;
+    limit = source->data + source->length;
+    yylineno = 1;
+    return true;
+}
+
+void endSourceScan()
+{
+    free(ownedText);
+    ownedText = NULL;
+    cursor = NULL;
+    limit = NULL;
+}
+
+int yylex()
+{
+    if (cursor == NULL)
+        yyrestart(yyin != NULL ? yyin : stdin);
+
+    while (cursor < limit)
+    {
+        const char *start = cursor;
+        unsigned char c = (unsigned char)*cursor;
+
+        if (isInClass(c, CLASS_BLANK))
+        {
+            cursor = skipClass(cursor, CLASS_BLANK);
+            int newlines = countNewlines(start, cursor);
+            if (newlines > 0)
+            {
+                // Columns restart after the last newline of the run
+                const char *last = cursor - 1;
+                while (*last != '\n')
+                    last--;
+                lines += newlines;
+                yylineno += newlines;
+                chars = cursor - last - 1;
+            }
+            else
+            {
+                chars += cursor - start;
+            }
+            continue;
+        }
+
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+        {
+            cursor = skipClass(cursor + 1, CLASS_ALNUM);
+            return scanWord(start, cursor - start);
+        }
+
+        if (isInClass(c, CLASS_DIGIT))
+        {
+            int isFloat;
+            cursor += matchNumber(cursor, &isFloat);
+            words++;
+            chars += cursor - start;
+            if (isFloat)
+            {
+                TRACE_TOKEN(start, cursor - start, "FLOAT_NUMBER");
+                yylval.float_number = parseFloat(start, cursor - start);
+                return FLOAT_NUMBER;
+            }
+            TRACE_TOKEN(start, cursor - start, "NUMBER");
+            yylval.number = parseInteger(start, cursor - start);
+            return NUMBER;
+        }
+
+        if (c == '/' && cursor + 1 < limit && cursor[1] == '*')
+        {
+            const char *end = findCommentEnd(cursor + 2);
+            cursor = end != NULL ? end + 2 : limit;
+            int newlines = countNewlines(start, cursor);
+            lines += newlines;
+            yylineno += newlines;
+            if (end == NULL)
+                printf("Unterminated comment at line %d\n", yylineno);
+            continue;
+        }
+
+        if (c == '\'')
+        {
+            cursor++;
+            TRACE_TOKEN(start, 1, "CHAR_LITERAL");
+            continue;
+        }
+
+        if (c == '"')
+        {
+            size_t length = matchStringLiteral(cursor);
+            if (length > 0)
+            {
+                cursor += length;
+                yylineno += countNewlines(start, cursor);
+                TRACE_TOKEN(start, length, "STRING_LITERAL");
+                continue;
+            }
+        }
+
+        if ((c == '<' || c == '>' || c == '=' || c == '!') && cursor + 1 < limit && cursor[1] == '=')
+        {
+            cursor += 2;
+            chars += 2;
+            TRACE_TOKEN(start, 2, "LOGICOP");
+            yylval.string = internString(start, 2);
+            return LOGICOP;
+        }
+
+        if (c == '<' || c == '>')
+        {
+            cursor++;
+            chars++;
+            TRACE_TOKEN(start, 1, "LOGICOP");
+            yylval.string = internString(start, 1);
+            return LOGICOP;
+        }
+
+        if (c == '=')
+        {
+            cursor++;
+            chars++;
+            TRACE_TOKEN(start, 1, "ASSIGNOP");
+            yylval.string = internString(start, 1);
+            return ASSIGNOP;
+        }
+
+        const char *kind;
+        int token = punctuation(c, &kind);
+        cursor++;
+        chars++;
+        if (token != 0)
+        {
+            TRACE_TOKEN(start, 1, kind);
+            return token;
+        }
+        printf("%.1s : Unrecognized symbol at line %d char %d\n", start, lines, chars);
+    }
+    return 0;
+}
@@ -7,11 +7,30 @@
 #include "temp.h"
 #include "codeGenerator.h"
 
-int tempVars[50] = {0}; // Definition and initialization
+int tempCount = 0; // Virtual registers handed out so far
 
 // Global head of the TAC instructions list
 TAC *tacHead = NULL;
 
+// Counter used to generate unique branch target labels
+static int labelCounter = 0;
+
+// Sethi-Ullman number of a binary node: both operands stay live until the
+// operation, so equal subtrees need one register more than either alone
+static uint8_t combineRegisterNeed(ASTNode *left, ASTNode *right)
+{
+    if (left->regNeed == right->regNeed)
+        return left->regNeed < UINT8_MAX ? left->regNeed + 1 : UINT8_MAX;
+    return left->regNeed > right->regNeed ? left->regNeed : right->regNeed;
+}
+
+// Operators whose operands can trade places without changing the result
+static bool isCommutative(const char *op)
+{
+    return strcmp(op, "+") == 0 || strcmp(op, "*") == 0 ||
+           strcmp(op, "==") == 0 || strcmp(op, "!=") == 0;
+}
+
 void semanticAnalysis(ASTNode *node, SymbolTable *symTab)
 {
     if (node == NULL)
@@ -20,93 +39,143 @@ void semanticAnalysis(ASTNode *node, SymbolTable *symTab)
     switch (node->type)
     {
     case NodeType_Program:
-        semanticAnalysis(node->program.varDeclList, symTab);
-        semanticAnalysis(node->program.block, symTab);
+        semanticAnalysis(getNode(node->program.varDeclList), symTab);
+        semanticAnalysis(getNode(node->program.block), symTab);
         break;
 
     case NodeType_VarDeclList:
-        semanticAnalysis(node->varDeclList.varDecl, symTab);
-        semanticAnalysis(node->varDeclList.varDeclList, symTab);
+        for (int i = 0; i < node->varDeclList.count; i++)
+        {
+            semanticAnalysis(getNode(node->varDeclList.items[i]), symTab);
+        }
         break;
 
     case NodeType_VarDecl:
-        // Check for valid
-        if (strcmp(node->varDecl.varType, "int") == 0 ||
-            strcmp(node->varDecl.varType, "float") == 0 ||
-            strcmp(node->varDecl.varType, "char") == 0 ||
-            strcmp(node->varDecl.varType, "bool") == 0 ||
-            strcmp(node->varDecl.varType, "void") == 0)
-        {
-            // Valid type, proceed with the insertion into the symbol table
-            if (findSymbol(symTab, node->varDecl.varName) != NULL)
-            {
-                fprintf(stderr, "Semantic error: Variable %s is already declared\n", node->varDecl.varName);
-            }
-            else
-            {
-                // For simple variable declarations, isArray is false, arrayInfo is NULL
-                insertSymbol(symTab, node->varDecl.varName, node->varDecl.varType, false, NULL);
-            }
-        }
-        else if (strcmp(getSymbolValue(symTab, node->varDecl.varName), "void") == 0)
-        {
-            fprintf(stderr, "Semantic error: Cannot assign value to variable of type void\n");
-            exit(1);
-        }
-        else
-        {
-            fprintf(stderr, "Semantic error: Invalid type %s\n", node->varDecl.varType);
-        }
+    case NodeType_ArrayDecl:
+        // Declared and bound by resolveNames
         break;
 
     case NodeType_StmtList:
-        if (node->stmtList.stmt != NULL)
-            semanticAnalysis(node->stmtList.stmt, symTab);
-        if (node->stmtList.stmtList != NULL)
-            semanticAnalysis(node->stmtList.stmtList, symTab);
+        for (int i = 0; i < node->stmtList.count; i++)
+        {
+            semanticAnalysis(getNode(node->stmtList.items[i]), symTab);
+        }
         break;
 
     case NodeType_AssignStmt:
-        if (findSymbol(symTab, node->assignStmt.varName) == NULL)
+        if (node->symbol == NO_SYMBOL)
         {
             fprintf(stderr, "Semantic error: Variable %s has not been declared\n", node->assignStmt.varName);
         }
         else
         {
             // Perform semantic analysis on the expression
-            semanticAnalysis(node->assignStmt.expr, symTab);
+            semanticAnalysis(getNode(node->assignStmt.expr), symTab);
             // Generate TAC for the assignment
-            generateTACForExpr(node, symTab);
+            free(generateTACForExpr(node, symTab));
         }
         break;
 
     case NodeType_BinOp:
-        semanticAnalysis(node->binOp.left, symTab);
-        semanticAnalysis(node->binOp.right, symTab);
+    {
+        semanticAnalysis(getNode(node->binOp.left), symTab);
+        semanticAnalysis(getNode(node->binOp.right), symTab);
+
+        // Promotion (int with float gives float) is part of the table
+        node->dataType = arithmeticResultType[getNode(node->binOp.left)->dataType][getNode(node->binOp.right)->dataType];
+        if (node->dataType == DataType_Unknown)
+        {
+            fprintf(stderr, "Semantic error: Type mismatch in binary operation\n");
+            abortCompilation();
+        }
+
+        // Put the operand that needs more registers first, so TAC evaluates
+        // it while the other one holds nothing yet
+        char op[2] = {node->binOp.operator, '\0'};
+        if (isCommutative(op) && getNode(node->binOp.right)->regNeed > getNode(node->binOp.left)->regNeed)
+        {
+            NodeIndex left = node->binOp.left;
+            node->binOp.left = node->binOp.right;
+            node->binOp.right = left;
+        }
+        node->regNeed = combineRegisterNeed(getNode(node->binOp.left), getNode(node->binOp.right));
+        break;
+    }
 
-        if ((strcmp(node->binOp.left->dataType, "int") == 0 && strcmp(node->binOp.right->dataType, "float") == 0) ||
-            (strcmp(node->binOp.left->dataType, "float") == 0 && strcmp(node->binOp.right->dataType, "int") == 0))
+    case NodeType_LogicalOp:
+        semanticAnalysis(getNode(node->logicalOp.left), symTab);
+        semanticAnalysis(getNode(node->logicalOp.right), symTab);
+
+        // Comparisons always produce 0 or 1
+        node->dataType = comparisonResultType[getNode(node->logicalOp.left)->dataType][getNode(node->logicalOp.right)->dataType];
+        if (node->dataType == DataType_Unknown)
         {
-            node->dataType = strdup("float"); // Promote to float if mixed types
+            fprintf(stderr, "Semantic error: Type mismatch in comparison\n");
+            abortCompilation();
         }
-        else if (strcmp(node->binOp.left->dataType, "float") == 0 && strcmp(node->binOp.right->dataType, "float") == 0)
+
+        if (isCommutative(node->logicalOp.logicalOp) &&
+            getNode(node->logicalOp.right)->regNeed > getNode(node->logicalOp.left)->regNeed)
         {
-            node->dataType = strdup("float");
+            NodeIndex left = node->logicalOp.left;
+            node->logicalOp.left = node->logicalOp.right;
+            node->logicalOp.right = left;
         }
-        else if (strcmp(node->binOp.left->dataType, node->binOp.right->dataType) == 0)
+        node->regNeed = combineRegisterNeed(getNode(node->logicalOp.left), getNode(node->logicalOp.right));
+        break;
+
+    case NodeType_IfStmt:
+    {
+        semanticAnalysis(getNode(node->ifStmt.condition), symTab);
+
+        // ifFalse cond goto else; then...; goto end; else: ...; end:
+        char *cond = generateTACForExpr(getNode(node->ifStmt.condition), symTab);
+        char *elseLabel = createLabel();
+        char *endLabel = createLabel();
+
+        emitTAC("ifFalse", cond, NULL, elseLabel);
+        semanticAnalysis(getNode(node->ifStmt.thenBlock), symTab);
+        if (node->ifStmt.elseBlock != NULL_NODE)
         {
-            node->dataType = strdup(node->binOp.left->dataType);
+            emitTAC("goto", NULL, NULL, endLabel);
+            emitTAC("label", NULL, NULL, elseLabel);
+            semanticAnalysis(getNode(node->ifStmt.elseBlock), symTab);
+            emitTAC("label", NULL, NULL, endLabel);
         }
         else
         {
-            fprintf(stderr, "Semantic error: Type mismatch in binary operation\n");
-            exit(1);
+            emitTAC("label", NULL, NULL, elseLabel);
         }
+
+        free(cond);
+        free(elseLabel);
+        free(endLabel);
         break;
+    }
+
+    case NodeType_WhileStmt:
+    {
+        // top: ifFalse cond goto end; body...; goto top; end:
+        char *topLabel = createLabel();
+        char *endLabel = createLabel();
+
+        emitTAC("label", NULL, NULL, topLabel);
+        semanticAnalysis(getNode(node->whileStmt.condition), symTab);
+        char *cond = generateTACForExpr(getNode(node->whileStmt.condition), symTab);
+        emitTAC("ifFalse", cond, NULL, endLabel);
+        semanticAnalysis(getNode(node->whileStmt.block), symTab);
+        emitTAC("goto", NULL, NULL, topLabel);
+        emitTAC("label", NULL, NULL, endLabel);
+
+        free(cond);
+        free(topLabel);
+        free(endLabel);
+        break;
+    }
 
     case NodeType_SimpleID:
     {
-        Symbol *symbol = findSymbol(symTab, node->simpleID.name);
+        Symbol *symbol = getSymbolById(symTab, node->symbol);
         if (symbol == NULL)
         {
             fprintf(stderr, "Semantic error: Variable %s has not been declared\n", node->simpleID.name);
@@ -114,110 +183,86 @@ void semanticAnalysis(ASTNode *node, SymbolTable *symTab)
         else
         {
             // Set dataType based on symbol's type
-            node->dataType = strdup(symbol->type);
+            node->dataType = symbol->type;
         }
+        node->regNeed = 1;
         break;
     }
 
     case NodeType_SimpleExpr:
-        node->dataType = strdup("int");
+        // The parser already tagged the literal as int or float
+        node->regNeed = 1;
         break;
 
     case NodeType_WriteStmt:
-        semanticAnalysis(node->writeStmt.expr, symTab);
+        semanticAnalysis(getNode(node->writeStmt.expr), symTab);
         // Generate TAC for the write statement
-        generateTACForExpr(node, symTab);
+        free(generateTACForExpr(node, symTab));
         break;
 
     case NodeType_Block:
-        if (node->block.stmtList != NULL)
-            semanticAnalysis(node->block.stmtList, symTab);
-        break;
-
-    case NodeType_ArrayDecl:
-    {
-        // In NodeType_VarDecl or NodeType_ArrayDecl
-        if (strcmp(node->varDecl.varType, "int") == 0 ||
-            strcmp(node->varDecl.varType, "float") == 0 ||
-            strcmp(node->varDecl.varType, "char") == 0 ||
-            strcmp(node->varDecl.varType, "bool") == 0 ||
-            strcmp(node->varDecl.varType, "void") == 0)
-        {
-            // Valid type, proceed with the insertion into the symbol table
-            // Check for duplicate declaration
-            if (findSymbol(symTab, node->arrayDecl.varName) != NULL)
-            {
-                fprintf(stderr, "Semantic error: Array %s is already declared\n", node->arrayDecl.varName);
-                exit(1);
-            }
-            // Create array info
-            Array *arrayInfo = createArray(node->arrayDecl.varType, node->arrayDecl.size);
-            // Insert into symbol table
-            insertSymbol(symTab, node->arrayDecl.varName, node->arrayDecl.varType, true, arrayInfo);
-        }
-        else
-        {
-            fprintf(stderr, "Semantic error: Invalid type %s\n", node->varDecl.varType);
-        }
+        if (node->block.stmtList != NULL_NODE)
+            semanticAnalysis(getNode(node->block.stmtList), symTab);
         break;
-    }
 
     case NodeType_ArrayAssign:
     {
-        Symbol *arraySymbol = findSymbol(symTab, node->arrayAssign.arrayName);
+        Symbol *arraySymbol = getSymbolById(symTab, node->symbol);
         if (arraySymbol == NULL || !arraySymbol->isArray)
         {
             fprintf(stderr, "Semantic error: %s is not a declared array\n", node->arrayAssign.arrayName);
-            exit(1);
+            abortCompilation();
         }
 
         // Analyze index and expression
-        semanticAnalysis(node->arrayAssign.index, symTab);
-        semanticAnalysis(node->arrayAssign.expr, symTab);
+        semanticAnalysis(getNode(node->arrayAssign.index), symTab);
+        semanticAnalysis(getNode(node->arrayAssign.expr), symTab);
 
         // Type checks
-        if (strcmp(node->arrayAssign.index->dataType, "int") != 0)
+        if (getNode(node->arrayAssign.index)->dataType != DataType_Int)
         {
             fprintf(stderr, "Semantic error: Array index must be an integer\n");
-            exit(1);
+            abortCompilation();
         }
 
-        if (strcmp(node->arrayAssign.expr->dataType, arraySymbol->type) != 0)
+        if (getNode(node->arrayAssign.expr)->dataType != arraySymbol->type)
         {
             fprintf(stderr, "Semantic error: Type mismatch in array assignment\n");
-            exit(1);
+            abortCompilation();
         }
 
         // Generate TAC for the array assignment
-        generateTACForExpr(node, symTab);
+        free(generateTACForExpr(node, symTab));
 
         break;
     }
 
     case NodeType_ArrayAccess:
     {
-        Symbol *arraySymbol = findSymbol(symTab, node->arrayAccess.arrayName);
+        Symbol *arraySymbol = getSymbolById(symTab, node->symbol);
         if (arraySymbol == NULL || !arraySymbol->isArray)
         {
             fprintf(stderr, "Semantic error: %s is not a declared array\n", node->arrayAccess.arrayName);
-            exit(1);
+            abortCompilation();
         }
 
         // Analyze index
-        semanticAnalysis(node->arrayAccess.index, symTab);
+        semanticAnalysis(getNode(node->arrayAccess.index), symTab);
 
         // Type checks
-        if (strcmp(node->arrayAccess.index->dataType, "int") != 0)
+        if (getNode(node->arrayAccess.index)->dataType != DataType_Int)
         {
             fprintf(stderr, "Semantic error: Array index must be an integer\n");
-            exit(1);
+            abortCompilation();
         }
 
         // Set the data type of the array access node
-        node->dataType = strdup(arraySymbol->type);
+        node->dataType = arraySymbol->type;
+
+        // The loaded element can reuse the index register
+        node->regNeed = getNode(node->arrayAccess.index)->regNeed;
 
-        // Generate TAC for the array access
-        generateTACForExpr(node, symTab);
+        // The load itself is emitted by the enclosing expression's TAC
 
         break;
     }
@@ -237,19 +282,16 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
     case NodeType_AssignStmt:
     {
         // Generate TAC for the right-hand side expression
-        char *rhs = generateTACForExpr(expr->assignStmt.expr, symTab);
+        char *rhs = generateTACForExpr(getNode(expr->assignStmt.expr), symTab);
 
         printf("%s\n", rhs);
 
         // Find the type of the left-hand side variable in the symbol table
-        Symbol *symbol = findSymbol(symTab, expr->assignStmt.varName);
+        Symbol *symbol = getSymbolById(symTab, expr->symbol);
 
-        if (symbol && strcmp(symbol->type, "float") == 0)
+        if (symbol && symbol->type == DataType_Float)
         {
-            // Update the value of the float variable in the symbol table
-            // float rhsValue = atof(rhs); // Ensure rhs is interpreted as a float
-            updateSymbolValue(symTab, expr->assignStmt.varName, rhs);
-
+            // Initial values are filled in by staticDataInitialization
             printf("bussy: %s\n", rhs);
 
             // Create a TAC instruction for the assignment
@@ -265,8 +307,6 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
         else
         {
             // Handle integer or other types of assignment
-            updateSymbolValue(symTab, expr->assignStmt.varName, rhs);
-
             printf("Angel\n");
 
             // Create a TAC instruction for the assignment
@@ -280,35 +320,35 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
             appendTAC(&tacHead, assignTAC);
         }
 
+        free(rhs);
         return strdup(expr->assignStmt.varName);
     }
     break;
 
     case NodeType_BinOp:
     {
-        // Generate TAC for left and right operands
-        char *left = generateTACForExpr(expr->binOp.left, symTab);
-        char *right = generateTACForExpr(expr->binOp.right, symTab);
-
-        // Check the data types of the operands
-        Symbol *leftSymbol = findSymbol(symTab, left);
-        Symbol *rightSymbol = findSymbol(symTab, right);
-        bool isFloatOp = false;
-
-        if ((leftSymbol && strcmp(leftSymbol->type, "float") == 0) ||
-            (rightSymbol && strcmp(rightSymbol->type, "float") == 0))
+        // Generate TAC for the operand that needs more registers first;
+        // operands have no side effects, so only register pressure changes
+        char *left;
+        char *right;
+        if (getNode(expr->binOp.right)->regNeed > getNode(expr->binOp.left)->regNeed)
         {
-            isFloatOp = true;
+            right = generateTACForExpr(getNode(expr->binOp.right), symTab);
+            left = generateTACForExpr(getNode(expr->binOp.left), symTab);
         }
-
-        // Allocate a register for the result
-        const char *resultReg = isFloatOp ? allocateFloatRegister() : allocateRegister();
-        if (!resultReg)
+        else
         {
-            fprintf(stderr, "Error: No available registers for result\n");
-            exit(1);
+            left = generateTACForExpr(getNode(expr->binOp.left), symTab);
+            right = generateTACForExpr(getNode(expr->binOp.right), symTab);
         }
 
+        // Semantic analysis already typed the node from the promotion table
+        bool isFloatOp = expr->dataType == DataType_Float;
+
+        // The result goes into a fresh virtual register; the code generator
+        // picks the machine register
+        char *resultTemp = createTempVar();
+
         // Create a TAC instruction for the binary operation
         TAC *binOpTAC = (TAC *)malloc(sizeof(TAC));
         char opStr[5]; // Need more space to differentiate between fadd, fsub, etc.
@@ -340,12 +380,45 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
         binOpTAC->op = strdup(opStr);
         binOpTAC->arg1 = strdup(left);
         binOpTAC->arg2 = strdup(right);
-        binOpTAC->result = strdup(resultReg); // Store result in the allocated register
+        free(left);
+        free(right);
+        binOpTAC->result = resultTemp; // Store result in the virtual register
         binOpTAC->next = NULL;
 
         appendTAC(&tacHead, binOpTAC);
 
-        return strdup(resultReg);
+        return strdup(resultTemp);
+    }
+    break;
+
+    case NodeType_LogicalOp:
+    {
+        // Generate TAC for the operand that needs more registers first
+        char *left;
+        char *right;
+        if (getNode(expr->logicalOp.right)->regNeed > getNode(expr->logicalOp.left)->regNeed)
+        {
+            right = generateTACForExpr(getNode(expr->logicalOp.right), symTab);
+            left = generateTACForExpr(getNode(expr->logicalOp.left), symTab);
+        }
+        else
+        {
+            left = generateTACForExpr(getNode(expr->logicalOp.left), symTab);
+            right = generateTACForExpr(getNode(expr->logicalOp.right), symTab);
+        }
+
+        // The comparison result (0 or 1) goes into a temporary
+        TAC *logicalTAC = (TAC *)malloc(sizeof(TAC));
+        logicalTAC->op = strdup(expr->logicalOp.logicalOp);
+        logicalTAC->arg1 = strdup(left);
+        logicalTAC->arg2 = strdup(right);
+        free(left);
+        free(right);
+        logicalTAC->result = createTempVar();
+        logicalTAC->next = NULL;
+
+        appendTAC(&tacHead, logicalTAC);
+        return strdup(logicalTAC->result);
     }
     break;
 
@@ -354,14 +427,12 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
         char buffer[20]; // Buffer to hold the numeric literal
 
         // Ensure the data type is correctly recognized
-        if (expr->simpleExpr.isFloat) // Assuming isFloat is set for floats
+        if (expr->dataType == DataType_Float)
         {
-            expr->dataType = strdup("float");
             snprintf(buffer, sizeof(buffer), "%.6f", expr->simpleExpr.floatValue);
         }
         else
         {
-            expr->dataType = strdup("int");
             snprintf(buffer, sizeof(buffer), "%d", expr->simpleExpr.number);
         }
 
@@ -372,24 +443,15 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
 
     case NodeType_SimpleID:
     {
-        Symbol *symbol = findSymbol(symTab, expr->simpleID.name);
-        if (symbol && strcmp(symbol->type, "float") == 0)
-        {
-            // Return the variable name and mark it as a float
-            return strdup(expr->simpleID.name); // Floating-point variable
-        }
-        else
-        {
-            // Return the variable name (default integer behavior)
-            return strdup(expr->simpleID.name);
-        }
+        // The variable name is the operand; its type is on the node
+        return strdup(expr->simpleID.name);
     }
     break;
 
     case NodeType_WriteStmt:
     {
         // Generate TAC for the expression to write
-        char *exprResult = generateTACForExpr(expr->writeStmt.expr, symTab);
+        char *exprResult = generateTACForExpr(getNode(expr->writeStmt.expr), symTab);
 
         // Create a TAC instruction for the write operation
         TAC *writeTAC = (TAC *)malloc(sizeof(TAC));
@@ -403,15 +465,8 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
         }
         else
         {
-            Symbol *foundSymbol = findSymbol(symTab, exprResult);
-            if (foundSymbol == NULL)
-            {
-                fprintf(stderr, "Error: Symbol '%s' not found in the symbol table.\n", exprResult);
-                return NULL; // Handle the error gracefully
-            }
-
             // Determine if the expression result is a float or an integer
-            if (strcmp(foundSymbol->type, "float") == 0)
+            if (getNode(expr->writeStmt.expr)->dataType == DataType_Float)
             {
                 // Handle write for floating-point values
                 writeTAC->op = strdup("write_float");
@@ -431,6 +486,7 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
         writeTAC->next = NULL;
 
         appendTAC(&tacHead, writeTAC);
+        free(exprResult);
         return NULL;
     }
     break;
@@ -438,8 +494,8 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
     case NodeType_ArrayAssign:
     {
         // Generate TAC for index and expression
-        char *index = generateTACForExpr(expr->arrayAssign.index, symTab);
-        char *rhs = generateTACForExpr(expr->arrayAssign.expr, symTab);
+        char *index = generateTACForExpr(getNode(expr->arrayAssign.index), symTab);
+        char *rhs = generateTACForExpr(getNode(expr->arrayAssign.expr), symTab);
 
         // Create a TAC instruction for the array assignment
         TAC *arrayAssignTAC = (TAC *)malloc(sizeof(TAC));
@@ -450,6 +506,8 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
         arrayAssignTAC->next = NULL;
 
         appendTAC(&tacHead, arrayAssignTAC);
+        free(index);
+        free(rhs);
         return NULL;
     }
     break;
@@ -457,17 +515,18 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
     case NodeType_ArrayAccess:
     {
         // Generate TAC for the index
-        char *index = generateTACForExpr(expr->arrayAccess.index, symTab);
+        char *index = generateTACForExpr(getNode(expr->arrayAccess.index), symTab);
 
         // Create a TAC instruction for the array access
         TAC *arrayAccessTAC = (TAC *)malloc(sizeof(TAC));
         arrayAccessTAC->op = strdup("=[]");
         arrayAccessTAC->arg1 = strdup(expr->arrayAccess.arrayName); // This holds the array name
         arrayAccessTAC->arg2 = strdup(index);                       // This holds the index
-        arrayAccessTAC->result = createTempVar(symTab);             // Create a temporary variable to hold the result
+        arrayAccessTAC->result = createTempVar();             // Create a temporary variable to hold the result
         arrayAccessTAC->next = NULL;
 
         appendTAC(&tacHead, arrayAccessTAC);
+        free(index);
         return strdup(arrayAccessTAC->result); // Return the temporary variable
     }
     break;
@@ -478,31 +537,48 @@ char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab)
     }
 }
 
-// Function to create a new temporary variable for TAC
-char *createTempVar(SymbolTable *symTab)
+// Function to create a new temporary for TAC: a fresh virtual register,
+// with no limit on how many a program may use
+char *createTempVar()
 {
-    int index = allocateNextAvailableTempVar(tempVars, 50);
-    if (index == -1)
-    {
-        fprintf(stderr, "Error: No available temporary variables\n");
-        return NULL;
-    }
-
-    char *tempVar = malloc(10); // Enough space for "t" + number
+    char *tempVar = malloc(sizeof(TEMP_PREFIX) + 11); // Prefix + number
     if (!tempVar)
         return NULL;
 
-    sprintf(tempVar, "t%d", index);
+    sprintf(tempVar, "%s%d", TEMP_PREFIX, tempCount++);
+    return tempVar;
+}
 
-    // Insert the temporary variable into the symbol table
-    if (findSymbol(symTab, tempVar) == NULL)
-    {
-        insertSymbol(symTab, tempVar, "int", false, NULL); // Assuming temporaries are of type int
-    }
+// Function to create a new branch target label for TAC
+char *createLabel()
+{
+    // Identifiers cannot start with '_', so labels never clash with variables
+    char *label = malloc(16);
+    if (!label)
+        return NULL;
 
-    return tempVar;
+    sprintf(label, "_L%d", labelCounter++);
+    return label;
 }
 
+// Append a control-flow instruction (label, goto, ifFalse) to the TAC list
+void emitTAC(const char *op, const char *arg1, const char *arg2, const char *result)
+{
+    TAC *instr = (TAC *)malloc(sizeof(TAC));
+    instr->op = strdup(op);
+    instr->arg1 = arg1 ? strdup(arg1) : NULL;
+    instr->arg2 = arg2 ? strdup(arg2) : NULL;
+    instr->result = result ? strdup(result) : NULL;
+    instr->next = NULL;
+
+    appendTAC(&tacHead, instr);
+}
+
+// Last instruction appended through appendTAC, so appending to the list
+// being built does not walk it from the head every time
+static TAC **tailOwner = NULL;
+static TAC *tail = NULL;
+
 void appendTAC(TAC **head, TAC *newInstruction)
 {
     if (!*head)
@@ -511,13 +587,29 @@ void appendTAC(TAC **head, TAC *newInstruction)
     }
     else
     {
-        TAC *current = *head;
+        TAC *current = (tailOwner == head && tail != NULL) ? tail : *head;
         while (current->next)
         {
             current = current->next;
         }
         current->next = newInstruction;
     }
+
+    tailOwner = head;
+    tail = newInstruction;
+    while (tail->next)
+    {
+        tail = tail->next;
+    }
+}
+
+// Start TAC generation afresh: labels and temporaries count from zero
+void resetTACGeneration()
+{
+    labelCounter = 0;
+    tailOwner = NULL;
+    tail = NULL;
+    initializeTempVars();
 }
 
 void freeTACList(TAC *head)
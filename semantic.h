@@ -17,14 +17,16 @@ typedef struct TAC
     struct TAC *next; // Next instruction
 } TAC;
 
-extern int tempVars[50];
 extern TAC *tacHead; // Global head of the TAC instructions list
 
 void semanticAnalysis(ASTNode *node, SymbolTable *symTab);
 char *generateTACForExpr(ASTNode *expr, SymbolTable *symTab); // returns the TAC for the expression to print on console
 char *createTempVar();
 char *createOperand(ASTNode *node, SymbolTable *symTab);
+char *createLabel();
+void emitTAC(const char *op, const char *arg1, const char *arg2, const char *result);
 void appendTAC(TAC **head, TAC *newInstruction);
 void freeTACList(TAC *head);
+void resetTACGeneration();
 
 #endif // SEMANTIC_H
@@ -0,0 +1,393 @@
+// server.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "server.h"
+#include "compile.h"
+#include "x86Generator.h"
+#include "intern.h"
+#include "utils.h"
+
+extern int lexerVerbose;
+
+// Longest header line a request may contain
+#define MAX_REQUEST_LINE 4096
+
+// The intern table is kept warm between requests but cleared once it holds
+// this many strings, so a long-lived server does not grow without bound
+#define SERVER_INTERN_LIMIT 100000
+
+typedef struct
+{
+    int fd;
+    char buffer[MAX_REQUEST_LINE];
+    size_t start; // First unread byte in buffer
+    size_t end;   // End of the bytes read so far
+} Connection;
+
+typedef struct
+{
+    long long requests;
+    long long failures;
+    double compileSeconds;
+} ServerStats;
+
+// The server's own messages; the compiler's stdout and stderr go to the
+// per-request log instead
+static FILE *serverLog = NULL;
+static FILE *compileLog = NULL;
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Read one line into line, without its newline; false at end of input or
+// when the line does not fit
+static bool readLine(Connection *conn, char *line, size_t size)
+{
+    for (;;)
+    {
+        char *newline = memchr(conn->buffer + conn->start, '\n', conn->end - conn->start);
+        if (newline != NULL)
+        {
+            size_t length = newline - (conn->buffer + conn->start);
+            if (length >= size)
+                return false;
+            memcpy(line, conn->buffer + conn->start, length);
+            line[length] = '\0';
+            conn->start += length + 1;
+            return true;
+        }
+
+        // Move the partial line to the front and read more after it
+        memmove(conn->buffer, conn->buffer + conn->start, conn->end - conn->start);
+        conn->end -= conn->start;
+        conn->start = 0;
+        if (conn->end == sizeof(conn->buffer))
+            return false;
+        ssize_t n = read(conn->fd, conn->buffer + conn->end, sizeof(conn->buffer) - conn->end);
+        if (n <= 0)
+            return false;
+        conn->end += (size_t)n;
+    }
+}
+
+// Read exactly length bytes, starting with any already buffered
+static bool readBytes(Connection *conn, char *dest, size_t length)
+{
+    size_t buffered = conn->end - conn->start;
+    size_t done = buffered < length ? buffered : length;
+    memcpy(dest, conn->buffer + conn->start, done);
+    conn->start += done;
+    while (done < length)
+    {
+        ssize_t n = read(conn->fd, dest + done, length - done);
+        if (n <= 0)
+            return false;
+        done += (size_t)n;
+    }
+    return true;
+}
+
+static bool writeBytes(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t n = write(fd, data, length);
+        if (n <= 0)
+            return false;
+        data += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+static void sendReply(int fd, const char *status, const char *body, size_t length)
+{
+    char header[64];
+    int n = snprintf(header, sizeof(header), "%s %zu\n", status, length);
+    if (!writeBytes(fd, header, (size_t)n) || !writeBytes(fd, body, length))
+        fprintf(serverLog, "Warning: Client went away before the reply was sent\n");
+}
+
+static void sendError(int fd, const char *message)
+{
+    sendReply(fd, "error", message, strlen(message));
+}
+
+// Empty the compiler's log before a request
+static void clearCompileLog()
+{
+    fflush(stdout);
+    fflush(stderr);
+    // stdout and stderr share the log's file offset, so rewind that directly
+    if (ftruncate(fileno(compileLog), 0) != 0)
+        perror("ftruncate");
+    lseek(fileno(compileLog), 0, SEEK_SET);
+}
+
+// The error and warning lines the compiler printed during a request
+static char *collectDiagnostics(size_t *length)
+{
+    fflush(stdout);
+    fflush(stderr);
+    off_t size = lseek(fileno(compileLog), 0, SEEK_CUR);
+    if (size < 0)
+        size = 0;
+    char *log = (char *)malloc((size_t)size + 1);
+    char *messages = (char *)malloc((size_t)size + 32);
+    size_t done = (size_t)pread(fileno(compileLog), log, (size_t)size, 0);
+    log[done] = '\0';
+
+    *length = 0;
+    for (char *line = strtok(log, "\n"); line != NULL; line = strtok(NULL, "\n"))
+    {
+        if (strstr(line, "rror") != NULL || strstr(line, "arning") != NULL)
+            *length += sprintf(messages + *length, "%s\n", line);
+    }
+    if (*length == 0)
+        *length = sprintf(messages, "Error: Compilation failed\n");
+    free(log);
+    return messages;
+}
+
+// Compile one source for a client and reply with the result
+static void compileRequest(int fd, SymbolTable *symTab, SourceBuffer *source,
+                           const CodeGenTarget *target, const char *outputPath, ServerStats *stats)
+{
+    char *code = NULL;
+    size_t codeLength = 0;
+    FILE *codeStream = NULL;
+    if (outputPath[0] == '\0')
+    {
+        codeStream = open_memstream(&code, &codeLength);
+        outputPath = "(reply)";
+    }
+    CompileOptions options = {false, false, target, outputPath, codeStream, false, NULL, false};
+
+    clearCompileLog();
+    double start = now();
+
+    // Compile errors land back here instead of exiting the server
+    jmp_buf recovery;
+    int status = 1;
+    compileErrorRecovery = &recovery;
+    if (setjmp(recovery) == 0)
+    {
+        status = compileSource(source, symTab, &options);
+    }
+    compileErrorRecovery = NULL;
+    resetCompileState(symTab);
+
+    stats->compileSeconds += now() - start;
+    stats->requests++;
+
+    if (codeStream != NULL)
+        fclose(codeStream);
+
+    if (status != 0)
+    {
+        stats->failures++;
+        size_t length;
+        char *messages = collectDiagnostics(&length);
+        sendReply(fd, "error", messages, length);
+        free(messages);
+    }
+    else if (codeStream != NULL)
+    {
+        sendReply(fd, "ok", code, codeLength);
+    }
+    else
+    {
+        sendReply(fd, "ok", outputPath, strlen(outputPath));
+    }
+    free(code);
+
+    if (getInternCount() > SERVER_INTERN_LIMIT)
+        freeInternTable();
+}
+
+// Read and answer one request; returns false once asked to shut down
+static bool handleRequest(int fd, SymbolTable *symTab, ServerStats *stats)
+{
+    Connection conn;
+    conn.fd = fd;
+    conn.start = 0;
+    conn.end = 0;
+
+    char line[MAX_REQUEST_LINE];
+    char filePath[MAX_REQUEST_LINE] = "";
+    char outputPath[MAX_REQUEST_LINE] = "";
+    long sourceLength = -1;
+    const CodeGenTarget *target = &mipsTarget;
+
+    for (;;)
+    {
+        if (!readLine(&conn, line, sizeof(line)))
+        {
+            sendError(fd, "Error: Malformed request\n");
+            return true;
+        }
+        if (line[0] == '\0')
+            break;
+
+        char *value = strchr(line, ' ');
+        if (value != NULL)
+            *value++ = '\0';
+
+        if (strcmp(line, "shutdown") == 0)
+        {
+            sendReply(fd, "ok", "", 0);
+            return false;
+        }
+        else if (strcmp(line, "target") == 0 && value != NULL && strcmp(value, "mips") == 0)
+        {
+            target = &mipsTarget;
+        }
+        else if (strcmp(line, "target") == 0 && value != NULL && strcmp(value, "x86-64") == 0)
+        {
+            target = &x86Target;
+        }
+        else if (strcmp(line, "output") == 0 && value != NULL)
+        {
+            strcpy(outputPath, value);
+        }
+        else if (strcmp(line, "file") == 0 && value != NULL)
+        {
+            strcpy(filePath, value);
+        }
+        else if (strcmp(line, "source") == 0 && value != NULL)
+        {
+            sourceLength = atol(value);
+        }
+        else
+        {
+            sendError(fd, "Error: Unknown request field\n");
+            return true;
+        }
+    }
+
+    SourceBuffer *source = NULL;
+    if (filePath[0] != '\0')
+    {
+        source = openSourceFile(filePath);
+        if (source == NULL)
+        {
+            sendError(fd, "Error: Unable to open the source file\n");
+            return true;
+        }
+    }
+    else if (sourceLength >= 0)
+    {
+        char *text = (char *)malloc((size_t)sourceLength + 1);
+        if (text != NULL && readBytes(&conn, text, (size_t)sourceLength))
+            source = openSourceText(text, (size_t)sourceLength);
+        free(text);
+        if (source == NULL)
+        {
+            sendError(fd, "Error: Unable to read the source text\n");
+            return true;
+        }
+    }
+    else
+    {
+        sendError(fd, "Error: Request names no file or source\n");
+        return true;
+    }
+
+    compileRequest(fd, symTab, source, target, outputPath, stats);
+    closeSourceFile(source);
+    return true;
+}
+
+int runCompileServer(const char *socketPath, SymbolTable *symTab)
+{
+    struct sockaddr_un address;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Error: Socket path %s is too long\n", socketPath);
+        return 1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        perror("socket");
+        return 1;
+    }
+    unlink(socketPath);
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 16) != 0)
+    {
+        perror(socketPath);
+        close(listener);
+        return 1;
+    }
+
+    // Clients that hang up early must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    // Keep a stream of our own for server messages, then send the
+    // compiler's console output to the log
+    serverLog = fdopen(dup(STDERR_FILENO), "w");
+    setvbuf(serverLog, NULL, _IOLBF, 0);
+    compileLog = tmpfile();
+    if (serverLog == NULL || compileLog == NULL)
+    {
+        perror("compile server log");
+        close(listener);
+        unlink(socketPath);
+        return 1;
+    }
+    int savedStdout = dup(STDOUT_FILENO);
+    int savedStderr = dup(STDERR_FILENO);
+    fflush(stdout);
+    fflush(stderr);
+    dup2(fileno(compileLog), STDOUT_FILENO);
+    dup2(fileno(compileLog), STDERR_FILENO);
+    lexerVerbose = 0;
+
+    fprintf(serverLog, "Compile server listening on %s\n", socketPath);
+
+    ServerStats stats = {0, 0, 0.0};
+    bool running = true;
+    while (running)
+    {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0)
+            continue;
+        running = handleRequest(client, symTab, &stats);
+        close(client);
+    }
+
+    close(listener);
+    unlink(socketPath);
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(savedStdout, STDOUT_FILENO);
+    dup2(savedStderr, STDERR_FILENO);
+    close(savedStdout);
+    close(savedStderr);
+    fclose(compileLog);
+    lexerVerbose = 1;
+
+    fprintf(serverLog, "Served %lld requests (%lld failed), %.3f ms average compile time\n",
+            stats.requests, stats.failures,
+            stats.requests > 0 ? stats.compileSeconds * 1000.0 / stats.requests : 0.0);
+    fclose(serverLog);
+    serverLog = NULL;
+    return 0;
+}
@@ -0,0 +1,27 @@
+// server.h
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "SymbolTable.h"
+
+// Compile server: one long-running compiler answers requests over a Unix
+// socket, so a build pays process startup and table setup once rather
+// than per file. The AST pool, the symbol table and the intern table stay
+// allocated between requests and are emptied after each one.
+//
+// A request is a few "key value" lines ended by an empty line:
+//   target mips | x86-64   Backend to use (default mips)
+//   output <path>          Write the assembly there instead of replying with it
+//   file <path>            Compile a file; relative paths are the server's
+//   source <length>        Compile the <length> bytes after the empty line
+//   shutdown               Stop the server
+// The reply is "ok <length>\n" followed by the assembly (or the output
+// path), or "error <length>\n" followed by the compiler's error messages.
+#define COMPILE_SERVER_SOCKET "/tmp/cmm-compile.sock"
+
+// Serve requests one at a time until a shutdown request; returns the exit
+// status for main
+int runCompileServer(const char *socketPath, SymbolTable *symTab);
+
+#endif // SERVER_H
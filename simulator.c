@@ -0,0 +1,1208 @@
+// simulator.c
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stddef.h>
+#include "simulator.h"
+
+// Register file layout: integer registers, then float registers, then LO/HI
+#define REG_FLOAT 32
+#define REG_LO 64
+#define REG_HI 65
+#define REG_FCC 66 // Float condition flag, tracked like a register
+#define REG_COUNT 67
+#define REG_NONE 0xFF
+
+#define MAX_OPERANDS 3
+
+typedef enum
+{
+    Op_Li, Op_La, Op_Lw, Op_Sw, Op_LoadFloat, Op_StoreFloat, Op_LiFloat,
+    Op_Move, Op_MoveFloat, Op_Add, Op_Sub, Op_Mul, Op_Div, Op_Mflo, Op_Mfhi,
+    Op_Slt, Op_Sle, Op_Sgt, Op_Sge, Op_Seq, Op_Sne, Op_Sltu,
+    Op_Sll, Op_Srl, Op_Sra, Op_And, Op_Or, Op_Xor, Op_Nor,
+    Op_AddFloat, Op_SubFloat, Op_MulFloat, Op_DivFloat,
+    Op_Mtc1, Op_Mfc1, Op_CvtSW, Op_CvtWS,
+    Op_CmpEqFloat, Op_CmpLtFloat, Op_CmpLeFloat, Op_Movt, Op_Movf,
+    Op_Jump, Op_Beqz, Op_Bnez, Op_Beq, Op_Bne, Op_Syscall, Op_Nop
+} Opcode;
+
+// Operand kinds, one character per operand:
+//   r integer register   f float register   x integer register or immediate
+//   i integer immediate  F float immediate  m memory operand
+//   a data address       l text label
+typedef struct
+{
+    const char *name;
+    const char *operands;
+    Opcode op;
+    InstrClass instrClass;
+} OpcodeInfo;
+
+static const OpcodeInfo opcodeTable[] = {
+    {"li", "ri", Op_Li, InstrClass_ALU},
+    {"la", "ra", Op_La, InstrClass_ALU},
+    {"lw", "rm", Op_Lw, InstrClass_Load},
+    {"sw", "rm", Op_Sw, InstrClass_Store},
+    {"l.s", "fm", Op_LoadFloat, InstrClass_Load},
+    {"s.s", "fm", Op_StoreFloat, InstrClass_Store},
+    {"li.s", "fF", Op_LiFloat, InstrClass_FloatMove},
+    {"move", "rr", Op_Move, InstrClass_ALU},
+    {"mov.s", "ff", Op_MoveFloat, InstrClass_FloatMove},
+    {"add", "rrx", Op_Add, InstrClass_ALU},
+    {"addu", "rrx", Op_Add, InstrClass_ALU},
+    {"addi", "rri", Op_Add, InstrClass_ALU},
+    {"addiu", "rri", Op_Add, InstrClass_ALU},
+    {"sub", "rrx", Op_Sub, InstrClass_ALU},
+    {"subu", "rrx", Op_Sub, InstrClass_ALU},
+    {"mul", "rrx", Op_Mul, InstrClass_Multiply},
+    {"div", "rx", Op_Div, InstrClass_Divide},
+    {"div", "rrx", Op_Div, InstrClass_Divide},
+    {"mflo", "r", Op_Mflo, InstrClass_ALU},
+    {"mfhi", "r", Op_Mfhi, InstrClass_ALU},
+    {"slt", "rrx", Op_Slt, InstrClass_ALU},
+    {"slti", "rri", Op_Slt, InstrClass_ALU},
+    {"sle", "rrx", Op_Sle, InstrClass_ALU},
+    {"sgt", "rrx", Op_Sgt, InstrClass_ALU},
+    {"sge", "rrx", Op_Sge, InstrClass_ALU},
+    {"seq", "rrx", Op_Seq, InstrClass_ALU},
+    {"sne", "rrx", Op_Sne, InstrClass_ALU},
+    {"sltu", "rrx", Op_Sltu, InstrClass_ALU},
+    {"sltiu", "rri", Op_Sltu, InstrClass_ALU},
+    {"sll", "rri", Op_Sll, InstrClass_ALU},
+    {"srl", "rri", Op_Srl, InstrClass_ALU},
+    {"sra", "rri", Op_Sra, InstrClass_ALU},
+    {"and", "rrx", Op_And, InstrClass_ALU},
+    {"andi", "rri", Op_And, InstrClass_ALU},
+    {"or", "rrx", Op_Or, InstrClass_ALU},
+    {"ori", "rri", Op_Or, InstrClass_ALU},
+    {"xor", "rrx", Op_Xor, InstrClass_ALU},
+    {"xori", "rri", Op_Xor, InstrClass_ALU},
+    {"nor", "rrx", Op_Nor, InstrClass_ALU},
+    {"add.s", "fff", Op_AddFloat, InstrClass_FloatArith},
+    {"sub.s", "fff", Op_SubFloat, InstrClass_FloatArith},
+    {"mul.s", "fff", Op_MulFloat, InstrClass_FloatArith},
+    {"div.s", "fff", Op_DivFloat, InstrClass_FloatArith},
+    {"mtc1", "rf", Op_Mtc1, InstrClass_FloatMove},
+    {"mfc1", "rf", Op_Mfc1, InstrClass_FloatMove},
+    {"cvt.s.w", "ff", Op_CvtSW, InstrClass_FloatMove},
+    {"cvt.w.s", "ff", Op_CvtWS, InstrClass_FloatMove},
+    {"c.eq.s", "ff", Op_CmpEqFloat, InstrClass_FloatArith},
+    {"c.lt.s", "ff", Op_CmpLtFloat, InstrClass_FloatArith},
+    {"c.le.s", "ff", Op_CmpLeFloat, InstrClass_FloatArith},
+    {"movt", "rr", Op_Movt, InstrClass_ALU},
+    {"movf", "rr", Op_Movf, InstrClass_ALU},
+    {"j", "l", Op_Jump, InstrClass_Jump},
+    {"b", "l", Op_Jump, InstrClass_Jump},
+    {"beqz", "rl", Op_Beqz, InstrClass_Branch},
+    {"bnez", "rl", Op_Bnez, InstrClass_Branch},
+    {"beq", "rxl", Op_Beq, InstrClass_Branch},
+    {"bne", "rxl", Op_Bne, InstrClass_Branch},
+    {"syscall", "", Op_Syscall, InstrClass_Syscall},
+    {"nop", "", Op_Nop, InstrClass_ALU},
+};
+
+// A decoded instruction. Operands are stored by position; the source and
+// destination registers are worked out once here for the timing model.
+typedef struct
+{
+    Opcode op;
+    uint8_t instrClass;
+    uint8_t reg[MAX_OPERANDS]; // Register operands by position, REG_NONE if absent
+    uint8_t sources[3];        // Registers read, for the scoreboard
+    uint8_t dest;              // Register written, REG_NONE if none
+    bool useImmediate;         // The last register-or-immediate operand is imm
+    int32_t imm;               // Immediate, memory offset or absolute address
+    float floatImm;
+    int target;                // Instruction index of a branch target
+    int latency;               // Filled in from the cost model at run time
+    int line;
+} Instruction;
+
+typedef struct
+{
+    char *name;
+    uint32_t value; // Data address or instruction index
+    bool isText;
+} Label;
+
+struct MipsProgram
+{
+    Instruction *code;
+    int codeCount;
+    int codeCapacity;
+    uint8_t *data;
+    uint32_t dataSize;
+    uint32_t dataCapacity;
+    int entry;               // Instruction index of main
+    uint32_t spillStart;     // Address range of spill_area, empty if absent
+    uint32_t spillEnd;
+    Label *labels;           // Open-addressing hash table
+    int labelCapacity;
+    int labelCount;
+};
+
+// A .text line waiting for every label to be known
+typedef struct
+{
+    char *text;
+    int line;
+} PendingLine;
+
+// ---- Cost model ----
+
+typedef struct
+{
+    const char *name;
+    size_t offset;
+} CostParameter;
+
+static const CostParameter costParameters[] = {
+    {"alu", offsetof(CostModel, aluLatency)},
+    {"load", offsetof(CostModel, loadLatency)},
+    {"mul", offsetof(CostModel, mulLatency)},
+    {"div", offsetof(CostModel, divLatency)},
+    {"fpadd", offsetof(CostModel, fpAddLatency)},
+    {"fpmul", offsetof(CostModel, fpMulLatency)},
+    {"fpdiv", offsetof(CostModel, fpDivLatency)},
+    {"fpmove", offsetof(CostModel, fpMoveLatency)},
+    {"branch", offsetof(CostModel, branchPenalty)},
+    {"syscall", offsetof(CostModel, syscallCycles)},
+    {"depth", offsetof(CostModel, pipelineDepth)},
+};
+
+void defaultCostModel(CostModel *model)
+{
+    model->aluLatency = 1;
+    model->loadLatency = 2;
+    model->mulLatency = 5;
+    model->divLatency = 20;
+    model->fpAddLatency = 2;
+    model->fpMulLatency = 4;
+    model->fpDivLatency = 12;
+    model->fpMoveLatency = 1;
+    model->branchPenalty = 1;
+    model->syscallCycles = 1;
+    model->pipelineDepth = 5;
+}
+
+bool setCostParameter(CostModel *model, const char *name, int value)
+{
+    if (value < 0)
+        return false;
+    for (size_t i = 0; i < sizeof(costParameters) / sizeof(costParameters[0]); i++)
+    {
+        if (strcmp(costParameters[i].name, name) == 0)
+        {
+            *(int *)((char *)model + costParameters[i].offset) = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool loadCostModel(CostModel *model, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    int lineNumber = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        lineNumber++;
+        char *comment = strchr(line, '#');
+        if (comment != NULL)
+            *comment = '\0';
+
+        char name[64];
+        int value;
+        char rest;
+        if (sscanf(line, " %63[^= \t] = %d %c", name, &value, &rest) == 2)
+        {
+            if (!setCostParameter(model, name, value))
+            {
+                fprintf(stderr, "%s:%d: Error: Unknown or negative cost parameter '%s'\n", path, lineNumber, name);
+                ok = false;
+            }
+        }
+        else if (sscanf(line, " %c", &rest) == 1)
+        {
+            fprintf(stderr, "%s:%d: Error: Expected 'name = value'\n", path, lineNumber);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+// ---- Labels ----
+
+static uint32_t hashName(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    for (; *name; name++)
+        hash = (hash ^ (unsigned char)*name) * 16777619u;
+    return hash;
+}
+
+static Label *findLabelSlot(MipsProgram *program, const char *name)
+{
+    uint32_t mask = (uint32_t)program->labelCapacity - 1;
+    for (uint32_t i = hashName(name) & mask;; i = (i + 1) & mask)
+    {
+        Label *slot = &program->labels[i];
+        if (slot->name == NULL || strcmp(slot->name, name) == 0)
+            return slot;
+    }
+}
+
+static Label *findLabel(MipsProgram *program, const char *name)
+{
+    Label *slot = findLabelSlot(program, name);
+    return slot->name != NULL ? slot : NULL;
+}
+
+static bool defineLabel(MipsProgram *program, const char *name, uint32_t value, bool isText, int line)
+{
+    // Keep the table at most half full
+    if ((program->labelCount + 1) * 2 > program->labelCapacity)
+    {
+        Label *old = program->labels;
+        int oldCapacity = program->labelCapacity;
+        program->labelCapacity = oldCapacity ? oldCapacity * 2 : 64;
+        program->labels = (Label *)calloc(program->labelCapacity, sizeof(Label));
+        for (int i = 0; i < oldCapacity; i++)
+        {
+            if (old[i].name != NULL)
+                *findLabelSlot(program, old[i].name) = old[i];
+        }
+        free(old);
+    }
+
+    Label *slot = findLabelSlot(program, name);
+    if (slot->name != NULL)
+    {
+        fprintf(stderr, "Line %d: Error: Label '%s' defined twice\n", line, name);
+        return false;
+    }
+    slot->name = strdup(name);
+    slot->value = value;
+    slot->isText = isText;
+    program->labelCount++;
+    return true;
+}
+
+// ---- Assembler ----
+
+static bool isLabelChar(char c)
+{
+    return isalnum((unsigned char)c) || c == '_' || c == '.';
+}
+
+static char *trim(char *str)
+{
+    while (isspace((unsigned char)*str))
+        str++;
+    char *end = str + strlen(str);
+    while (end > str && isspace((unsigned char)end[-1]))
+        *--end = '\0';
+    return str;
+}
+
+static bool parseInteger(const char *str, int32_t *value)
+{
+    char *end;
+    long long parsed = strtoll(str, &end, 0);
+    if (end == str || *end != '\0' || parsed < INT32_MIN || parsed > UINT32_MAX)
+        return false;
+    *value = (int32_t)parsed;
+    return true;
+}
+
+static uint8_t parseRegister(const char *str)
+{
+    static const char *names[32] = {
+        "zero", "at", "v0", "v1", "a0", "a1", "a2", "a3",
+        "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+        "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+        "t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra"};
+
+    if (str[0] != '$')
+        return REG_NONE;
+    str++;
+
+    if (str[0] == 'f' && isdigit((unsigned char)str[1]))
+    {
+        int32_t n;
+        if (parseInteger(str + 1, &n) && n >= 0 && n < 32)
+            return REG_FLOAT + n;
+        return REG_NONE;
+    }
+    if (isdigit((unsigned char)str[0]))
+    {
+        int32_t n;
+        if (parseInteger(str, &n) && n >= 0 && n < 32)
+            return n;
+        return REG_NONE;
+    }
+    for (int i = 0; i < 32; i++)
+    {
+        if (strcmp(names[i], str) == 0)
+            return i;
+    }
+    return REG_NONE;
+}
+
+// Parse "label", "label+8", "8($t9)" or "label+8($t9)" into base and offset
+static bool parseAddress(MipsProgram *program, char *str, uint8_t *base, int32_t *offset, int line)
+{
+    *base = REG_NONE;
+    *offset = 0;
+
+    char *paren = strchr(str, '(');
+    if (paren != NULL)
+    {
+        char *close = strchr(paren, ')');
+        if (close == NULL || close[1] != '\0')
+            return false;
+        *close = '\0';
+        *base = parseRegister(trim(paren + 1));
+        if (*base == REG_NONE || *base >= REG_FLOAT)
+            return false;
+        *paren = '\0';
+    }
+
+    str = trim(str);
+    if (*str == '\0')
+        return *base != REG_NONE;
+    if (isdigit((unsigned char)*str) || *str == '-' || *str == '+')
+        return parseInteger(str, offset);
+
+    // A label, optionally followed by a constant displacement
+    char *sign = str;
+    while (isLabelChar(*sign))
+        sign++;
+    int32_t displacement = 0;
+    if (*sign != '\0')
+    {
+        if ((*sign != '+' && *sign != '-') || !parseInteger(sign, &displacement))
+            return false;
+        *sign = '\0';
+    }
+
+    Label *label = findLabel(program, str);
+    if (label == NULL || label->isText)
+    {
+        fprintf(stderr, "Line %d: Error: Unknown data label '%s'\n", line, str);
+        return false;
+    }
+    *offset = (int32_t)label->value + displacement;
+    return true;
+}
+
+// Split an operand list on commas into at most MAX_OPERANDS fields
+static int splitOperands(char *str, char **fields)
+{
+    int count = 0;
+    str = trim(str);
+    if (*str == '\0')
+        return 0;
+    while (count <= MAX_OPERANDS)
+    {
+        char *comma = strchr(str, ',');
+        if (comma != NULL)
+            *comma = '\0';
+        if (count == MAX_OPERANDS)
+            return MAX_OPERANDS + 1;
+        fields[count++] = trim(str);
+        if (comma == NULL)
+            break;
+        str = comma + 1;
+    }
+    return count;
+}
+
+static bool decodeInstruction(MipsProgram *program, char *text, int line, Instruction *instr)
+{
+    char *mnemonic = text;
+    char *rest = text;
+    while (*rest && !isspace((unsigned char)*rest))
+        rest++;
+    if (*rest)
+        *rest++ = '\0';
+
+    char *fields[MAX_OPERANDS + 1];
+    int count = splitOperands(rest, fields);
+
+    const OpcodeInfo *info = NULL;
+    bool knownName = false;
+    for (size_t i = 0; i < sizeof(opcodeTable) / sizeof(opcodeTable[0]); i++)
+    {
+        if (strcmp(opcodeTable[i].name, mnemonic) == 0)
+        {
+            knownName = true;
+            if ((int)strlen(opcodeTable[i].operands) == count)
+            {
+                info = &opcodeTable[i];
+                break;
+            }
+        }
+    }
+    if (info == NULL)
+    {
+        fprintf(stderr, "Line %d: Error: %s '%s'\n", line,
+                knownName ? "Wrong number of operands for" : "Unsupported instruction", mnemonic);
+        return false;
+    }
+
+    memset(instr, 0, sizeof(Instruction));
+    instr->op = info->op;
+    instr->instrClass = info->instrClass;
+    instr->line = line;
+    instr->target = -1;
+    memset(instr->reg, REG_NONE, sizeof(instr->reg));
+
+    for (int i = 0; i < count; i++)
+    {
+        char kind = info->operands[i];
+        char *field = fields[i];
+        bool ok = true;
+        switch (kind)
+        {
+        case 'r':
+        case 'f':
+            instr->reg[i] = parseRegister(field);
+            ok = instr->reg[i] != REG_NONE && (instr->reg[i] >= REG_FLOAT) == (kind == 'f');
+            break;
+        case 'x':
+            if (field[0] == '$')
+            {
+                instr->reg[i] = parseRegister(field);
+                ok = instr->reg[i] != REG_NONE && instr->reg[i] < REG_FLOAT;
+            }
+            else
+            {
+                instr->useImmediate = true;
+                ok = parseInteger(field, &instr->imm);
+            }
+            break;
+        case 'i':
+            instr->useImmediate = true;
+            ok = parseInteger(field, &instr->imm);
+            break;
+        case 'F':
+        {
+            char *end;
+            instr->floatImm = strtof(field, &end);
+            ok = end != field && *end == '\0';
+            break;
+        }
+        case 'm':
+        case 'a':
+            ok = parseAddress(program, field, &instr->reg[i], &instr->imm, line);
+            break;
+        case 'l':
+        {
+            Label *label = findLabel(program, field);
+            ok = label != NULL && label->isText;
+            if (ok)
+                instr->target = (int)label->value;
+            break;
+        }
+        }
+        if (!ok)
+        {
+            fprintf(stderr, "Line %d: Error: Bad operand '%s' for %s\n", line, field, mnemonic);
+            return false;
+        }
+    }
+
+    // Work out what the scoreboard has to wait for and what it produces
+    memset(instr->sources, REG_NONE, sizeof(instr->sources));
+    instr->dest = REG_NONE;
+    switch (instr->op)
+    {
+    case Op_Sw:
+    case Op_StoreFloat:
+        instr->sources[0] = instr->reg[0];
+        instr->sources[1] = instr->reg[1];
+        break;
+    case Op_Mtc1:
+        // mtc1 rt, fs copies the integer register into the float one
+        instr->sources[0] = instr->reg[0];
+        instr->dest = instr->reg[1];
+        break;
+    case Op_Mfc1:
+        instr->sources[0] = instr->reg[1];
+        instr->dest = instr->reg[0];
+        break;
+    case Op_CmpEqFloat:
+    case Op_CmpLtFloat:
+    case Op_CmpLeFloat:
+        instr->sources[0] = instr->reg[0];
+        instr->sources[1] = instr->reg[1];
+        instr->dest = REG_FCC;
+        break;
+    case Op_Movt:
+    case Op_Movf:
+        // The destination keeps its old value when the flag says no
+        instr->sources[0] = instr->reg[0];
+        instr->sources[1] = instr->reg[1];
+        instr->sources[2] = REG_FCC;
+        instr->dest = instr->reg[0];
+        break;
+    case Op_Div:
+        if (count == 2)
+        {
+            instr->sources[0] = instr->reg[0];
+            instr->sources[1] = instr->reg[1];
+            instr->dest = REG_LO;
+        }
+        else
+        {
+            instr->sources[0] = instr->reg[1];
+            instr->sources[1] = instr->reg[2];
+            instr->dest = instr->reg[0];
+        }
+        break;
+    case Op_Mflo:
+        instr->sources[0] = REG_LO;
+        instr->dest = instr->reg[0];
+        break;
+    case Op_Mfhi:
+        instr->sources[0] = REG_HI;
+        instr->dest = instr->reg[0];
+        break;
+    case Op_Beqz:
+    case Op_Bnez:
+    case Op_Beq:
+    case Op_Bne:
+        instr->sources[0] = instr->reg[0];
+        instr->sources[1] = instr->reg[1];
+        break;
+    case Op_Syscall:
+        instr->sources[0] = 2;              // $v0
+        instr->sources[1] = 4;              // $a0
+        instr->sources[2] = REG_FLOAT + 12; // $f12
+        break;
+    case Op_Jump:
+    case Op_Nop:
+        break;
+    default:
+        // Destination first, sources after
+        instr->dest = instr->reg[0];
+        instr->sources[0] = instr->reg[1];
+        instr->sources[1] = instr->reg[2];
+        break;
+    }
+    if (instr->dest == 0)
+        instr->dest = REG_NONE; // Writes to $zero are discarded
+    return true;
+}
+
+static bool reserveData(MipsProgram *program, uint32_t bytes)
+{
+    if (program->dataSize + bytes > program->dataCapacity)
+    {
+        uint32_t capacity = program->dataCapacity ? program->dataCapacity : 256;
+        while (capacity < program->dataSize + bytes)
+            capacity *= 2;
+        uint8_t *data = (uint8_t *)realloc(program->data, capacity);
+        if (data == NULL)
+            return false;
+        memset(data + program->dataCapacity, 0, capacity - program->dataCapacity);
+        program->data = data;
+        program->dataCapacity = capacity;
+    }
+    return true;
+}
+
+static bool assembleDirective(MipsProgram *program, char *directive, int line)
+{
+    char *args = directive;
+    while (*args && !isspace((unsigned char)*args))
+        args++;
+    if (*args)
+        *args++ = '\0';
+
+    if (strcmp(directive, ".space") == 0)
+    {
+        int32_t size;
+        if (!parseInteger(trim(args), &size) || size < 0)
+        {
+            fprintf(stderr, "Line %d: Error: Bad .space size\n", line);
+            return false;
+        }
+        // Keep every label word-aligned, as the generator expects
+        uint32_t padded = ((uint32_t)size + 3) & ~3u;
+        if (!reserveData(program, padded))
+            return false;
+        program->dataSize += padded;
+        return true;
+    }
+
+    bool isFloat = strcmp(directive, ".float") == 0;
+    if (!isFloat && strcmp(directive, ".word") != 0)
+    {
+        fprintf(stderr, "Line %d: Error: Unsupported directive '%s'\n", line, directive);
+        return false;
+    }
+
+    for (char *item = strtok(args, ","); item != NULL; item = strtok(NULL, ","))
+    {
+        item = trim(item);
+        uint32_t word;
+        if (isFloat)
+        {
+            char *end;
+            float value = strtof(item, &end);
+            if (end == item || *end != '\0')
+            {
+                fprintf(stderr, "Line %d: Error: Bad .float value '%s'\n", line, item);
+                return false;
+            }
+            memcpy(&word, &value, sizeof(word));
+        }
+        else
+        {
+            int32_t value;
+            if (!parseInteger(item, &value))
+            {
+                fprintf(stderr, "Line %d: Error: Bad .word value '%s'\n", line, item);
+                return false;
+            }
+            word = (uint32_t)value;
+        }
+        if (!reserveData(program, 4))
+            return false;
+        memcpy(program->data + program->dataSize, &word, 4);
+        program->dataSize += 4;
+    }
+    return true;
+}
+
+MipsProgram *assembleMipsSource(const char *source)
+{
+    MipsProgram *program = (MipsProgram *)calloc(1, sizeof(MipsProgram));
+    PendingLine *pending = NULL;
+    int pendingCount = 0;
+    int pendingCapacity = 0;
+    bool inText = true;
+    bool ok = true;
+
+    // Pass 1: lay out .data and give every label its value. Text lines are
+    // kept for pass 2, since streaming output defines data after the code.
+    char *copy = strdup(source);
+    char *next = copy;
+    for (int line = 1; next != NULL && ok; line++)
+    {
+        char *text = next;
+        next = strchr(text, '\n');
+        if (next != NULL)
+            *next++ = '\0';
+
+        char *comment = strchr(text, '#');
+        if (comment != NULL)
+            *comment = '\0';
+        text = trim(text);
+
+        // Leading labels
+        for (;;)
+        {
+            char *colon = text;
+            while (isLabelChar(*colon))
+                colon++;
+            if (colon == text || *colon != ':')
+                break;
+            *colon = '\0';
+            uint32_t value = inText ? (uint32_t)pendingCount : SIM_DATA_BASE + program->dataSize;
+            ok = defineLabel(program, text, value, inText, line);
+            text = trim(colon + 1);
+        }
+        if (!ok || *text == '\0')
+            continue;
+
+        if (strcmp(text, ".text") == 0 || strcmp(text, ".data") == 0)
+        {
+            inText = text[1] == 't';
+            continue;
+        }
+        if (strncmp(text, ".globl", 6) == 0)
+            continue;
+
+        if (!inText)
+        {
+            ok = assembleDirective(program, text, line);
+            continue;
+        }
+
+        if (pendingCount == pendingCapacity)
+        {
+            pendingCapacity = pendingCapacity ? pendingCapacity * 2 : 256;
+            pending = (PendingLine *)realloc(pending, sizeof(PendingLine) * pendingCapacity);
+        }
+        pending[pendingCount].text = text;
+        pending[pendingCount].line = line;
+        pendingCount++;
+    }
+
+    // Pass 2: decode the instructions now that every label is known
+    if (ok)
+    {
+        program->code = (Instruction *)malloc(sizeof(Instruction) * (pendingCount ? pendingCount : 1));
+        program->codeCapacity = pendingCount;
+        for (int i = 0; i < pendingCount && ok; i++)
+        {
+            ok = decodeInstruction(program, pending[i].text, pending[i].line, &program->code[i]);
+            program->codeCount++;
+        }
+    }
+
+    if (ok)
+    {
+        Label *main = findLabel(program, "main");
+        if (main == NULL || !main->isText)
+        {
+            fprintf(stderr, "Error: No main label in .text\n");
+            ok = false;
+        }
+        else
+        {
+            program->entry = (int)main->value;
+        }
+    }
+
+    if (ok)
+    {
+        // Spill traffic is reported separately from ordinary variable traffic
+        Label *spill = findLabel(program, "spill_area");
+        if (spill != NULL && !spill->isText)
+        {
+            program->spillStart = spill->value;
+            program->spillEnd = SIM_DATA_BASE + program->dataSize;
+            for (int i = 0; i < program->labelCapacity; i++)
+            {
+                Label *label = &program->labels[i];
+                if (label->name != NULL && !label->isText && label->value > spill->value && label->value < program->spillEnd)
+                    program->spillEnd = label->value;
+            }
+        }
+    }
+
+    free(pending);
+    free(copy);
+    if (!ok)
+    {
+        freeMipsProgram(program);
+        return NULL;
+    }
+    return program;
+}
+
+MipsProgram *assembleMipsFile(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    rewind(file);
+
+    char *source = (char *)malloc(length + 1);
+    size_t read = fread(source, 1, length, file);
+    source[read] = '\0';
+    fclose(file);
+
+    MipsProgram *program = assembleMipsSource(source);
+    free(source);
+    return program;
+}
+
+void freeMipsProgram(MipsProgram *program)
+{
+    if (program == NULL)
+        return;
+    for (int i = 0; i < program->labelCapacity; i++)
+        free(program->labels[i].name);
+    free(program->labels);
+    free(program->code);
+    free(program->data);
+    free(program);
+}
+
+// ---- Execution ----
+
+static int latencyFor(const Instruction *instr, const CostModel *model)
+{
+    switch (instr->op)
+    {
+    case Op_Lw:
+    case Op_LoadFloat:
+        return model->loadLatency;
+    case Op_Mul:
+        return model->mulLatency;
+    case Op_Div:
+        return model->divLatency;
+    case Op_AddFloat:
+    case Op_SubFloat:
+    case Op_CvtSW:
+    case Op_CvtWS:
+    case Op_CmpEqFloat:
+    case Op_CmpLtFloat:
+    case Op_CmpLeFloat:
+        return model->fpAddLatency;
+    case Op_MulFloat:
+        return model->fpMulLatency;
+    case Op_DivFloat:
+        return model->fpDivLatency;
+    case Op_LiFloat:
+    case Op_MoveFloat:
+    case Op_Mtc1:
+    case Op_Mfc1:
+        return model->fpMoveLatency;
+    default:
+        return model->aluLatency;
+    }
+}
+
+// Check a word access and return its offset into the data segment
+static bool dataOffset(MipsProgram *program, int32_t address, const Instruction *instr, uint32_t *offset)
+{
+    uint32_t addr = (uint32_t)address;
+    if ((addr & 3) != 0 || addr < SIM_DATA_BASE || addr - SIM_DATA_BASE + 4 > program->dataSize)
+    {
+        fprintf(stderr, "Line %d: Error: Bad memory access at 0x%08x\n", instr->line, addr);
+        return false;
+    }
+    *offset = addr - SIM_DATA_BASE;
+    return true;
+}
+
+bool runMipsProgram(MipsProgram *program, const CostModel *model, FILE *out, long long maxSteps, SimulatorStats *stats)
+{
+    int32_t r[32] = {0};
+    float f[32] = {0};
+    int32_t lo = 0, hi = 0;
+    bool fcc = false;
+    long long ready[REG_COUNT] = {0};
+    long long cycle = 0;
+
+    memset(stats, 0, sizeof(SimulatorStats));
+    for (int i = 0; i < program->codeCount; i++)
+        program->code[i].latency = latencyFor(&program->code[i], model);
+
+    // Each run starts from the assembled image
+    uint8_t *image = (uint8_t *)malloc(program->dataSize ? program->dataSize : 1);
+    memcpy(image, program->data, program->dataSize);
+    uint8_t *memory = program->data;
+    program->data = image;
+
+    bool ok = true;
+    int pc = program->entry;
+    for (;;)
+    {
+        if (pc < 0 || pc >= program->codeCount)
+        {
+            fprintf(stderr, "Error: Execution ran off the end of .text\n");
+            ok = false;
+            break;
+        }
+        if (stats->instructions == maxSteps)
+        {
+            fprintf(stderr, "Error: Step limit of %lld instructions reached\n", maxSteps);
+            ok = false;
+            break;
+        }
+
+        const Instruction *instr = &program->code[pc++];
+        stats->instructions++;
+        stats->classCounts[instr->instrClass]++;
+
+        // Issue once every source is ready
+        long long issue = cycle;
+        for (int i = 0; i < 3; i++)
+        {
+            uint8_t s = instr->sources[i];
+            if (s != REG_NONE && ready[s] > issue)
+                issue = ready[s];
+        }
+        stats->stallCycles += issue - cycle;
+        cycle = issue + 1;
+        if (instr->dest != REG_NONE)
+            ready[instr->dest] = issue + instr->latency;
+
+        int32_t a = instr->reg[1] < REG_FLOAT ? r[instr->reg[1]] : 0;
+        int32_t b = instr->useImmediate ? instr->imm : (instr->reg[2] < REG_FLOAT ? r[instr->reg[2]] : 0);
+        uint8_t d = instr->reg[0];
+        bool taken = false;
+
+        switch (instr->op)
+        {
+        case Op_Li:
+            r[d] = instr->imm;
+            break;
+        case Op_La:
+            r[d] = instr->imm + (instr->reg[1] != REG_NONE ? r[instr->reg[1]] : 0);
+            break;
+        case Op_Lw:
+        case Op_Sw:
+        case Op_LoadFloat:
+        case Op_StoreFloat:
+        {
+            uint32_t offset;
+            int32_t address = instr->imm + (instr->reg[1] != REG_NONE ? r[instr->reg[1]] : 0);
+            if (!dataOffset(program, address, instr, &offset))
+            {
+                ok = false;
+                break;
+            }
+            bool isStore = instr->op == Op_Sw || instr->op == Op_StoreFloat;
+            void *value = instr->op == Op_Lw || instr->op == Op_Sw ? (void *)&r[d] : (void *)&f[d - REG_FLOAT];
+            if (isStore)
+                memcpy(program->data + offset, value, 4);
+            else
+                memcpy(value, program->data + offset, 4);
+
+            bool spill = (uint32_t)address >= program->spillStart && (uint32_t)address < program->spillEnd;
+            if (isStore)
+            {
+                stats->stores++;
+                stats->spillStores += spill;
+            }
+            else
+            {
+                stats->loads++;
+                stats->spillLoads += spill;
+            }
+            break;
+        }
+        case Op_LiFloat:
+            f[d - REG_FLOAT] = instr->floatImm;
+            break;
+        case Op_Move:
+            r[d] = a;
+            break;
+        case Op_MoveFloat:
+            f[d - REG_FLOAT] = f[instr->reg[1] - REG_FLOAT];
+            break;
+        case Op_Add:
+            r[d] = (int32_t)((uint32_t)a + (uint32_t)b);
+            break;
+        case Op_Sub:
+            r[d] = (int32_t)((uint32_t)a - (uint32_t)b);
+            break;
+        case Op_Mul:
+            r[d] = (int32_t)((uint32_t)a * (uint32_t)b);
+            break;
+        case Op_Div:
+        {
+            // Two-operand form divides reg[0] by the second operand
+            int32_t dividend = instr->dest == REG_LO ? r[d] : a;
+            int32_t divisor = instr->dest == REG_LO ? (instr->useImmediate ? instr->imm : r[instr->reg[1]]) : b;
+            if (divisor == 0 || (dividend == INT32_MIN && divisor == -1))
+            {
+                lo = dividend;
+                hi = 0;
+            }
+            else
+            {
+                lo = dividend / divisor;
+                hi = dividend % divisor;
+            }
+            ready[REG_HI] = ready[REG_LO] = issue + instr->latency;
+            if (instr->dest != REG_LO && instr->dest != REG_NONE)
+                r[d] = lo;
+            break;
+        }
+        case Op_Mflo:
+            r[d] = lo;
+            break;
+        case Op_Mfhi:
+            r[d] = hi;
+            break;
+        case Op_Slt:
+            r[d] = a < b;
+            break;
+        case Op_Sle:
+            r[d] = a <= b;
+            break;
+        case Op_Sgt:
+            r[d] = a > b;
+            break;
+        case Op_Sge:
+            r[d] = a >= b;
+            break;
+        case Op_Seq:
+            r[d] = a == b;
+            break;
+        case Op_Sne:
+            r[d] = a != b;
+            break;
+        case Op_Sltu:
+            r[d] = (uint32_t)a < (uint32_t)b;
+            break;
+        case Op_Sll:
+            r[d] = (int32_t)((uint32_t)a << (b & 31));
+            break;
+        case Op_Srl:
+            r[d] = (int32_t)((uint32_t)a >> (b & 31));
+            break;
+        case Op_Sra:
+            r[d] = a >> (b & 31);
+            break;
+        case Op_And:
+            r[d] = a & b;
+            break;
+        case Op_Or:
+            r[d] = a | b;
+            break;
+        case Op_Xor:
+            r[d] = a ^ b;
+            break;
+        case Op_Nor:
+            r[d] = ~(a | b);
+            break;
+        case Op_AddFloat:
+            f[d - REG_FLOAT] = f[instr->reg[1] - REG_FLOAT] + f[instr->reg[2] - REG_FLOAT];
+            break;
+        case Op_SubFloat:
+            f[d - REG_FLOAT] = f[instr->reg[1] - REG_FLOAT] - f[instr->reg[2] - REG_FLOAT];
+            break;
+        case Op_MulFloat:
+            f[d - REG_FLOAT] = f[instr->reg[1] - REG_FLOAT] * f[instr->reg[2] - REG_FLOAT];
+            break;
+        case Op_DivFloat:
+            f[d - REG_FLOAT] = f[instr->reg[1] - REG_FLOAT] / f[instr->reg[2] - REG_FLOAT];
+            break;
+        case Op_Mtc1:
+            memcpy(&f[instr->reg[1] - REG_FLOAT], &r[d], 4);
+            break;
+        case Op_Mfc1:
+            memcpy(&r[d], &f[instr->reg[1] - REG_FLOAT], 4);
+            break;
+        case Op_CvtSW:
+        {
+            int32_t word;
+            memcpy(&word, &f[instr->reg[1] - REG_FLOAT], 4);
+            f[d - REG_FLOAT] = (float)word;
+            break;
+        }
+        case Op_CvtWS:
+        {
+            int32_t word = (int32_t)f[instr->reg[1] - REG_FLOAT];
+            memcpy(&f[d - REG_FLOAT], &word, 4);
+            break;
+        }
+        case Op_CmpEqFloat:
+            fcc = f[d - REG_FLOAT] == f[instr->reg[1] - REG_FLOAT];
+            break;
+        case Op_CmpLtFloat:
+            fcc = f[d - REG_FLOAT] < f[instr->reg[1] - REG_FLOAT];
+            break;
+        case Op_CmpLeFloat:
+            fcc = f[d - REG_FLOAT] <= f[instr->reg[1] - REG_FLOAT];
+            break;
+        case Op_Movt:
+            if (fcc)
+                r[d] = a;
+            break;
+        case Op_Movf:
+            if (!fcc)
+                r[d] = a;
+            break;
+        case Op_Jump:
+            taken = true;
+            break;
+        case Op_Beqz:
+            taken = r[d] == 0;
+            break;
+        case Op_Bnez:
+            taken = r[d] != 0;
+            break;
+        case Op_Beq:
+            taken = r[d] == (instr->useImmediate ? instr->imm : r[instr->reg[1]]);
+            break;
+        case Op_Bne:
+            taken = r[d] != (instr->useImmediate ? instr->imm : r[instr->reg[1]]);
+            break;
+        case Op_Syscall:
+            cycle += model->syscallCycles - 1;
+            switch (r[2])
+            {
+            case 1:
+                if (out)
+                    fprintf(out, "%d", r[4]);
+                break;
+            case 2:
+                if (out)
+                    fprintf(out, "%.9g", f[12]);
+                break;
+            case 11:
+                if (out)
+                    fputc((char)r[4], out);
+                break;
+            case 10:
+                pc = -1;
+                break;
+            default:
+                fprintf(stderr, "Line %d: Error: Unsupported syscall %d\n", instr->line, r[2]);
+                ok = false;
+                break;
+            }
+            break;
+        case Op_Nop:
+            break;
+        }
+        r[0] = 0;
+
+        if (!ok || pc == -1)
+            break;
+        if (taken)
+        {
+            pc = instr->target;
+            cycle += model->branchPenalty;
+            stats->takenBranches++;
+        }
+    }
+
+    stats->cycles = cycle + (model->pipelineDepth > 0 ? model->pipelineDepth - 1 : 0);
+
+    free(program->data);
+    program->data = memory;
+    return ok;
+}
+
+const char *instrClassName(InstrClass instrClass)
+{
+    static const char *names[InstrClass_Count] = {
+        "alu", "multiply", "divide", "load", "store", "branch", "jump",
+        "float arith", "float move", "syscall"};
+    return instrClass < InstrClass_Count ? names[instrClass] : "unknown";
+}
+
+void printSimulatorStats(FILE *file, const SimulatorStats *stats)
+{
+    fprintf(file, "Instructions:    %lld\n", stats->instructions);
+    for (int i = 0; i < InstrClass_Count; i++)
+    {
+        if (stats->classCounts[i] == 0)
+            continue;
+        fprintf(file, "  %-14s %lld (%.1f%%)\n", instrClassName((InstrClass)i), stats->classCounts[i],
+                100.0 * stats->classCounts[i] / stats->instructions);
+    }
+    fprintf(file, "Loads:           %lld (%lld from spill_area)\n", stats->loads, stats->spillLoads);
+    fprintf(file, "Stores:          %lld (%lld to spill_area)\n", stats->stores, stats->spillStores);
+    fprintf(file, "Taken branches:  %lld\n", stats->takenBranches);
+    fprintf(file, "Stall cycles:    %lld\n", stats->stallCycles);
+    fprintf(file, "Cycles:          %lld\n", stats->cycles);
+    fprintf(file, "CPI:             %.3f\n", stats->instructions ? (double)stats->cycles / stats->instructions : 0.0);
+}
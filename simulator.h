@@ -0,0 +1,87 @@
+// simulator.h
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Base address of the .data segment, as in SPIM and MARS
+#define SIM_DATA_BASE 0x10010000
+
+// Instruction classes the statistics are broken down by
+typedef enum
+{
+    InstrClass_ALU,        // li, la, move, add, sub, logic, shifts, set-on-compare, mflo
+    InstrClass_Multiply,   // mul
+    InstrClass_Divide,     // div
+    InstrClass_Load,       // lw, l.s
+    InstrClass_Store,      // sw, s.s
+    InstrClass_Branch,     // beqz, bnez, beq, bne
+    InstrClass_Jump,       // j, b
+    InstrClass_FloatArith, // add.s, sub.s, mul.s, div.s
+    InstrClass_FloatMove,  // li.s, mov.s, mtc1, mfc1, cvt
+    InstrClass_Syscall,
+    InstrClass_Count
+} InstrClass;
+
+// Pipeline cost model. Every instruction issues in one cycle on an in-order
+// pipeline; an instruction whose source is not ready yet stalls until it is.
+// Latencies are cycles from issue until the result can be read.
+typedef struct
+{
+    int aluLatency;
+    int loadLatency;      // 2 gives the classic one-cycle load-use stall
+    int mulLatency;
+    int divLatency;       // Until LO can be read by mflo
+    int fpAddLatency;     // add.s, sub.s, cvt.s.w
+    int fpMulLatency;
+    int fpDivLatency;
+    int fpMoveLatency;    // li.s, mov.s, mtc1, mfc1
+    int branchPenalty;    // Extra cycles for a taken branch or a jump
+    int syscallCycles;    // Cycles a syscall occupies the pipeline
+    int pipelineDepth;    // Stages to fill before the first instruction retires
+} CostModel;
+
+typedef struct
+{
+    long long instructions;
+    long long classCounts[InstrClass_Count];
+    long long loads;
+    long long stores;
+    long long spillLoads;  // Loads from spill_area
+    long long spillStores; // Stores to spill_area
+    long long takenBranches;
+    long long stallCycles;
+    long long cycles;
+} SimulatorStats;
+
+typedef struct MipsProgram MipsProgram;
+
+// Fill in the default cost model, a classic five-stage pipeline
+void defaultCostModel(CostModel *model);
+
+// Set one cost model parameter by name ("load", "mul", "branch", ...)
+// Returns false for an unknown name
+bool setCostParameter(CostModel *model, const char *name, int value);
+
+// Read "name = value" lines into a cost model; '#' starts a comment
+bool loadCostModel(CostModel *model, const char *path);
+
+// Assemble a file or a string of generated MIPS; returns NULL on error
+MipsProgram *assembleMipsFile(const char *path);
+MipsProgram *assembleMipsSource(const char *source);
+
+void freeMipsProgram(MipsProgram *program);
+
+// Run a program from main until exit, writing its output to out (which may
+// be NULL). Stops with an error after maxSteps instructions.
+bool runMipsProgram(MipsProgram *program, const CostModel *model, FILE *out, long long maxSteps, SimulatorStats *stats);
+
+const char *instrClassName(InstrClass instrClass);
+
+// Print the statistics of a run
+void printSimulatorStats(FILE *file, const SimulatorStats *stats);
+
+#endif // SIMULATOR_H
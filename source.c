@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source.h"
+
+// Read the whole file into a heap buffer with room for the terminators
+static char *readWholeFile(int fd, size_t length)
+{
+    char *data = (char *)malloc(length + 2);
+    if (data == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for source buffer\n");
+        return NULL;
+    }
+
+    size_t done = 0;
+    while (done < length)
+    {
+        ssize_t n = read(fd, data + done, length - done);
+        if (n <= 0)
+        {
+            fprintf(stderr, "Error: Failed to read source file\n");
+            free(data);
+            return NULL;
+        }
+        done += (size_t)n;
+    }
+    data[length] = '\0';
+    data[length + 1] = '\0';
+    return data;
+}
+
+SourceBuffer *openSourceFile(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        perror(path);
+        close(fd);
+        return NULL;
+    }
+
+    SourceBuffer *source = (SourceBuffer *)malloc(sizeof(SourceBuffer));
+    if (source == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for SourceBuffer\n");
+        close(fd);
+        return NULL;
+    }
+    source->length = (size_t)info.st_size;
+    source->data = NULL;
+    source->mapped = false;
+
+    // The bytes between the end of the file and the end of its last page
+    // read as zero, so the mapping supplies the two NUL terminators for
+    // free whenever at least two of them are left over. The mapping is
+    // private and writable because flex NUL-terminates yytext in place.
+    long pageSize = sysconf(_SC_PAGESIZE);
+    size_t slack = pageSize > 0 ? (size_t)pageSize - source->length % (size_t)pageSize : 0;
+    if (source->length > 0 && slack >= 2 && slack != (size_t)pageSize)
+    {
+        void *data = mmap(NULL, source->length + 2, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            madvise(data, source->length + 2, MADV_SEQUENTIAL);
+            source->data = (char *)data;
+            source->mapped = true;
+        }
+    }
+
+    if (source->data == NULL)
+    {
+        source->data = readWholeFile(fd, source->length);
+        if (source->data == NULL)
+        {
+            free(source);
+            close(fd);
+            return NULL;
+        }
+    }
+
+    close(fd);
+    return source;
+}
+
+SourceBuffer *openSourceText(const char *text, size_t length)
+{
+    SourceBuffer *source = (SourceBuffer *)malloc(sizeof(SourceBuffer));
+    char *data = (char *)malloc(length + 2);
+    if (source == NULL || data == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for source buffer\n");
+        free(source);
+        free(data);
+        return NULL;
+    }
+    memcpy(data, text, length);
+    data[length] = '\0';
+    data[length + 1] = '\0';
+    source->data = data;
+    source->length = length;
+    source->mapped = false;
+    return source;
+}
+
+void closeSourceFile(SourceBuffer *source)
+{
+    if (source == NULL)
+        return;
+
+    if (source->mapped)
+        munmap(source->data, source->length + 2);
+    else
+        free(source->data);
+    free(source);
+}
@@ -0,0 +1,33 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A whole source file held in memory for in-place scanning. The text is
+// followed by two NUL bytes, the terminator flex's yy_scan_buffer expects.
+typedef struct SourceBuffer
+{
+    char *data;    // File contents plus the two terminating NULs
+    size_t length; // Length of the file contents
+    bool mapped;   // data is an mmap'd view rather than a heap copy
+} SourceBuffer;
+
+// Map (or, when that is not possible, read in one go) a source file
+// Returns NULL if the file cannot be opened
+SourceBuffer *openSourceFile(const char *path);
+
+// Copy source text held in memory into a buffer the scanner can use
+SourceBuffer *openSourceText(const char *text, size_t length);
+
+// Release a source buffer
+void closeSourceFile(SourceBuffer *source);
+
+// Point the scanner at a source buffer (implemented in lexer.l); the buffer
+// must stay open until endSourceScan
+bool beginSourceScan(SourceBuffer *source);
+
+// Detach the scanner from the current source buffer (implemented in lexer.l)
+void endSourceScan();
+
+#endif // SOURCE_H
@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include "stream.h"
+#include "resolve.h"
+#include "semantic.h"
+#include "optimizer.h"
+#include "codeGenerator.h"
+#include "utils.h"
+
+bool streamingMode = false;
+NodeIndex streamStmtList = NULL_NODE;
+
+static TAC *windowTail = NULL; // Last instruction counted into the window
+static int windowSize = 0;
+static int windowCount = 0;
+
+// Optimize the window, write its code and start an empty one
+static void flushWindow(SymbolTable *symTab, bool lastWindow)
+{
+    optimizeTACWindow(&tacHead, symTab, windowCount == 0, lastWindow);
+    generateInstructions(tacHead, symTab);
+
+    freeTACList(tacHead);
+    tacHead = NULL;
+    windowTail = NULL;
+    windowSize = 0;
+    windowCount++;
+
+    // Temporaries never cross a window, so their numbers can start over
+    initializeTempVars();
+}
+
+void beginStreaming(NodeIndex varDeclList, SymbolTable *symTab)
+{
+    resolveNames(varDeclList, symTab);
+    beginStreamingMIPS();
+}
+
+void streamStatement(NodeIndex stmt, SymbolTable *symTab)
+{
+    resolveNames(stmt, symTab);
+    semanticAnalysis(getNode(stmt), symTab);
+
+    // Everything created since the top-level list belongs to this statement
+    releaseNodesFrom(streamStmtList + 1);
+
+    // Count the instructions the statement appended
+    TAC *instr = windowTail != NULL ? windowTail->next : tacHead;
+    for (; instr != NULL; instr = instr->next)
+    {
+        windowTail = instr;
+        windowSize++;
+    }
+
+    // Windows only end between top-level statements, so no branch crosses one
+    if (windowSize >= STREAM_WINDOW_SIZE)
+    {
+        flushWindow(symTab, false);
+    }
+}
+
+void finishStreaming(SymbolTable *symTab)
+{
+    flushWindow(symTab, true);
+    finishStreamingMIPS(symTab);
+    printf("Streamed %d window(s) of up to %d TAC instructions\n", windowCount, STREAM_WINDOW_SIZE);
+}
@@ -0,0 +1,27 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdbool.h>
+#include "AST.h"
+#include "SymbolTable.h"
+
+// Streaming mode compiles each top-level statement as soon as it is parsed
+// instead of building the whole AST first. Its TAC collects in a window
+// that is optimized, turned into .text and freed once it holds
+// STREAM_WINDOW_SIZE instructions, and .data is written after the last
+// window. Memory stays bounded by the window and the largest statement.
+#define STREAM_WINDOW_SIZE 4096
+
+extern bool streamingMode;       // Set by main before parsing
+extern NodeIndex streamStmtList; // Top-level statement list while streaming
+
+// Declare the program's variables and start the .text section
+void beginStreaming(NodeIndex varDeclList, SymbolTable *symTab);
+
+// Compile one top-level statement and release its AST nodes
+void streamStatement(NodeIndex stmt, SymbolTable *symTab);
+
+// Compile the last window and write the .data section
+void finishStreaming(SymbolTable *symTab);
+
+#endif // STREAM_H
@@ -0,0 +1,833 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "superopt.h"
+#include "simulator.h"
+#include "temp.h"
+
+// Superoptimizer for the MIPS instruction selector. For each window of
+// straight-line TAC over one input variable and integer constants, it
+// enumerates MIPS sequences cheaper than the hand-written lowering,
+// verifies the candidates and writes the cheapest into a rule table.
+//
+// Usage: ./superopt [-o table.c] [-m model] [-c constants] [dump.ir]...
+//
+// The windows are every single operation between a variable and one of
+// the constants (-c takes a comma-separated list), plus the chains of up
+// to SUPEROPT_MAX_WINDOW operations found in the given TAC dumps. A
+// candidate must agree with the window on a set of test values, then on
+// random 32-bit inputs, and then on every input at the 8- and 16-bit
+// widths its constants fit (shift amounts such as 31 are written relative
+// to the width, so one sequence is checked at each). Sequences of up to
+// three instructions are drawn from the whole instruction set; four
+// instruction sequences from shifts, addu and subu only.
+
+#define DEFAULT_OUTPUT "superoptTable.c"
+#define DEFAULT_CONSTANTS "-8,-4,-2,-1,0,1,2,3,4,5,6,7,8,9,10,12,15,16,17,24,31,32,33,63,64,100,127,128,255,256,1000,1024,4096"
+
+#define MAX_WINDOWS 4096
+#define MAX_IMMEDIATES 32
+#define TEST_COUNT 32
+#define RANDOM_CHECKS 20000
+
+// Integer TAC operations and whether their operands commute
+static const struct
+{
+    const char *op;
+    bool commutative;
+} tacOps[] = {
+    {"+", true}, {"-", false}, {"*", true}, {"/", false},
+    {"<", false}, {"<=", false}, {">", false}, {">=", false}, {"==", true}, {"!=", true},
+};
+#define TAC_OP_COUNT (int)(sizeof(tacOps) / sizeof(tacOps[0]))
+
+typedef enum
+{
+    Mips_Addu, Mips_Subu, Mips_Mul, Mips_And, Mips_Or, Mips_Xor, Mips_Nor, Mips_Slt, Mips_Sltu,
+    Mips_Addiu, Mips_Andi, Mips_Ori, Mips_Xori, Mips_Slti, Mips_Sltiu, Mips_Sll, Mips_Srl, Mips_Sra,
+    Mips_Count
+} MipsOp;
+
+static const struct
+{
+    const char *mnemonic;
+    bool immediate;  // Second source is an immediate
+    bool shift;      // The immediate is a shift amount
+    bool logical;    // The immediate is zero-extended
+    bool fourth;     // Allowed in four-instruction sequences
+} mipsOps[Mips_Count] = {
+    {"addu", false, false, false, true}, {"subu", false, false, false, true},
+    {"mul", false, false, false, false}, {"and", false, false, false, false},
+    {"or", false, false, false, false}, {"xor", false, false, false, false},
+    {"nor", false, false, false, false}, {"slt", false, false, false, false},
+    {"sltu", false, false, false, false}, {"addiu", true, false, false, false},
+    {"andi", true, false, true, false}, {"ori", true, false, true, false},
+    {"xori", true, false, true, false}, {"slti", true, false, false, false},
+    {"sltiu", true, false, false, false}, {"sll", true, true, false, true},
+    {"srl", true, true, false, true}, {"sra", true, true, false, true},
+};
+
+// An immediate is either a plain value or the width minus a value
+typedef struct
+{
+    int value;
+    bool relative;
+} Immediate;
+
+typedef struct
+{
+    MipsOp op;
+    SuperoptOperand source1;
+    SuperoptOperand source2;
+    Immediate immediate;
+} Step;
+
+typedef struct
+{
+    int length;
+    SuperoptTACStep steps[SUPEROPT_MAX_WINDOW];
+} Window;
+
+typedef struct
+{
+    Window window;
+    int length;
+    Step steps[SUPEROPT_MAX_SEQUENCE];
+    int cost;
+    int defaultCost;
+} Rule;
+
+static CostModel model;
+static Window windows[MAX_WINDOWS];
+static int windowCount = 0;
+
+static const int64_t testValues[] = {
+    0, 1, -1, 2, -2, 3, -3, 7, 8, -8, 15, 16, 100, -100, 255, 256,
+    12345, -12345, 65535, 65536, INT32_MAX, INT32_MIN, INT32_MAX - 1, INT32_MIN + 1,
+    0x55555555, -0x55555555, 0x7fff, -0x8000, 1000000007, -999999937, 31, 33,
+};
+
+static uint64_t rngState = 0x9e3779b97f4a7c15ULL;
+
+static uint32_t randomWord()
+{
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return (uint32_t)((rngState * 2685821657736338717ULL) >> 32);
+}
+
+// Reduce a value to a signed width-bit integer
+static int64_t wrap(int64_t value, int width)
+{
+    uint64_t mask = (1ULL << width) - 1;
+    uint64_t bits = (uint64_t)value & mask;
+    if (bits >> (width - 1))
+        return (int64_t)bits - (int64_t)(1ULL << width);
+    return (int64_t)bits;
+}
+
+static bool fitsWidth(int64_t value, int width)
+{
+    return value >= -(1LL << (width - 1)) && value < (1LL << (width - 1));
+}
+
+static bool isCommutative(const char *op)
+{
+    for (int i = 0; i < TAC_OP_COUNT; i++)
+    {
+        if (strcmp(tacOps[i].op, op) == 0)
+            return tacOps[i].commutative;
+    }
+    return false;
+}
+
+static const char *internOp(const char *op)
+{
+    for (int i = 0; i < TAC_OP_COUNT; i++)
+    {
+        if (strcmp(tacOps[i].op, op) == 0)
+            return tacOps[i].op;
+    }
+    return NULL;
+}
+
+// ---- Semantics ----
+
+static int64_t evaluateTAC(const char *op, int64_t a, int64_t b, int width)
+{
+    switch (op[0])
+    {
+    case '+':
+        return wrap(a + b, width);
+    case '-':
+        return wrap(a - b, width);
+    case '*':
+        return wrap((int64_t)((uint64_t)a * (uint64_t)b), width);
+    case '/':
+        return wrap(a / b, width);
+    case '<':
+        return op[1] == '=' ? a <= b : a < b;
+    case '>':
+        return op[1] == '=' ? a >= b : a > b;
+    case '=':
+        return a == b;
+    default:
+        return a != b;
+    }
+}
+
+static int64_t evaluateWindow(const Window *window, int64_t input, int width)
+{
+    int64_t value = input;
+    for (int i = 0; i < window->length; i++)
+    {
+        const SuperoptTACStep *step = &window->steps[i];
+        int64_t constant = wrap(step->constant, width);
+        value = step->constantFirst ? evaluateTAC(step->op, constant, value, width)
+                                    : evaluateTAC(step->op, value, constant, width);
+    }
+    return value;
+}
+
+static int64_t immediateValue(Immediate immediate, int width)
+{
+    return immediate.relative ? width - immediate.value : immediate.value;
+}
+
+static int64_t evaluateStep(const Step *step, int64_t input, int64_t previous, int width)
+{
+    int64_t sources[2];
+    SuperoptOperand kinds[2] = {step->source1, step->source2};
+    for (int i = 0; i < 2; i++)
+    {
+        switch (kinds[i])
+        {
+        case SuperoptOperand_Input:
+            sources[i] = input;
+            break;
+        case SuperoptOperand_Previous:
+            sources[i] = previous;
+            break;
+        case SuperoptOperand_Immediate:
+            sources[i] = wrap(immediateValue(step->immediate, width), width);
+            break;
+        default:
+            sources[i] = 0;
+            break;
+        }
+    }
+    int64_t a = sources[0], b = sources[1];
+    uint64_t mask = (1ULL << width) - 1;
+    switch (step->op)
+    {
+    case Mips_Addu:
+    case Mips_Addiu:
+        return wrap(a + b, width);
+    case Mips_Subu:
+        return wrap(a - b, width);
+    case Mips_Mul:
+        return wrap((int64_t)((uint64_t)a * (uint64_t)b), width);
+    case Mips_And:
+    case Mips_Andi:
+        return a & b;
+    case Mips_Or:
+    case Mips_Ori:
+        return a | b;
+    case Mips_Xor:
+    case Mips_Xori:
+        return a ^ b;
+    case Mips_Nor:
+        return wrap(~(a | b), width);
+    case Mips_Slt:
+    case Mips_Slti:
+        return a < b;
+    case Mips_Sltu:
+    case Mips_Sltiu:
+        return ((uint64_t)a & mask) < ((uint64_t)b & mask);
+    case Mips_Sll:
+        return wrap((int64_t)((uint64_t)a << b), width);
+    case Mips_Srl:
+        return wrap((int64_t)(((uint64_t)a & mask) >> b), width);
+    default:
+        return a >> b;
+    }
+}
+
+static int64_t evaluateSequence(const Step *steps, int length, int64_t input, int width)
+{
+    int64_t value = 0;
+    for (int i = 0; i < length; i++)
+        value = evaluateStep(&steps[i], input, value, width);
+    return value;
+}
+
+// ---- Costs ----
+
+static int latencyOf(MipsOp op)
+{
+    return op == Mips_Mul ? model.mulLatency : model.aluLatency;
+}
+
+// Cycles of the hand-written lowering: li for the constant, then the
+// operation (div plus mflo for division); the chain is serial
+static int defaultCost(const Window *window)
+{
+    int cost = 0;
+    for (int i = 0; i < window->length; i++)
+    {
+        const char *op = window->steps[i].op;
+        cost += model.aluLatency;
+        if (strcmp(op, "*") == 0)
+            cost += model.mulLatency;
+        else if (strcmp(op, "/") == 0)
+            cost += model.divLatency + model.aluLatency;
+        else
+            cost += model.aluLatency;
+    }
+    return cost;
+}
+
+// ---- Verification ----
+
+// Whether a sequence can be evaluated at a width: its immediates and the
+// window's constants must be representable there
+static bool representable(const Window *window, const Step *steps, int length, int width)
+{
+    for (int i = 0; i < window->length; i++)
+    {
+        if (!fitsWidth(window->steps[i].constant, width))
+            return false;
+    }
+    for (int i = 0; i < length; i++)
+    {
+        if (steps[i].source2 != SuperoptOperand_Immediate)
+            continue;
+        int64_t value = immediateValue(steps[i].immediate, width);
+        if (mipsOps[steps[i].op].shift ? value <= 0 || value >= width : !fitsWidth(value, width))
+            return false;
+    }
+    return true;
+}
+
+static bool verify(const Window *window, const Step *steps, int length)
+{
+    for (int i = 0; i < RANDOM_CHECKS; i++)
+    {
+        int64_t x = (int32_t)randomWord();
+        if (evaluateSequence(steps, length, x, 32) != evaluateWindow(window, x, 32))
+            return false;
+    }
+
+    // Exhaustive checks at reduced widths
+    static const int widths[] = {8, 16};
+    int checked = 0;
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++)
+    {
+        int width = widths[w];
+        if (!representable(window, steps, length, width))
+            continue;
+        for (int64_t x = -(1LL << (width - 1)); x < (1LL << (width - 1)); x++)
+        {
+            if (evaluateSequence(steps, length, x, width) != evaluateWindow(window, x, width))
+                return false;
+        }
+        checked++;
+    }
+    return checked > 0;
+}
+
+// ---- Search ----
+
+typedef struct
+{
+    const Window *window;
+    int64_t targets[TEST_COUNT];
+    Immediate immediates[MAX_IMMEDIATES];
+    int immediateCount;
+    Step steps[SUPEROPT_MAX_SEQUENCE];
+    int64_t values[SUPEROPT_MAX_SEQUENCE + 1][TEST_COUNT]; // Results after each step
+    int maxLength;
+    Step best[SUPEROPT_MAX_SEQUENCE];
+    int bestLength;
+    int bestCost; // Only cheaper sequences are of interest
+} Search;
+
+static void addImmediate(Search *search, int value, bool relative)
+{
+    if (search->immediateCount == MAX_IMMEDIATES || (!relative && !fitsWidth(value, 16)))
+        return;
+    for (int i = 0; i < search->immediateCount; i++)
+    {
+        if (search->immediates[i].value == value && search->immediates[i].relative == relative)
+            return;
+    }
+    search->immediates[search->immediateCount].value = value;
+    search->immediates[search->immediateCount].relative = relative;
+    search->immediateCount++;
+}
+
+// Immediates worth trying for a window: its constants and their
+// neighbours, and the shift amounts of powers of two
+static void chooseImmediates(Search *search)
+{
+    search->immediateCount = 0;
+    addImmediate(search, 1, false);
+    addImmediate(search, -1, false);
+    addImmediate(search, 1, true); // width - 1
+    for (int i = 0; i < search->window->length; i++)
+    {
+        int c = search->window->steps[i].constant;
+        addImmediate(search, c, false);
+        addImmediate(search, c + 1, false);
+        addImmediate(search, c - 1, false);
+        addImmediate(search, -c, false);
+        long magnitude = c < 0 ? -(long)c : c;
+        for (int k = 1; k < 31; k++)
+        {
+            // Powers of two and their neighbours, for shift-and-add
+            if (magnitude == 1L << k || magnitude == (1L << k) + 1 || magnitude == (1L << k) - 1)
+            {
+                addImmediate(search, k, false);
+                addImmediate(search, k, true);
+            }
+        }
+    }
+}
+
+static bool immediateAllowed(MipsOp op, Immediate immediate)
+{
+    if (mipsOps[op].shift)
+        return immediate.relative ? immediate.value >= 1 : immediate.value >= 1 && immediate.value <= 31;
+    if (immediate.relative)
+        return false;
+    if (mipsOps[op].logical)
+        return immediate.value >= 0;
+    return immediate.value != 0 || op == Mips_Slti || op == Mips_Sltiu;
+}
+
+static void searchFrom(Search *search, int depth, int cost);
+
+// Try one step at depth, then go deeper or check the whole sequence
+static void tryStep(Search *search, int depth, int cost, const Step *step)
+{
+    int stepCost = cost + latencyOf(step->op);
+    if (stepCost >= search->bestCost)
+        return;
+    search->steps[depth] = *step;
+    bool changed = depth == 0;
+    for (int t = 0; t < TEST_COUNT; t++)
+    {
+        int64_t value = evaluateStep(step, testValues[t], search->values[depth][t], 32);
+        search->values[depth + 1][t] = value;
+        if (value != search->values[depth][t])
+            changed = true;
+    }
+    // A step that leaves every value unchanged is useless
+    if (!changed)
+        return;
+
+    if (memcmp(search->values[depth + 1], search->targets, sizeof(search->targets)) == 0 &&
+        verify(search->window, search->steps, depth + 1))
+    {
+        memcpy(search->best, search->steps, sizeof(Step) * (depth + 1));
+        search->bestLength = depth + 1;
+        search->bestCost = stepCost;
+        return;
+    }
+    searchFrom(search, depth + 1, stepCost);
+}
+
+static void searchFrom(Search *search, int depth, int cost)
+{
+    if (depth == search->maxLength)
+        return;
+    // Every instruction but the first must read the previous result
+    SuperoptOperand self = depth == 0 ? SuperoptOperand_Input : SuperoptOperand_Previous;
+    bool restricted = search->maxLength == 4;
+    for (int op = 0; op < Mips_Count; op++)
+    {
+        if (restricted && !mipsOps[op].fourth)
+            continue;
+        Step step;
+        step.op = (MipsOp)op;
+        step.immediate.value = 0;
+        step.immediate.relative = false;
+        if (mipsOps[op].immediate)
+        {
+            step.source1 = self;
+            step.source2 = SuperoptOperand_Immediate;
+            for (int i = 0; i < search->immediateCount; i++)
+            {
+                step.immediate = search->immediates[i];
+                if (immediateAllowed(step.op, step.immediate))
+                    tryStep(search, depth, cost, &step);
+            }
+            continue;
+        }
+
+        static const SuperoptOperand pairs[][2] = {
+            {SuperoptOperand_Previous, SuperoptOperand_Input}, {SuperoptOperand_Input, SuperoptOperand_Previous},
+            {SuperoptOperand_Previous, SuperoptOperand_Previous}, {SuperoptOperand_Previous, SuperoptOperand_Zero},
+            {SuperoptOperand_Zero, SuperoptOperand_Previous}, {SuperoptOperand_Input, SuperoptOperand_Input},
+            {SuperoptOperand_Input, SuperoptOperand_Zero}, {SuperoptOperand_Zero, SuperoptOperand_Input},
+        };
+        for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); p++)
+        {
+            bool readsSelf = pairs[p][0] == self || pairs[p][1] == self;
+            bool readsPrevious = pairs[p][0] == SuperoptOperand_Previous || pairs[p][1] == SuperoptOperand_Previous;
+            if (!readsSelf || (depth == 0 && readsPrevious))
+                continue;
+            if (restricted && (pairs[p][0] == SuperoptOperand_Zero || pairs[p][1] == SuperoptOperand_Zero))
+                continue;
+            step.source1 = pairs[p][0];
+            step.source2 = pairs[p][1];
+            tryStep(search, depth, cost, &step);
+        }
+    }
+}
+
+// Find the cheapest verified sequence for a window; false if none beats
+// the default lowering
+static bool superoptimize(const Window *window, Rule *rule)
+{
+    Search search;
+    search.window = window;
+    for (int t = 0; t < TEST_COUNT; t++)
+    {
+        search.targets[t] = evaluateWindow(window, testValues[t], 32);
+        search.values[0][t] = 0;
+    }
+    chooseImmediates(&search);
+    rule->defaultCost = defaultCost(window);
+    search.bestCost = rule->defaultCost;
+    search.bestLength = 0;
+
+    // Shorter sequences first, so the longer searches prune against them
+    for (int length = 1; length <= SUPEROPT_MAX_SEQUENCE; length++)
+    {
+        if (length * model.aluLatency >= search.bestCost)
+            break;
+        search.maxLength = length;
+        searchFrom(&search, 0, 0);
+    }
+    if (search.bestLength == 0)
+        return false;
+
+    rule->window = *window;
+    rule->length = search.bestLength;
+    memcpy(rule->steps, search.best, sizeof(Step) * search.bestLength);
+    rule->cost = search.bestCost;
+    return true;
+}
+
+// ---- Windows ----
+
+static void addWindow(const Window *window)
+{
+    if (windowCount == MAX_WINDOWS)
+        return;
+    for (int i = 0; i < window->length; i++)
+    {
+        // Division by zero or -1 is left to the hardware
+        const SuperoptTACStep *step = &window->steps[i];
+        if (strcmp(step->op, "/") == 0 && (step->constantFirst || step->constant == 0 || step->constant == -1))
+            return;
+    }
+    for (int w = 0; w < windowCount; w++)
+    {
+        if (windows[w].length != window->length)
+            continue;
+        bool same = true;
+        for (int i = 0; i < window->length && same; i++)
+        {
+            same = windows[w].steps[i].op == window->steps[i].op &&
+                   windows[w].steps[i].constant == window->steps[i].constant &&
+                   windows[w].steps[i].constantFirst == window->steps[i].constantFirst;
+        }
+        if (same)
+            return;
+    }
+    windows[windowCount++] = *window;
+}
+
+static bool addConstantWindows(const char *list)
+{
+    char *copy = strdup(list);
+    bool ok = true;
+    for (char *item = strtok(copy, ","); item != NULL; item = strtok(NULL, ","))
+    {
+        char *end;
+        long constant = strtol(item, &end, 10);
+        if (*end != '\0' || !fitsWidth(constant, 32))
+        {
+            fprintf(stderr, "Error: Bad constant '%s'\n", item);
+            ok = false;
+            break;
+        }
+        for (int op = 0; op < TAC_OP_COUNT; op++)
+        {
+            Window window;
+            window.length = 1;
+            window.steps[0].op = tacOps[op].op;
+            window.steps[0].constant = (int)constant;
+            window.steps[0].constantFirst = false;
+            addWindow(&window);
+            if (!tacOps[op].commutative)
+            {
+                window.steps[0].constantFirst = true;
+                addWindow(&window);
+            }
+        }
+    }
+    free(copy);
+    return ok;
+}
+
+typedef struct
+{
+    char result[64];
+    char arg1[64];
+    char arg2[64];
+    const char *op;
+} DumpLine;
+
+static bool isIntegerText(const char *text, int *value)
+{
+    char *end;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || !fitsWidth(parsed, 32))
+        return false;
+    *value = (int)parsed;
+    return true;
+}
+
+static bool isTempText(const char *text)
+{
+    return strncmp(text, TEMP_PREFIX, strlen(TEMP_PREFIX)) == 0;
+}
+
+// One step of a window from a dump line whose source is given; false if
+// the line does not have that shape
+static bool windowStep(const DumpLine *line, const char *source, SuperoptTACStep *step)
+{
+    int constant;
+    if (line->op == NULL)
+        return false;
+    step->op = line->op;
+    if (isIntegerText(line->arg2, &constant) && (source == NULL ? !isIntegerText(line->arg1, &constant)
+                                                                  : strcmp(line->arg1, source) == 0))
+    {
+        isIntegerText(line->arg2, &step->constant);
+        step->constantFirst = false;
+        return true;
+    }
+    if (isIntegerText(line->arg1, &constant) && (source == NULL ? !isIntegerText(line->arg2, &constant)
+                                                                  : strcmp(line->arg2, source) == 0))
+    {
+        isIntegerText(line->arg1, &step->constant);
+        // Commutative operations are kept with the constant second
+        step->constantFirst = !isCommutative(line->op);
+        return true;
+    }
+    return false;
+}
+
+// Collect the chains of operations in a TAC dump
+static bool mineDump(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    DumpLine *lines = NULL;
+    int count = 0, capacity = 0;
+    char text[512];
+    while (fgets(text, sizeof(text), file) != NULL)
+    {
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            lines = (DumpLine *)realloc(lines, sizeof(DumpLine) * capacity);
+        }
+        DumpLine *line = &lines[count++];
+        char eq[8], op[16];
+        line->op = NULL;
+        if (sscanf(text, "%63s %7s %63s %15s %63s", line->result, eq, line->arg1, op, line->arg2) == 5 &&
+            strcmp(eq, "=") == 0)
+            line->op = internOp(op);
+    }
+    fclose(file);
+
+    for (int i = 0; i < count; i++)
+    {
+        Window window;
+        window.length = 0;
+        const char *source = NULL;
+        for (int j = i; j < count && window.length < SUPEROPT_MAX_WINDOW; j++)
+        {
+            if (!windowStep(&lines[j], source, &window.steps[window.length]))
+                break;
+            window.length++;
+            addWindow(&window);
+
+            // The chain continues only through a temporary read once, by the next line
+            source = lines[j].result;
+            if (!isTempText(source))
+                break;
+            int uses = 0;
+            for (int k = j + 1; k < count && uses < 2; k++)
+                uses += (strcmp(lines[k].arg1, source) == 0) + (strcmp(lines[k].arg2, source) == 0);
+            if (uses != 1)
+                break;
+        }
+    }
+    free(lines);
+    return true;
+}
+
+// ---- Output ----
+
+static const char *operandName(SuperoptOperand operand)
+{
+    switch (operand)
+    {
+    case SuperoptOperand_Input:
+        return "SuperoptOperand_Input";
+    case SuperoptOperand_Previous:
+        return "SuperoptOperand_Previous";
+    case SuperoptOperand_Zero:
+        return "SuperoptOperand_Zero";
+    case SuperoptOperand_Immediate:
+        return "SuperoptOperand_Immediate";
+    default:
+        return "SuperoptOperand_None";
+    }
+}
+
+static void describeWindow(FILE *out, const Window *window)
+{
+    const char *source = "x";
+    for (int i = 0; i < window->length; i++)
+    {
+        const SuperoptTACStep *step = &window->steps[i];
+        fprintf(out, "%st%d = ", i > 0 ? "; " : "", i + 1);
+        if (step->constantFirst)
+            fprintf(out, "%d %s %s", step->constant, step->op, source);
+        else
+            fprintf(out, "%s %s %d", source, step->op, step->constant);
+        source = i == 0 ? "t1" : i == 1 ? "t2" : "t3";
+    }
+}
+
+static int compareRules(const void *a, const void *b)
+{
+    const Rule *ra = (const Rule *)a, *rb = (const Rule *)b;
+    if (ra->window.length != rb->window.length)
+        return rb->window.length - ra->window.length;
+    return (rb->defaultCost - rb->cost) - (ra->defaultCost - ra->cost);
+}
+
+static bool writeTable(const char *path, Rule *rules, int ruleCount)
+{
+    FILE *out = fopen(path, "w");
+    if (out == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    qsort(rules, ruleCount, sizeof(Rule), compareRules);
+
+    fprintf(out, "// %s\n", path);
+    fprintf(out, "// Generated by superopt from %d TAC windows; regenerate with make superopt-table.\n\n", windowCount);
+    fprintf(out, "#include \"superopt.h\"\n\n");
+    fprintf(out, "const SuperoptRule superoptRules[] = {\n");
+    for (int r = 0; r < ruleCount; r++)
+    {
+        const Rule *rule = &rules[r];
+        fprintf(out, "    // ");
+        describeWindow(out, &rule->window);
+        fprintf(out, ": %d cycles, was %d\n", rule->cost, rule->defaultCost);
+        fprintf(out, "    {%d, {", rule->window.length);
+        for (int i = 0; i < rule->window.length; i++)
+        {
+            const SuperoptTACStep *step = &rule->window.steps[i];
+            fprintf(out, "%s{\"%s\", %d, %s}", i > 0 ? ", " : "", step->op, step->constant,
+                    step->constantFirst ? "true" : "false");
+        }
+        fprintf(out, "},\n     %d, {", rule->length);
+        for (int i = 0; i < rule->length; i++)
+        {
+            const Step *step = &rule->steps[i];
+            fprintf(out, "%s{\"%s\", %s, %s, %d}", i > 0 ? ",\n          " : "", mipsOps[step->op].mnemonic,
+                    operandName(step->source1), operandName(step->source2),
+                    step->source2 == SuperoptOperand_Immediate ? (int)immediateValue(step->immediate, 32) : 0);
+        }
+        fprintf(out, "},\n     %d, %d},\n", rule->cost, rule->defaultCost);
+    }
+    fprintf(out, "    {0},\n};\n\n");
+    fprintf(out, "// The last entry only keeps the array from being empty\n");
+    fprintf(out, "const int superoptRuleCount = sizeof(superoptRules) / sizeof(superoptRules[0]) - 1;\n");
+    return fclose(out) == 0;
+}
+
+static void usage()
+{
+    fprintf(stderr, "Usage: ./superopt [-o table.c] [-m model] [-c constants] [dump.ir]...\n");
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    const char *outputPath = DEFAULT_OUTPUT;
+    const char *constants = DEFAULT_CONSTANTS;
+    defaultCostModel(&model);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            constants = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            if (!loadCostModel(&model, argv[++i]))
+                return 1;
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage();
+        }
+        else if (!mineDump(argv[i]))
+        {
+            return 1;
+        }
+    }
+    if (!addConstantWindows(constants))
+        return 1;
+
+    Rule *rules = (Rule *)malloc(sizeof(Rule) * (windowCount + 1));
+    int ruleCount = 0;
+    for (int w = 0; w < windowCount; w++)
+    {
+        if (superoptimize(&windows[w], &rules[ruleCount]))
+        {
+            fprintf(stderr, "  ");
+            describeWindow(stderr, &windows[w]);
+            fprintf(stderr, ": %d -> %d cycles\n", rules[ruleCount].defaultCost, rules[ruleCount].cost);
+            ruleCount++;
+        }
+    }
+    fprintf(stderr, "%d of %d windows have a cheaper sequence\n", ruleCount, windowCount);
+
+    bool ok = writeTable(outputPath, rules, ruleCount);
+    free(rules);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// superopt.h
+
+#ifndef SUPEROPT_H
+#define SUPEROPT_H
+
+#include <stdbool.h>
+
+// Rules found by the superoptimizer (superopt.c) and consulted by the MIPS
+// instruction selector. A rule replaces a window of straight-line TAC over
+// one input variable and integer constants with a cheaper MIPS sequence.
+// The table itself is generated into superoptTable.c.
+#define SUPEROPT_MAX_WINDOW 4
+#define SUPEROPT_MAX_SEQUENCE 4
+
+// One TAC instruction of a window: result = source op constant, or
+// result = constant op source. The first instruction's source is the
+// window's input and each later one reads the previous result, which must
+// be a temporary used nowhere else.
+typedef struct
+{
+    const char *op;
+    int constant;
+    bool constantFirst;
+} SuperoptTACStep;
+
+typedef enum
+{
+    SuperoptOperand_None,
+    SuperoptOperand_Input,     // Register holding the window's input
+    SuperoptOperand_Previous,  // Result of the previous instruction
+    SuperoptOperand_Zero,      // $zero
+    SuperoptOperand_Immediate
+} SuperoptOperand;
+
+// One MIPS instruction of a replacement; every instruction writes the
+// window's result register
+typedef struct
+{
+    const char *mnemonic;
+    SuperoptOperand source1;
+    SuperoptOperand source2;
+    int immediate;
+} SuperoptMipsStep;
+
+typedef struct
+{
+    int windowLength;
+    SuperoptTACStep window[SUPEROPT_MAX_WINDOW];
+    int sequenceLength;
+    SuperoptMipsStep sequence[SUPEROPT_MAX_SEQUENCE];
+    int cost;        // Cycles of the sequence under the default cost model
+    int defaultCost; // Cycles of the hand-written lowering it replaces
+} SuperoptRule;
+
+// Longest windows first, so the instruction selector takes the first match
+extern const SuperoptRule superoptRules[];
+extern const int superoptRuleCount;
+
+#endif // SUPEROPT_H
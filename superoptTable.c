@@ -0,0 +1,1054 @@
+// superoptTable.c
+// Generated by superopt from 493 TAC windows; regenerate with make superopt-table.
+
+#include "superopt.h"
+
+const SuperoptRule superoptRules[] = {
+    // t1 = x / 1: 1 cycles, was 22
+    {1, {{"/", 1, false}},
+     1, {{"addu", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 22},
+    // t1 = x / 2: 3 cycles, was 22
+    {1, {{"/", 2, false}},
+     3, {{"slt", SuperoptOperand_Input, SuperoptOperand_Zero, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 1}},
+     3, 22},
+    // t1 = x / 4: 4 cycles, was 22
+    {1, {{"/", 4, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 1},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 30},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 2}},
+     4, 22},
+    // t1 = x / 8: 4 cycles, was 22
+    {1, {{"/", 8, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 29},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 3}},
+     4, 22},
+    // t1 = x / 16: 4 cycles, was 22
+    {1, {{"/", 16, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 28},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 4}},
+     4, 22},
+    // t1 = x / 32: 4 cycles, was 22
+    {1, {{"/", 32, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 27},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 5}},
+     4, 22},
+    // t1 = x / 64: 4 cycles, was 22
+    {1, {{"/", 64, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 26},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 6}},
+     4, 22},
+    // t1 = x / 128: 4 cycles, was 22
+    {1, {{"/", 128, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 25},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 7}},
+     4, 22},
+    // t1 = x / 256: 4 cycles, was 22
+    {1, {{"/", 256, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 24},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 8}},
+     4, 22},
+    // t1 = x / 1024: 4 cycles, was 22
+    {1, {{"/", 1024, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 22},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 10}},
+     4, 22},
+    // t1 = x / 4096: 4 cycles, was 22
+    {1, {{"/", 4096, false}},
+     4, {{"sra", SuperoptOperand_Input, SuperoptOperand_Immediate, 31},
+          {"srl", SuperoptOperand_Previous, SuperoptOperand_Immediate, 20},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"sra", SuperoptOperand_Previous, SuperoptOperand_Immediate, 12}},
+     4, 22},
+    // t1 = x * -1: 1 cycles, was 6
+    {1, {{"*", -1, false}},
+     1, {{"subu", SuperoptOperand_Zero, SuperoptOperand_Input, 0}},
+     1, 6},
+    // t1 = x * 0: 1 cycles, was 6
+    {1, {{"*", 0, false}},
+     1, {{"subu", SuperoptOperand_Input, SuperoptOperand_Input, 0}},
+     1, 6},
+    // t1 = x * 1: 1 cycles, was 6
+    {1, {{"*", 1, false}},
+     1, {{"addu", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 6},
+    // t1 = x * 2: 1 cycles, was 6
+    {1, {{"*", 2, false}},
+     1, {{"addu", SuperoptOperand_Input, SuperoptOperand_Input, 0}},
+     1, 6},
+    // t1 = x * 4: 1 cycles, was 6
+    {1, {{"*", 4, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 2}},
+     1, 6},
+    // t1 = x * 8: 1 cycles, was 6
+    {1, {{"*", 8, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 3}},
+     1, 6},
+    // t1 = x * 16: 1 cycles, was 6
+    {1, {{"*", 16, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 4}},
+     1, 6},
+    // t1 = x * 32: 1 cycles, was 6
+    {1, {{"*", 32, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 5}},
+     1, 6},
+    // t1 = x * 64: 1 cycles, was 6
+    {1, {{"*", 64, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 6}},
+     1, 6},
+    // t1 = x * 128: 1 cycles, was 6
+    {1, {{"*", 128, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 7}},
+     1, 6},
+    // t1 = x * 256: 1 cycles, was 6
+    {1, {{"*", 256, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 8}},
+     1, 6},
+    // t1 = x * 1024: 1 cycles, was 6
+    {1, {{"*", 1024, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 10}},
+     1, 6},
+    // t1 = x * 4096: 1 cycles, was 6
+    {1, {{"*", 4096, false}},
+     1, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 12}},
+     1, 6},
+    // t1 = x * -8: 2 cycles, was 6
+    {1, {{"*", -8, false}},
+     2, {{"subu", SuperoptOperand_Zero, SuperoptOperand_Input, 0},
+          {"sll", SuperoptOperand_Previous, SuperoptOperand_Immediate, 3}},
+     2, 6},
+    // t1 = x * -4: 2 cycles, was 6
+    {1, {{"*", -4, false}},
+     2, {{"subu", SuperoptOperand_Zero, SuperoptOperand_Input, 0},
+          {"sll", SuperoptOperand_Previous, SuperoptOperand_Immediate, 2}},
+     2, 6},
+    // t1 = x * -2: 2 cycles, was 6
+    {1, {{"*", -2, false}},
+     2, {{"addu", SuperoptOperand_Input, SuperoptOperand_Input, 0},
+          {"subu", SuperoptOperand_Zero, SuperoptOperand_Previous, 0}},
+     2, 6},
+    // t1 = x * 3: 2 cycles, was 6
+    {1, {{"*", 3, false}},
+     2, {{"addu", SuperoptOperand_Input, SuperoptOperand_Input, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 5: 2 cycles, was 6
+    {1, {{"*", 5, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 2},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 7: 2 cycles, was 6
+    {1, {{"*", 7, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 3},
+          {"subu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 9: 2 cycles, was 6
+    {1, {{"*", 9, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 3},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 15: 2 cycles, was 6
+    {1, {{"*", 15, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 4},
+          {"subu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 17: 2 cycles, was 6
+    {1, {{"*", 17, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 4},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 31: 2 cycles, was 6
+    {1, {{"*", 31, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 5},
+          {"subu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 33: 2 cycles, was 6
+    {1, {{"*", 33, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 5},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 63: 2 cycles, was 6
+    {1, {{"*", 63, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 6},
+          {"subu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 127: 2 cycles, was 6
+    {1, {{"*", 127, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 7},
+          {"subu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 255: 2 cycles, was 6
+    {1, {{"*", 255, false}},
+     2, {{"sll", SuperoptOperand_Input, SuperoptOperand_Immediate, 8},
+          {"subu", SuperoptOperand_Previous, SuperoptOperand_Input, 0}},
+     2, 6},
+    // t1 = x * 6: 3 cycles, was 6
+    {1, {{"*", 6, false}},
+     3, {{"addu", SuperoptOperand_Input, SuperoptOperand_Input, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Previous, 0}},
+     3, 6},
+    // t1 = x * 10: 4 cycles, was 6
+    {1, {{"*", 10, false}},
+     4, {{"addu", SuperoptOperand_Input, SuperoptOperand_Input, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Previous, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Previous, 0}},
+     4, 6},
+    // t1 = x * 12: 4 cycles, was 6
+    {1, {{"*", 12, false}},
+     4, {{"addu", SuperoptOperand_Input, SuperoptOperand_Input, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Input, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Previous, 0},
+          {"addu", SuperoptOperand_Previous, SuperoptOperand_Previous, 0}},
+     4, 6},
+    // t1 = x < 12: 1 cycles, was 2
+    {1, {{"<", 12, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 12}},
+     1, 2},
+    // t1 = x + 1: 1 cycles, was 2
+    {1, {{"+", 1, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 1}},
+     1, 2},
+    // t1 = x + -8: 1 cycles, was 2
+    {1, {{"+", -8, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -8}},
+     1, 2},
+    // t1 = x - -8: 1 cycles, was 2
+    {1, {{"-", -8, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 8}},
+     1, 2},
+    // t1 = x < -8: 1 cycles, was 2
+    {1, {{"<", -8, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -8}},
+     1, 2},
+    // t1 = x <= -8: 1 cycles, was 2
+    {1, {{"<=", -8, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -7}},
+     1, 2},
+    // t1 = -8 > x: 1 cycles, was 2
+    {1, {{">", -8, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -8}},
+     1, 2},
+    // t1 = -8 >= x: 1 cycles, was 2
+    {1, {{">=", -8, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -7}},
+     1, 2},
+    // t1 = x + -4: 1 cycles, was 2
+    {1, {{"+", -4, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -4}},
+     1, 2},
+    // t1 = x - -4: 1 cycles, was 2
+    {1, {{"-", -4, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 4}},
+     1, 2},
+    // t1 = x < -4: 1 cycles, was 2
+    {1, {{"<", -4, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -4}},
+     1, 2},
+    // t1 = x <= -4: 1 cycles, was 2
+    {1, {{"<=", -4, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -3}},
+     1, 2},
+    // t1 = -4 > x: 1 cycles, was 2
+    {1, {{">", -4, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -4}},
+     1, 2},
+    // t1 = -4 >= x: 1 cycles, was 2
+    {1, {{">=", -4, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -3}},
+     1, 2},
+    // t1 = x + -2: 1 cycles, was 2
+    {1, {{"+", -2, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -2}},
+     1, 2},
+    // t1 = x - -2: 1 cycles, was 2
+    {1, {{"-", -2, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 2}},
+     1, 2},
+    // t1 = x < -2: 1 cycles, was 2
+    {1, {{"<", -2, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -2}},
+     1, 2},
+    // t1 = x <= -2: 1 cycles, was 2
+    {1, {{"<=", -2, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -1}},
+     1, 2},
+    // t1 = -2 > x: 1 cycles, was 2
+    {1, {{">", -2, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -2}},
+     1, 2},
+    // t1 = -2 >= x: 1 cycles, was 2
+    {1, {{">=", -2, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -1}},
+     1, 2},
+    // t1 = x + -1: 1 cycles, was 2
+    {1, {{"+", -1, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -1}},
+     1, 2},
+    // t1 = x - -1: 1 cycles, was 2
+    {1, {{"-", -1, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 1}},
+     1, 2},
+    // t1 = -1 - x: 1 cycles, was 2
+    {1, {{"-", -1, true}},
+     1, {{"nor", SuperoptOperand_Input, SuperoptOperand_Input, 0}},
+     1, 2},
+    // t1 = x < -1: 1 cycles, was 2
+    {1, {{"<", -1, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -1}},
+     1, 2},
+    // t1 = x <= -1: 1 cycles, was 2
+    {1, {{"<=", -1, false}},
+     1, {{"slt", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 2},
+    // t1 = -1 > x: 1 cycles, was 2
+    {1, {{">", -1, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, -1}},
+     1, 2},
+    // t1 = -1 >= x: 1 cycles, was 2
+    {1, {{">=", -1, true}},
+     1, {{"slt", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 2},
+    // t1 = x != -1: 1 cycles, was 2
+    {1, {{"!=", -1, false}},
+     1, {{"sltiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -1}},
+     1, 2},
+    // t1 = x + 0: 1 cycles, was 2
+    {1, {{"+", 0, false}},
+     1, {{"addu", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 2},
+    // t1 = x - 0: 1 cycles, was 2
+    {1, {{"-", 0, false}},
+     1, {{"addu", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 2},
+    // t1 = 0 - x: 1 cycles, was 2
+    {1, {{"-", 0, true}},
+     1, {{"subu", SuperoptOperand_Zero, SuperoptOperand_Input, 0}},
+     1, 2},
+    // t1 = x < 0: 1 cycles, was 2
+    {1, {{"<", 0, false}},
+     1, {{"slt", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 2},
+    // t1 = 0 < x: 1 cycles, was 2
+    {1, {{"<", 0, true}},
+     1, {{"slt", SuperoptOperand_Zero, SuperoptOperand_Input, 0}},
+     1, 2},
+    // t1 = x <= 0: 1 cycles, was 2
+    {1, {{"<=", 0, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1}},
+     1, 2},
+    // t1 = x > 0: 1 cycles, was 2
+    {1, {{">", 0, false}},
+     1, {{"slt", SuperoptOperand_Zero, SuperoptOperand_Input, 0}},
+     1, 2},
+    // t1 = 0 > x: 1 cycles, was 2
+    {1, {{">", 0, true}},
+     1, {{"slt", SuperoptOperand_Input, SuperoptOperand_Zero, 0}},
+     1, 2},
+    // t1 = 0 >= x: 1 cycles, was 2
+    {1, {{">=", 0, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1}},
+     1, 2},
+    // t1 = x == 0: 1 cycles, was 2
+    {1, {{"==", 0, false}},
+     1, {{"sltiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 1}},
+     1, 2},
+    // t1 = x != 0: 1 cycles, was 2
+    {1, {{"!=", 0, false}},
+     1, {{"sltu", SuperoptOperand_Zero, SuperoptOperand_Input, 0}},
+     1, 2},
+    // t1 = x - 1: 1 cycles, was 2
+    {1, {{"-", 1, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -1}},
+     1, 2},
+    // t1 = x < 1: 1 cycles, was 2
+    {1, {{"<", 1, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1}},
+     1, 2},
+    // t1 = x <= 1: 1 cycles, was 2
+    {1, {{"<=", 1, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 2}},
+     1, 2},
+    // t1 = 1 <= x: 1 cycles, was 2
+    {1, {{"<=", 1, true}},
+     1, {{"slt", SuperoptOperand_Zero, SuperoptOperand_Input, 0}},
+     1, 2},
+    // t1 = 1 > x: 1 cycles, was 2
+    {1, {{">", 1, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1}},
+     1, 2},
+    // t1 = x >= 1: 1 cycles, was 2
+    {1, {{">=", 1, false}},
+     1, {{"slt", SuperoptOperand_Zero, SuperoptOperand_Input, 0}},
+     1, 2},
+    // t1 = 1 >= x: 1 cycles, was 2
+    {1, {{">=", 1, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 2}},
+     1, 2},
+    // t1 = x + 2: 1 cycles, was 2
+    {1, {{"+", 2, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 2}},
+     1, 2},
+    // t1 = x - 2: 1 cycles, was 2
+    {1, {{"-", 2, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -2}},
+     1, 2},
+    // t1 = x < 2: 1 cycles, was 2
+    {1, {{"<", 2, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 2}},
+     1, 2},
+    // t1 = x <= 2: 1 cycles, was 2
+    {1, {{"<=", 2, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 3}},
+     1, 2},
+    // t1 = 2 > x: 1 cycles, was 2
+    {1, {{">", 2, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 2}},
+     1, 2},
+    // t1 = 2 >= x: 1 cycles, was 2
+    {1, {{">=", 2, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 3}},
+     1, 2},
+    // t1 = x + 3: 1 cycles, was 2
+    {1, {{"+", 3, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 3}},
+     1, 2},
+    // t1 = x - 3: 1 cycles, was 2
+    {1, {{"-", 3, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -3}},
+     1, 2},
+    // t1 = x < 3: 1 cycles, was 2
+    {1, {{"<", 3, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 3}},
+     1, 2},
+    // t1 = x <= 3: 1 cycles, was 2
+    {1, {{"<=", 3, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4}},
+     1, 2},
+    // t1 = 3 > x: 1 cycles, was 2
+    {1, {{">", 3, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 3}},
+     1, 2},
+    // t1 = 3 >= x: 1 cycles, was 2
+    {1, {{">=", 3, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4}},
+     1, 2},
+    // t1 = x + 4: 1 cycles, was 2
+    {1, {{"+", 4, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 4}},
+     1, 2},
+    // t1 = x - 4: 1 cycles, was 2
+    {1, {{"-", 4, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -4}},
+     1, 2},
+    // t1 = x < 4: 1 cycles, was 2
+    {1, {{"<", 4, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4}},
+     1, 2},
+    // t1 = x <= 4: 1 cycles, was 2
+    {1, {{"<=", 4, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 5}},
+     1, 2},
+    // t1 = 4 > x: 1 cycles, was 2
+    {1, {{">", 4, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4}},
+     1, 2},
+    // t1 = 4 >= x: 1 cycles, was 2
+    {1, {{">=", 4, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 5}},
+     1, 2},
+    // t1 = x + 5: 1 cycles, was 2
+    {1, {{"+", 5, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 5}},
+     1, 2},
+    // t1 = x - 5: 1 cycles, was 2
+    {1, {{"-", 5, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -5}},
+     1, 2},
+    // t1 = x < 5: 1 cycles, was 2
+    {1, {{"<", 5, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 5}},
+     1, 2},
+    // t1 = x <= 5: 1 cycles, was 2
+    {1, {{"<=", 5, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 6}},
+     1, 2},
+    // t1 = 5 > x: 1 cycles, was 2
+    {1, {{">", 5, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 5}},
+     1, 2},
+    // t1 = 5 >= x: 1 cycles, was 2
+    {1, {{">=", 5, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 6}},
+     1, 2},
+    // t1 = x + 6: 1 cycles, was 2
+    {1, {{"+", 6, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 6}},
+     1, 2},
+    // t1 = x - 6: 1 cycles, was 2
+    {1, {{"-", 6, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -6}},
+     1, 2},
+    // t1 = x < 6: 1 cycles, was 2
+    {1, {{"<", 6, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 6}},
+     1, 2},
+    // t1 = x <= 6: 1 cycles, was 2
+    {1, {{"<=", 6, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 7}},
+     1, 2},
+    // t1 = 6 > x: 1 cycles, was 2
+    {1, {{">", 6, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 6}},
+     1, 2},
+    // t1 = 6 >= x: 1 cycles, was 2
+    {1, {{">=", 6, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 7}},
+     1, 2},
+    // t1 = x + 7: 1 cycles, was 2
+    {1, {{"+", 7, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 7}},
+     1, 2},
+    // t1 = x - 7: 1 cycles, was 2
+    {1, {{"-", 7, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -7}},
+     1, 2},
+    // t1 = x < 7: 1 cycles, was 2
+    {1, {{"<", 7, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 7}},
+     1, 2},
+    // t1 = x <= 7: 1 cycles, was 2
+    {1, {{"<=", 7, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 8}},
+     1, 2},
+    // t1 = 7 > x: 1 cycles, was 2
+    {1, {{">", 7, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 7}},
+     1, 2},
+    // t1 = 7 >= x: 1 cycles, was 2
+    {1, {{">=", 7, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 8}},
+     1, 2},
+    // t1 = x + 8: 1 cycles, was 2
+    {1, {{"+", 8, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 8}},
+     1, 2},
+    // t1 = x - 8: 1 cycles, was 2
+    {1, {{"-", 8, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -8}},
+     1, 2},
+    // t1 = x < 8: 1 cycles, was 2
+    {1, {{"<", 8, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 8}},
+     1, 2},
+    // t1 = x <= 8: 1 cycles, was 2
+    {1, {{"<=", 8, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 9}},
+     1, 2},
+    // t1 = 8 > x: 1 cycles, was 2
+    {1, {{">", 8, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 8}},
+     1, 2},
+    // t1 = 8 >= x: 1 cycles, was 2
+    {1, {{">=", 8, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 9}},
+     1, 2},
+    // t1 = x + 9: 1 cycles, was 2
+    {1, {{"+", 9, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 9}},
+     1, 2},
+    // t1 = x - 9: 1 cycles, was 2
+    {1, {{"-", 9, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -9}},
+     1, 2},
+    // t1 = x < 9: 1 cycles, was 2
+    {1, {{"<", 9, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 9}},
+     1, 2},
+    // t1 = x <= 9: 1 cycles, was 2
+    {1, {{"<=", 9, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 10}},
+     1, 2},
+    // t1 = 9 > x: 1 cycles, was 2
+    {1, {{">", 9, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 9}},
+     1, 2},
+    // t1 = 9 >= x: 1 cycles, was 2
+    {1, {{">=", 9, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 10}},
+     1, 2},
+    // t1 = x + 10: 1 cycles, was 2
+    {1, {{"+", 10, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 10}},
+     1, 2},
+    // t1 = x - 10: 1 cycles, was 2
+    {1, {{"-", 10, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -10}},
+     1, 2},
+    // t1 = x < 10: 1 cycles, was 2
+    {1, {{"<", 10, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 10}},
+     1, 2},
+    // t1 = x <= 10: 1 cycles, was 2
+    {1, {{"<=", 10, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 11}},
+     1, 2},
+    // t1 = 10 > x: 1 cycles, was 2
+    {1, {{">", 10, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 10}},
+     1, 2},
+    // t1 = 10 >= x: 1 cycles, was 2
+    {1, {{">=", 10, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 11}},
+     1, 2},
+    // t1 = x + 12: 1 cycles, was 2
+    {1, {{"+", 12, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 12}},
+     1, 2},
+    // t1 = x - 12: 1 cycles, was 2
+    {1, {{"-", 12, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -12}},
+     1, 2},
+    // t1 = x <= 12: 1 cycles, was 2
+    {1, {{"<=", 12, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 13}},
+     1, 2},
+    // t1 = 12 > x: 1 cycles, was 2
+    {1, {{">", 12, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 12}},
+     1, 2},
+    // t1 = 12 >= x: 1 cycles, was 2
+    {1, {{">=", 12, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 13}},
+     1, 2},
+    // t1 = x + 15: 1 cycles, was 2
+    {1, {{"+", 15, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 15}},
+     1, 2},
+    // t1 = x - 15: 1 cycles, was 2
+    {1, {{"-", 15, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -15}},
+     1, 2},
+    // t1 = x < 15: 1 cycles, was 2
+    {1, {{"<", 15, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 15}},
+     1, 2},
+    // t1 = x <= 15: 1 cycles, was 2
+    {1, {{"<=", 15, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 16}},
+     1, 2},
+    // t1 = 15 > x: 1 cycles, was 2
+    {1, {{">", 15, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 15}},
+     1, 2},
+    // t1 = 15 >= x: 1 cycles, was 2
+    {1, {{">=", 15, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 16}},
+     1, 2},
+    // t1 = x + 16: 1 cycles, was 2
+    {1, {{"+", 16, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 16}},
+     1, 2},
+    // t1 = x - 16: 1 cycles, was 2
+    {1, {{"-", 16, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -16}},
+     1, 2},
+    // t1 = x < 16: 1 cycles, was 2
+    {1, {{"<", 16, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 16}},
+     1, 2},
+    // t1 = x <= 16: 1 cycles, was 2
+    {1, {{"<=", 16, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 17}},
+     1, 2},
+    // t1 = 16 > x: 1 cycles, was 2
+    {1, {{">", 16, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 16}},
+     1, 2},
+    // t1 = 16 >= x: 1 cycles, was 2
+    {1, {{">=", 16, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 17}},
+     1, 2},
+    // t1 = x + 17: 1 cycles, was 2
+    {1, {{"+", 17, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 17}},
+     1, 2},
+    // t1 = x - 17: 1 cycles, was 2
+    {1, {{"-", 17, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -17}},
+     1, 2},
+    // t1 = x < 17: 1 cycles, was 2
+    {1, {{"<", 17, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 17}},
+     1, 2},
+    // t1 = x <= 17: 1 cycles, was 2
+    {1, {{"<=", 17, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 18}},
+     1, 2},
+    // t1 = 17 > x: 1 cycles, was 2
+    {1, {{">", 17, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 17}},
+     1, 2},
+    // t1 = 17 >= x: 1 cycles, was 2
+    {1, {{">=", 17, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 18}},
+     1, 2},
+    // t1 = x + 24: 1 cycles, was 2
+    {1, {{"+", 24, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 24}},
+     1, 2},
+    // t1 = x - 24: 1 cycles, was 2
+    {1, {{"-", 24, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -24}},
+     1, 2},
+    // t1 = x < 24: 1 cycles, was 2
+    {1, {{"<", 24, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 24}},
+     1, 2},
+    // t1 = x <= 24: 1 cycles, was 2
+    {1, {{"<=", 24, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 25}},
+     1, 2},
+    // t1 = 24 > x: 1 cycles, was 2
+    {1, {{">", 24, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 24}},
+     1, 2},
+    // t1 = 24 >= x: 1 cycles, was 2
+    {1, {{">=", 24, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 25}},
+     1, 2},
+    // t1 = x + 31: 1 cycles, was 2
+    {1, {{"+", 31, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 31}},
+     1, 2},
+    // t1 = x - 31: 1 cycles, was 2
+    {1, {{"-", 31, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -31}},
+     1, 2},
+    // t1 = x < 31: 1 cycles, was 2
+    {1, {{"<", 31, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 31}},
+     1, 2},
+    // t1 = x <= 31: 1 cycles, was 2
+    {1, {{"<=", 31, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 32}},
+     1, 2},
+    // t1 = 31 > x: 1 cycles, was 2
+    {1, {{">", 31, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 31}},
+     1, 2},
+    // t1 = 31 >= x: 1 cycles, was 2
+    {1, {{">=", 31, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 32}},
+     1, 2},
+    // t1 = x + 32: 1 cycles, was 2
+    {1, {{"+", 32, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 32}},
+     1, 2},
+    // t1 = x - 32: 1 cycles, was 2
+    {1, {{"-", 32, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -32}},
+     1, 2},
+    // t1 = x < 32: 1 cycles, was 2
+    {1, {{"<", 32, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 32}},
+     1, 2},
+    // t1 = x <= 32: 1 cycles, was 2
+    {1, {{"<=", 32, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 33}},
+     1, 2},
+    // t1 = 32 > x: 1 cycles, was 2
+    {1, {{">", 32, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 32}},
+     1, 2},
+    // t1 = 32 >= x: 1 cycles, was 2
+    {1, {{">=", 32, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 33}},
+     1, 2},
+    // t1 = x + 33: 1 cycles, was 2
+    {1, {{"+", 33, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 33}},
+     1, 2},
+    // t1 = x - 33: 1 cycles, was 2
+    {1, {{"-", 33, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -33}},
+     1, 2},
+    // t1 = x < 33: 1 cycles, was 2
+    {1, {{"<", 33, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 33}},
+     1, 2},
+    // t1 = x <= 33: 1 cycles, was 2
+    {1, {{"<=", 33, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 34}},
+     1, 2},
+    // t1 = 33 > x: 1 cycles, was 2
+    {1, {{">", 33, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 33}},
+     1, 2},
+    // t1 = 33 >= x: 1 cycles, was 2
+    {1, {{">=", 33, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 34}},
+     1, 2},
+    // t1 = x + 63: 1 cycles, was 2
+    {1, {{"+", 63, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 63}},
+     1, 2},
+    // t1 = x - 63: 1 cycles, was 2
+    {1, {{"-", 63, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -63}},
+     1, 2},
+    // t1 = x < 63: 1 cycles, was 2
+    {1, {{"<", 63, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 63}},
+     1, 2},
+    // t1 = x <= 63: 1 cycles, was 2
+    {1, {{"<=", 63, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 64}},
+     1, 2},
+    // t1 = 63 > x: 1 cycles, was 2
+    {1, {{">", 63, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 63}},
+     1, 2},
+    // t1 = 63 >= x: 1 cycles, was 2
+    {1, {{">=", 63, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 64}},
+     1, 2},
+    // t1 = x + 64: 1 cycles, was 2
+    {1, {{"+", 64, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 64}},
+     1, 2},
+    // t1 = x - 64: 1 cycles, was 2
+    {1, {{"-", 64, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -64}},
+     1, 2},
+    // t1 = x < 64: 1 cycles, was 2
+    {1, {{"<", 64, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 64}},
+     1, 2},
+    // t1 = x <= 64: 1 cycles, was 2
+    {1, {{"<=", 64, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 65}},
+     1, 2},
+    // t1 = 64 > x: 1 cycles, was 2
+    {1, {{">", 64, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 64}},
+     1, 2},
+    // t1 = 64 >= x: 1 cycles, was 2
+    {1, {{">=", 64, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 65}},
+     1, 2},
+    // t1 = x + 100: 1 cycles, was 2
+    {1, {{"+", 100, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 100}},
+     1, 2},
+    // t1 = x - 100: 1 cycles, was 2
+    {1, {{"-", 100, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -100}},
+     1, 2},
+    // t1 = x < 100: 1 cycles, was 2
+    {1, {{"<", 100, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 100}},
+     1, 2},
+    // t1 = x <= 100: 1 cycles, was 2
+    {1, {{"<=", 100, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 101}},
+     1, 2},
+    // t1 = 100 > x: 1 cycles, was 2
+    {1, {{">", 100, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 100}},
+     1, 2},
+    // t1 = 100 >= x: 1 cycles, was 2
+    {1, {{">=", 100, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 101}},
+     1, 2},
+    // t1 = x + 127: 1 cycles, was 2
+    {1, {{"+", 127, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 127}},
+     1, 2},
+    // t1 = x - 127: 1 cycles, was 2
+    {1, {{"-", 127, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -127}},
+     1, 2},
+    // t1 = x < 127: 1 cycles, was 2
+    {1, {{"<", 127, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 127}},
+     1, 2},
+    // t1 = x <= 127: 1 cycles, was 2
+    {1, {{"<=", 127, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 128}},
+     1, 2},
+    // t1 = 127 > x: 1 cycles, was 2
+    {1, {{">", 127, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 127}},
+     1, 2},
+    // t1 = 127 >= x: 1 cycles, was 2
+    {1, {{">=", 127, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 128}},
+     1, 2},
+    // t1 = x + 128: 1 cycles, was 2
+    {1, {{"+", 128, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 128}},
+     1, 2},
+    // t1 = x - 128: 1 cycles, was 2
+    {1, {{"-", 128, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -128}},
+     1, 2},
+    // t1 = x < 128: 1 cycles, was 2
+    {1, {{"<", 128, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 128}},
+     1, 2},
+    // t1 = x <= 128: 1 cycles, was 2
+    {1, {{"<=", 128, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 129}},
+     1, 2},
+    // t1 = 128 > x: 1 cycles, was 2
+    {1, {{">", 128, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 128}},
+     1, 2},
+    // t1 = 128 >= x: 1 cycles, was 2
+    {1, {{">=", 128, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 129}},
+     1, 2},
+    // t1 = x + 255: 1 cycles, was 2
+    {1, {{"+", 255, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 255}},
+     1, 2},
+    // t1 = x - 255: 1 cycles, was 2
+    {1, {{"-", 255, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -255}},
+     1, 2},
+    // t1 = x < 255: 1 cycles, was 2
+    {1, {{"<", 255, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 255}},
+     1, 2},
+    // t1 = x <= 255: 1 cycles, was 2
+    {1, {{"<=", 255, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 256}},
+     1, 2},
+    // t1 = 255 > x: 1 cycles, was 2
+    {1, {{">", 255, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 255}},
+     1, 2},
+    // t1 = 255 >= x: 1 cycles, was 2
+    {1, {{">=", 255, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 256}},
+     1, 2},
+    // t1 = x + 256: 1 cycles, was 2
+    {1, {{"+", 256, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 256}},
+     1, 2},
+    // t1 = x - 256: 1 cycles, was 2
+    {1, {{"-", 256, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -256}},
+     1, 2},
+    // t1 = x < 256: 1 cycles, was 2
+    {1, {{"<", 256, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 256}},
+     1, 2},
+    // t1 = x <= 256: 1 cycles, was 2
+    {1, {{"<=", 256, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 257}},
+     1, 2},
+    // t1 = 256 > x: 1 cycles, was 2
+    {1, {{">", 256, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 256}},
+     1, 2},
+    // t1 = 256 >= x: 1 cycles, was 2
+    {1, {{">=", 256, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 257}},
+     1, 2},
+    // t1 = x + 1000: 1 cycles, was 2
+    {1, {{"+", 1000, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 1000}},
+     1, 2},
+    // t1 = x - 1000: 1 cycles, was 2
+    {1, {{"-", 1000, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -1000}},
+     1, 2},
+    // t1 = x < 1000: 1 cycles, was 2
+    {1, {{"<", 1000, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1000}},
+     1, 2},
+    // t1 = x <= 1000: 1 cycles, was 2
+    {1, {{"<=", 1000, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1001}},
+     1, 2},
+    // t1 = 1000 > x: 1 cycles, was 2
+    {1, {{">", 1000, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1000}},
+     1, 2},
+    // t1 = 1000 >= x: 1 cycles, was 2
+    {1, {{">=", 1000, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1001}},
+     1, 2},
+    // t1 = x + 1024: 1 cycles, was 2
+    {1, {{"+", 1024, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 1024}},
+     1, 2},
+    // t1 = x - 1024: 1 cycles, was 2
+    {1, {{"-", 1024, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -1024}},
+     1, 2},
+    // t1 = x < 1024: 1 cycles, was 2
+    {1, {{"<", 1024, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1024}},
+     1, 2},
+    // t1 = x <= 1024: 1 cycles, was 2
+    {1, {{"<=", 1024, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1025}},
+     1, 2},
+    // t1 = 1024 > x: 1 cycles, was 2
+    {1, {{">", 1024, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1024}},
+     1, 2},
+    // t1 = 1024 >= x: 1 cycles, was 2
+    {1, {{">=", 1024, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 1025}},
+     1, 2},
+    // t1 = x + 4096: 1 cycles, was 2
+    {1, {{"+", 4096, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, 4096}},
+     1, 2},
+    // t1 = x - 4096: 1 cycles, was 2
+    {1, {{"-", 4096, false}},
+     1, {{"addiu", SuperoptOperand_Input, SuperoptOperand_Immediate, -4096}},
+     1, 2},
+    // t1 = x < 4096: 1 cycles, was 2
+    {1, {{"<", 4096, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4096}},
+     1, 2},
+    // t1 = x <= 4096: 1 cycles, was 2
+    {1, {{"<=", 4096, false}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4097}},
+     1, 2},
+    // t1 = 4096 > x: 1 cycles, was 2
+    {1, {{">", 4096, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4096}},
+     1, 2},
+    // t1 = 4096 >= x: 1 cycles, was 2
+    {1, {{">=", 4096, true}},
+     1, {{"slti", SuperoptOperand_Input, SuperoptOperand_Immediate, 4097}},
+     1, 2},
+    {0},
+};
+
+// The last entry only keeps the array from being empty
+const int superoptRuleCount = sizeof(superoptRules) / sizeof(superoptRules[0]) - 1;
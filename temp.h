@@ -1,7 +1,13 @@
-// temp.h
-#ifndef TEMP_H
-#define TEMP_H
-
-extern int tempVars[50]; // Declaration
-
-#endif // TEMP_H
\ No newline at end of file
+// temp.h
+#ifndef TEMP_H
+#define TEMP_H
+
+// Temporaries are virtual registers named TEMP_PREFIX followed by a number.
+// There is no limit on how many exist; they have no symbol table entry and
+// no storage, and only the code generator maps them onto machine registers.
+// '%' cannot start a source identifier, so they never clash with variables.
+#define TEMP_PREFIX "%t"
+
+extern int tempCount; // Number of virtual registers handed out so far
+
+#endif // TEMP_H
@@ -0,0 +1,54 @@
+#include <string.h>
+#include "types.h"
+
+static const char *dataTypeNames[DATA_TYPE_COUNT] = {"unknown", "int", "float", "char", "bool", "void"};
+
+#define U DataType_Unknown
+#define I DataType_Int
+#define F DataType_Float
+#define C DataType_Char
+#define B DataType_Bool
+
+// + - *: int and float promote to float; otherwise both sides must agree
+const uint8_t arithmeticResultType[DATA_TYPE_COUNT][DATA_TYPE_COUNT] = {
+    //          Unknown  Int  Float Char Bool Void
+    /* Unknown */ {U,    U,   U,    U,   U,   U},
+    /* Int     */ {U,    I,   F,    U,   U,   U},
+    /* Float   */ {U,    F,   F,    U,   U,   U},
+    /* Char    */ {U,    U,   U,    C,   U,   U},
+    /* Bool    */ {U,    U,   U,    U,   B,   U},
+    /* Void    */ {U,    U,   U,    U,   U,   U},
+};
+
+// < <= > >= == !=: numbers compare with each other, other types only with
+// themselves; the result is always bool
+const uint8_t comparisonResultType[DATA_TYPE_COUNT][DATA_TYPE_COUNT] = {
+    //          Unknown  Int  Float Char Bool Void
+    /* Unknown */ {U,    U,   U,    U,   U,   U},
+    /* Int     */ {U,    B,   B,    U,   U,   U},
+    /* Float   */ {U,    B,   B,    U,   U,   U},
+    /* Char    */ {U,    U,   U,    B,   U,   U},
+    /* Bool    */ {U,    U,   U,    U,   B,   U},
+    /* Void    */ {U,    U,   U,    U,   U,   U},
+};
+
+#undef U
+#undef I
+#undef F
+#undef C
+#undef B
+
+DataType dataTypeFromName(const char *name)
+{
+    for (int i = DataType_Int; i < DATA_TYPE_COUNT; i++)
+    {
+        if (strcmp(name, dataTypeNames[i]) == 0)
+            return (DataType)i;
+    }
+    return DataType_Unknown;
+}
+
+const char *dataTypeName(DataType dataType)
+{
+    return dataTypeNames[dataType];
+}
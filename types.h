@@ -0,0 +1,30 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <stdint.h>
+
+// Data type of a symbol, declaration or expression, small enough to store
+// in one byte
+typedef enum
+{
+    DataType_Unknown,
+    DataType_Int,
+    DataType_Float,
+    DataType_Char,
+    DataType_Bool,
+    DataType_Void,
+    DATA_TYPE_COUNT
+} DataType;
+
+// Result types of binary operators, indexed by the operand types;
+// DataType_Unknown marks an invalid combination
+extern const uint8_t arithmeticResultType[DATA_TYPE_COUNT][DATA_TYPE_COUNT];
+extern const uint8_t comparisonResultType[DATA_TYPE_COUNT][DATA_TYPE_COUNT];
+
+// Map a type keyword to its DataType (DataType_Unknown if it is not one)
+DataType dataTypeFromName(const char *name);
+
+// Keyword spelling of a DataType
+const char *dataTypeName(DataType dataType);
+
+#endif // TYPES_H
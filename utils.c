@@ -7,10 +7,21 @@
 
 // ---- Error Helper ----
 
+jmp_buf *compileErrorRecovery = NULL;
+
+void abortCompilation()
+{
+    if (compileErrorRecovery != NULL)
+    {
+        longjmp(*compileErrorRecovery, 1);
+    }
+    exit(1);  // Exit the program with a non-zero status
+}
+
 void fatal(const char *s) 
 {
     fprintf(stderr, "Fatal Error: %s\n", s);
-    exit(1);  // Exit the program with a non-zero status
+    abortCompilation();
 }
 
 // ---- optimizer.c Helpers ----
@@ -27,8 +38,19 @@ bool isConstant(const char* str) {
     return true;
 }
 
+bool isFloatConstant(const char* str) {
+    if (str == NULL || *str == '\0') {
+        return false;
+    }
+    char *end;
+    strtod(str, &end);
+    return *end == '\0' && strpbrk(str, ".eE") != NULL;
+}
+
 bool isVariable(const char* str) {
     if (str == NULL || *str == '\0') return false;
+    // Temporaries are variables too, just without a home in memory
+    if (isVirtualRegister(str)) return true;
     if (!isalpha((unsigned char)*str) && *str != '_') return false;
     ++str;
     while (*str) {
@@ -38,38 +60,82 @@ bool isVariable(const char* str) {
     return true;
 }
 
+bool isLabel(TAC *instr) {
+    return instr != NULL && instr->op != NULL && strcmp(instr->op, "label") == 0;
+}
+
+bool isBranch(TAC *instr) {
+    return instr != NULL && instr->op != NULL &&
+           (strcmp(instr->op, "goto") == 0 || strcmp(instr->op, "ifFalse") == 0);
+}
+
+bool isControlFlow(TAC *instr) {
+    return isLabel(instr) || isBranch(instr);
+}
+
 // ---- semantic.c Helpers ----
 
 void initializeTempVars()
 {
-    for (int i = 0; i < 50; i++)
-    {
-        tempVars[i] = 0;
-    }
+    tempCount = 0;
 }
 
-int allocateNextAvailableTempVar(int tempVars[], int size)
+// Check for a virtual register name: TEMP_PREFIX followed by digits
+bool isVirtualRegister(const char *str)
 {
-    for (int i = 0; i < size; i++)
+    size_t prefixLength = sizeof(TEMP_PREFIX) - 1;
+    if (str == NULL || strncmp(str, TEMP_PREFIX, prefixLength) != 0 || str[prefixLength] == '\0')
+        return false;
+    for (str += prefixLength; *str; ++str)
     {
-        if (tempVars[i] == 0)
-        {
-            tempVars[i] = 1;
-            return i;
-        }
+        if (!isdigit((unsigned char)*str))
+            return false;
     }
-    return -1; // No available temp var
+    return true;
 }
 
-void deallocateTempVar(int tempVars[], int index)
+// Number of a virtual register (-1 if the name is not one)
+int virtualRegisterNumber(const char *str)
 {
-    if (index >= 0 && index < 50)
+    return isVirtualRegister(str) ? atoi(str + sizeof(TEMP_PREFIX) - 1) : -1;
+}
+
+// Declarations in id order: "int x", "float f = 2.5", "int a [ 4 ]", and
+// one "data a [ i ] = v" line per statically known array element
+static void printDeclarationsToFile(FILE *file, SymbolTable *symTab)
+{
+    for (int id = 1; id <= symTab->count; id++)
     {
-        tempVars[index] = 0;
+        Symbol *symbol = getSymbolById(symTab, id);
+        if (symbol == NULL || !isVariable(symbol->name))
+            continue;
+        if (symbol->isArray && symbol->arrayInfo != NULL)
+        {
+            Array *array = symbol->arrayInfo;
+            fprintf(file, "%s %s [ %d ]\n", dataTypeName(array->dataType), symbol->name, array->size);
+            for (int i = 0; i < array->size && array->knownCount > 0; i++)
+            {
+                const ArrayValue *value = getArrayValue(array, i);
+                if (value == NULL)
+                    continue;
+                if (array->isFloat)
+                    fprintf(file, "data %s [ %d ] = %.9g\n", symbol->name, i, value->floatValue);
+                else
+                    fprintf(file, "data %s [ %d ] = %d\n", symbol->name, i, value->intValue);
+            }
+        }
+        else if (symbol->value != NULL)
+        {
+            fprintf(file, "%s %s = %s\n", dataTypeName(symbol->type), symbol->name, symbol->value);
+        }
+        else
+        {
+            fprintf(file, "%s %s\n", dataTypeName(symbol->type), symbol->name);
+        }
     }
 }
 
-void printTACToFile(const char *filename, TAC *tac)
+void printTACToFile(const char *filename, TAC *tac, SymbolTable *symTab, bool optimized)
 {
     FILE *file = fopen(filename, "w");
     if (!file)
@@ -78,6 +144,16 @@ void printTACToFile(const char *filename, TAC *tac)
         return;
     }
 
+    if (optimized)
+    {
+        fprintf(file, "optimized\n");
+    }
+
+    if (symTab != NULL)
+    {
+        printDeclarationsToFile(file, symTab);
+    }
+
     TAC *current = tac;
 
     while (current != NULL)
@@ -88,10 +164,26 @@ void printTACToFile(const char *filename, TAC *tac)
             {
                 fprintf(file, "%s = %s\n", current->result, current->arg1);
             }
+            else if (strcmp(current->op, "fmov") == 0)
+            {
+                fprintf(file, "%s = %s (float)\n", current->result, current->arg1);
+            }
             else if (strcmp(current->op, "write") == 0)
             {
                 fprintf(file, "write %s\n", current->arg1);
             }
+            else if (strcmp(current->op, "label") == 0)
+            {
+                fprintf(file, "%s:\n", current->result);
+            }
+            else if (strcmp(current->op, "goto") == 0)
+            {
+                fprintf(file, "goto %s\n", current->result);
+            }
+            else if (strcmp(current->op, "ifFalse") == 0)
+            {
+                fprintf(file, "ifFalse %s goto %s\n", current->arg1, current->result);
+            }
             else if (strcmp(current->op, "[]=") == 0)
             {
                 fprintf(file, "%s [ %s ] = %s\n", current->result, current->arg1, current->arg2);
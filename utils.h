@@ -4,21 +4,36 @@
 
 #include "optimizer.h"
 #include "semantic.h"
+#include <setjmp.h>
 
 // ---- parser.y helpers ----
 
+// Where abortCompilation returns to instead of exiting; the compile
+// server sets it around each request
+extern jmp_buf *compileErrorRecovery;
+
+// Stop compiling after an error has been reported; never returns
+__attribute__((noreturn)) void abortCompilation();
+
 void fatal(const char *s);  // , int yylineno
 
 // ---- optimizer.c Helpers ----
 
 bool isConstant(const char* str);
+bool isFloatConstant(const char* str);
 bool isVariable(const char* str);
+bool isLabel(TAC *instr);
+bool isBranch(TAC *instr);
+bool isControlFlow(TAC *instr);
 
 // ---- semantic.c Helpers ----
 
-void initializeTempVars(); // int tempVars[], int size
-int allocateNextAvailableTempVar(int tempVars[], int size);
-void deallocateTempVar(int tempVars[], int index);
-void printTACToFile(const char* filename, TAC* tac);
+void initializeTempVars();
+bool isVirtualRegister(const char* str);
+int virtualRegisterNumber(const char* str);
+// Write a text dump of tac; with a symbol table, the dump starts with the
+// declarations and initial values (see readTextIR in irfile.h). An
+// optimized dump opens with an "optimized" line.
+void printTACToFile(const char* filename, TAC* tac, SymbolTable *symTab, bool optimized);
 
 #endif // UTILS_H
\ No newline at end of file
@@ -0,0 +1,422 @@
+// x86Generator.c
+
+#include "x86Generator.h"
+#include "utils.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// The shared allocator names registers the MIPS way; each one has a fixed
+// x86-64 register. $t0-$t7 and $t8 use callee-saved or otherwise unused
+// registers, %eax/%edx are left free for idiv and constants, and %xmm15
+// carries the argument of write_float.
+typedef struct
+{
+    const char *name;  // Name used by the allocator
+    const char *reg32; // 32-bit (or xmm) register
+    const char *reg64; // Full register for addressing, NULL for xmm
+} RegisterName;
+
+static const RegisterName registerNames[] = {
+    {"$t0", "%r8d", "%r8"}, {"$t1", "%r9d", "%r9"}, {"$t2", "%r10d", "%r10"}, {"$t3", "%r11d", "%r11"},
+    {"$t4", "%r12d", "%r12"}, {"$t5", "%r13d", "%r13"}, {"$t6", "%r14d", "%r14"}, {"$t7", "%r15d", "%r15"},
+    {"$t8", "%ebx", "%rbx"}, {"$t9", "%ecx", "%rcx"}, {"$a0", "%edi", "%rdi"},
+    {"$f0", "%xmm0", NULL}, {"$f2", "%xmm1", NULL}, {"$f4", "%xmm2", NULL}, {"$f6", "%xmm3", NULL},
+    {"$f8", "%xmm4", NULL}, {"$f10", "%xmm5", NULL}, {"$f12", "%xmm6", NULL}, {"$f14", "%xmm7", NULL},
+    {"$f16", "%xmm8", NULL}, {"$f18", "%xmm9", NULL},
+};
+
+// Registers the runtime routines preserve around their call to printf
+#define SAVED_XMM_REGISTERS 10
+
+static const RegisterName *lookupRegister(const char *name)
+{
+    for (size_t i = 0; i < sizeof(registerNames) / sizeof(registerNames[0]); i++)
+    {
+        if (strcmp(registerNames[i].name, name) == 0)
+            return &registerNames[i];
+    }
+    fprintf(stderr, "Error: No x86-64 register for %s\n", name);
+    abortCompilation();
+}
+
+static const char *reg32(const char *name)
+{
+    return lookupRegister(name)->reg32;
+}
+
+static const char *reg64(const char *name)
+{
+    return lookupRegister(name)->reg64;
+}
+
+static bool isXmm(const char *name)
+{
+    return lookupRegister(name)->reg64 == NULL;
+}
+
+static void x86TextPrologue()
+{
+    FILE *out = codeGeneratorOutput();
+    fprintf(out, ".text\n");
+    fprintf(out, ".globl main\n");
+    fprintf(out, "main:\n");
+
+    // Five pushes keep the stack 16-byte aligned for the runtime calls
+    fprintf(out, "\tpushq %%rbx\n");
+    fprintf(out, "\tpushq %%r12\n");
+    fprintf(out, "\tpushq %%r13\n");
+    fprintf(out, "\tpushq %%r14\n");
+    fprintf(out, "\tpushq %%r15\n");
+}
+
+// A runtime routine that prints one value with printf, preserving every
+// register the generated code may have live
+static void emitWriteRoutine(FILE *out, const char *name, const char *format, bool isFloat)
+{
+    static const char *savedRegisters[] = {"%rax", "%rcx", "%rdx", "%rsi", "%rdi", "%r8", "%r9", "%r10", "%r11"};
+    int numSaved = sizeof(savedRegisters) / sizeof(savedRegisters[0]);
+
+    fprintf(out, "%s:\n", name);
+    for (int i = 0; i < numSaved; i++)
+        fprintf(out, "\tpushq %s\n", savedRegisters[i]);
+    fprintf(out, "\tsubq $%d, %%rsp\n", SAVED_XMM_REGISTERS * 16);
+    for (int i = 0; i < SAVED_XMM_REGISTERS; i++)
+        fprintf(out, "\tmovdqu %%xmm%d, %d(%%rsp)\n", i, i * 16);
+
+    if (isFloat)
+    {
+        fprintf(out, "\tcvtss2sd %%xmm15, %%xmm0\n");
+        fprintf(out, "\tleaq %s(%%rip), %%rdi\n", format);
+        fprintf(out, "\tmovl $1, %%eax\n");
+    }
+    else
+    {
+        fprintf(out, "\tmovl %%edi, %%esi\n");
+        fprintf(out, "\tleaq %s(%%rip), %%rdi\n", format);
+        fprintf(out, "\txorl %%eax, %%eax\n");
+    }
+    fprintf(out, "\tcall printf@PLT\n");
+
+    for (int i = 0; i < SAVED_XMM_REGISTERS; i++)
+        fprintf(out, "\tmovdqu %d(%%rsp), %%xmm%d\n", i * 16, i);
+    fprintf(out, "\taddq $%d, %%rsp\n", SAVED_XMM_REGISTERS * 16);
+    for (int i = numSaved - 1; i >= 0; i--)
+        fprintf(out, "\tpopq %s\n", savedRegisters[i]);
+    fprintf(out, "\tret\n");
+}
+
+static void x86TextEpilogue()
+{
+    FILE *out = codeGeneratorOutput();
+    fprintf(out, "\tpopq %%r15\n");
+    fprintf(out, "\tpopq %%r14\n");
+    fprintf(out, "\tpopq %%r13\n");
+    fprintf(out, "\tpopq %%r12\n");
+    fprintf(out, "\tpopq %%rbx\n");
+    fprintf(out, "\txorl %%eax, %%eax\n");
+    fprintf(out, "\tret\n");
+
+    // Runtime: write prints an int in %edi, write_float a float in %xmm15;
+    // floats print like mipsim and the TAC interpreter
+    fprintf(out, "# Runtime support\n");
+    emitWriteRoutine(out, "cmm_write_int", "cmm_int_format", false);
+    emitWriteRoutine(out, "cmm_write_float", "cmm_float_format", true);
+    fprintf(out, ".section .rodata\n");
+    fprintf(out, "cmm_int_format: .string \"%%d\\n\"\n");
+    fprintf(out, "cmm_float_format: .string \"%%.9g\\n\"\n");
+    fprintf(out, ".section .note.GNU-stack,\"\",@progbits\n");
+}
+
+static void x86StoreHome(const char *regName, const char *var)
+{
+    fprintf(codeGeneratorOutput(), "\t%s %s, %s(%%rip)\n", isXmm(regName) ? "movss" : "movl", reg32(regName), var);
+}
+
+static void x86StoreSpill(const char *regName, int offset)
+{
+    fprintf(codeGeneratorOutput(), "\t%s %s, spill_area+%d(%%rip)\n", isXmm(regName) ? "movss" : "movl", reg32(regName), offset);
+}
+
+static void x86LoadHome(const char *regName, const char *var)
+{
+    fprintf(codeGeneratorOutput(), "\t%s %s(%%rip), %s\n", isXmm(regName) ? "movss" : "movl", var, reg32(regName));
+}
+
+static void x86LoadSpill(const char *regName, int offset)
+{
+    fprintf(codeGeneratorOutput(), "\t%s spill_area+%d(%%rip), %s\n", isXmm(regName) ? "movss" : "movl", offset, reg32(regName));
+}
+
+static void x86LoadImmediate(const char *regName, const char *constant)
+{
+    fprintf(codeGeneratorOutput(), "\tmovl $%s, %s\n", constant, reg32(regName));
+}
+
+static void x86LoadFloatImmediate(const char *regName, const char *constant)
+{
+    // There is no float immediate; build the bit pattern in %eax
+    float value = (float)atof(constant);
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    fprintf(codeGeneratorOutput(), "\tmovl $0x%08x, %%eax\n", bits);
+    fprintf(codeGeneratorOutput(), "\tmovd %%eax, %s\n", reg32(regName));
+}
+
+static void x86MoveRegister(const char *destReg, const char *srcReg)
+{
+    FILE *out = codeGeneratorOutput();
+    if (strcmp(destReg, srcReg) == 0)
+        return;
+    if (isXmm(destReg) && isXmm(srcReg))
+        fprintf(out, "\tmovaps %s, %s\n", reg32(srcReg), reg32(destReg));
+    else if (isXmm(destReg) || isXmm(srcReg))
+        fprintf(out, "\tmovd %s, %s\n", reg32(srcReg), reg32(destReg));
+    else
+        fprintf(out, "\tmovl %s, %s\n", reg32(srcReg), reg32(destReg));
+}
+
+static void x86ConvertIntToFloat(const char *intReg, const char *floatReg)
+{
+    fprintf(codeGeneratorOutput(), "\tcvtsi2ssl %s, %s\n", reg32(intReg), reg32(floatReg));
+}
+
+// Map a TAC comparison to the setcc that reads the flags of "cmp arg2, arg1"
+static const char *x86SetInstruction(const char *op)
+{
+    if (strcmp(op, "<") == 0)
+        return "setl";
+    if (strcmp(op, "<=") == 0)
+        return "setle";
+    if (strcmp(op, ">") == 0)
+        return "setg";
+    if (strcmp(op, ">=") == 0)
+        return "setge";
+    if (strcmp(op, "==") == 0)
+        return "sete";
+    return "setne";
+}
+
+// The setcc for a float comparison after "ucomiss arg2, arg1", which sets
+// the flags the way an unsigned compare does
+static const char *x86FloatSetInstruction(const char *op)
+{
+    if (strcmp(op, "<") == 0)
+        return "setb";
+    if (strcmp(op, "<=") == 0)
+        return "setbe";
+    if (strcmp(op, ">") == 0)
+        return "seta";
+    if (strcmp(op, ">=") == 0)
+        return "setae";
+    if (strcmp(op, "==") == 0)
+        return "sete";
+    return "setne";
+}
+
+// Register for an instruction's result, reusing the one already mapped
+static const char *getResultRegister(const char *result)
+{
+    const char *reg = getRegisterForVariable(result);
+    if (!reg)
+    {
+        reg = allocateRegister();
+        if (!reg)
+        {
+            fprintf(stderr, "Error: No available registers for result %s\n", result);
+            abortCompilation();
+        }
+        setRegisterForVariable(result, reg);
+    }
+    return reg;
+}
+
+// Lower one TAC instruction to x86-64, using the same register allocation
+// decisions as the MIPS backend
+static TAC *lowerX86Instruction(TAC *current, SymbolTable *symTab)
+{
+    FILE *out = codeGeneratorOutput();
+    const char *op = current->op;
+
+    if (getComparisonInstruction(op) != NULL &&
+        (isFloatOperand(current->arg1, symTab) || isFloatOperand(current->arg2, symTab)))
+    {
+        // Either side is a float: compare as floats, converting an int side
+        fprintf(out, "# Generating x86-64 code for float comparison %s\n", op);
+        const char *reg1 = getFloatOperand(current->arg1, "$f16", symTab);
+        const char *reg2 = getFloatOperand(current->arg2, "$f18", symTab);
+        const char *resultReg = allocateRegister();
+        if (!resultReg)
+        {
+            fprintf(stderr, "Error: No available registers for result %s\n", current->result);
+            abortCompilation();
+        }
+        setRegisterForVariable(current->result, resultReg);
+        fprintf(out, "\tucomiss %s, %s\n", reg32(reg2), reg32(reg1));
+        fprintf(out, "\t%s %%al\n", x86FloatSetInstruction(op));
+        fprintf(out, "\tmovzbl %%al, %s\n", reg32(resultReg));
+    }
+    else if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0 || strcmp(op, "*") == 0 || strcmp(op, "/") == 0 ||
+        getComparisonInstruction(op) != NULL)
+    {
+        fprintf(out, "# Generating x86-64 code for operation %s\n", op);
+        const char *reg1 = getOperandRegister(current->arg1);
+        const char *reg2 = getOperandRegister(current->arg2);
+        const char *resultReg = allocateRegister();
+        if (!resultReg)
+        {
+            fprintf(stderr, "Error: No available registers for result %s\n", current->result);
+            abortCompilation();
+        }
+        setRegisterForVariable(current->result, resultReg);
+
+        if (strcmp(op, "/") == 0)
+        {
+            fprintf(out, "\tmovl %s, %%eax\n", reg32(reg1));
+            fprintf(out, "\tcltd\n");
+            fprintf(out, "\tidivl %s\n", reg32(reg2));
+            fprintf(out, "\tmovl %%eax, %s\n", reg32(resultReg));
+        }
+        else if (getComparisonInstruction(op) != NULL)
+        {
+            fprintf(out, "\tcmpl %s, %s\n", reg32(reg2), reg32(reg1));
+            fprintf(out, "\t%s %%al\n", x86SetInstruction(op));
+            fprintf(out, "\tmovzbl %%al, %s\n", reg32(resultReg));
+        }
+        else
+        {
+            const char *instr = op[0] == '+' ? "addl" : op[0] == '-' ? "subl" : "imull";
+            fprintf(out, "\tmovl %s, %s\n", reg32(reg1), reg32(resultReg));
+            fprintf(out, "\t%s %s, %s\n", instr, reg32(reg2), reg32(resultReg));
+        }
+    }
+    else if (strcmp(op, "fadd") == 0 || strcmp(op, "fsub") == 0 ||
+             strcmp(op, "fmul") == 0 || strcmp(op, "fdiv") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for operation %s\n", op);
+        const char *reg1 = getFloatOperand(current->arg1, "$f16", symTab);
+        const char *reg2 = getFloatOperand(current->arg2, "$f18", symTab);
+        const char *resultReg = allocateFloatRegister();
+        if (!resultReg)
+        {
+            fprintf(stderr, "Error: No available registers for result %s\n", current->result);
+            abortCompilation();
+        }
+        setRegisterForVariable(current->result, resultReg);
+        // "fadd" becomes "addss" and so on
+        fprintf(out, "\tmovaps %s, %s\n", reg32(reg1), reg32(resultReg));
+        fprintf(out, "\t%sss %s, %s\n", op + 1, reg32(reg2), reg32(resultReg));
+    }
+    else if (strcmp(op, "label") == 0)
+    {
+        spillAllRegisters();
+        fprintf(out, "%s:\n", current->result);
+    }
+    else if (strcmp(op, "goto") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for jump\n");
+        spillAllRegisters();
+        fprintf(out, "\tjmp %s\n", current->result);
+    }
+    else if (strcmp(op, "ifFalse") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for conditional branch\n");
+        loadOperand(current->arg1, "$t9");
+        spillAllRegisters();
+        fprintf(out, "\ttestl %s, %s\n", reg32("$t9"), reg32("$t9"));
+        fprintf(out, "\tje %s\n", current->result);
+    }
+    else if (strcmp(op, "=") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for assignment\n");
+        bool holdsFloat = isFloatOperand(current->arg1, symTab);
+        const char *srcReg = getOperandRegister(current->arg1);
+        const char *destReg = getResultRegister(current->result);
+        x86MoveRegister(destReg, srcReg);
+        setFloatBitsForVariable(current->result, holdsFloat);
+    }
+    else if (strcmp(op, "fmov") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for float assignment\n");
+        const char *srcReg = getFloatOperand(current->arg1, "$f16", symTab);
+        x86StoreHome(srcReg, current->result);
+    }
+    else if (strcmp(op, "write") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for write operation\n");
+        const char *srcReg = getRegisterForVariable(current->arg1);
+        if (!srcReg)
+            loadOperand(current->arg1, "$a0");
+        else
+            x86MoveRegister("$a0", srcReg);
+        fprintf(out, "\tcall cmm_write_int\n");
+    }
+    else if (strcmp(op, "write_float") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for write_float operation\n");
+        const char *srcReg = getFloatOperand(current->arg1, "$f16", symTab);
+        fprintf(out, "\tmovaps %s, %%xmm15\n", reg32(srcReg));
+        fprintf(out, "\tcall cmm_write_float\n");
+    }
+    else if (strcmp(op, "[]=") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for array assignment\n");
+        fprintf(out, "\tleaq %s(%%rip), %s\n", current->result, reg64("$t8"));
+        char *offsetValue = computeOffset(current->arg1, 4);
+        if (offsetValue != NULL)
+        {
+            const char *valueReg = getOperandRegister(current->arg2);
+            fprintf(out, "\t%s %s, %s(%s)\n", isXmm(valueReg) ? "movss" : "movl", reg32(valueReg), offsetValue, reg64("$t8"));
+            free(offsetValue);
+        }
+        else
+        {
+            const char *indexReg = getOperandRegister(current->arg1);
+            const char *valueReg = getOperandRegister(current->arg2);
+            fprintf(out, "\tmovslq %s, %s\n", reg32(indexReg), reg64("$t9"));
+            fprintf(out, "\t%s %s, (%s,%s,4)\n", isXmm(valueReg) ? "movss" : "movl", reg32(valueReg), reg64("$t8"), reg64("$t9"));
+        }
+    }
+    else if (strcmp(op, "=[]") == 0)
+    {
+        fprintf(out, "# Generating x86-64 code for array access\n");
+        fprintf(out, "\tleaq %s(%%rip), %s\n", current->arg1, reg64("$t8"));
+        char *offsetValue = computeOffset(current->arg2, 4);
+        if (offsetValue != NULL)
+        {
+            const char *resultReg = getResultRegister(current->result);
+            fprintf(out, "\tmovl %s(%s), %s\n", offsetValue, reg64("$t8"), reg32(resultReg));
+            free(offsetValue);
+        }
+        else
+        {
+            const char *indexReg = getOperandRegister(current->arg2);
+            fprintf(out, "\tmovslq %s, %s\n", reg32(indexReg), reg64("$t9"));
+            const char *resultReg = getResultRegister(current->result);
+            fprintf(out, "\tmovl (%s,%s,4), %s\n", reg64("$t8"), reg64("$t9"), reg32(resultReg));
+        }
+        Symbol *array = findSymbol(symTab, current->arg1);
+        setFloatBitsForVariable(current->result, array != NULL && array->arrayInfo != NULL && array->arrayInfo->isFloat);
+    }
+    else
+    {
+        fprintf(stderr, "Warning: Unsupported TAC operation '%s'\n", op);
+    }
+    return current;
+}
+
+const CodeGenTarget x86Target = {
+    "x86-64",
+    ".long",
+    x86TextPrologue,
+    x86TextEpilogue,
+    lowerX86Instruction,
+    x86StoreHome,
+    x86StoreSpill,
+    x86LoadHome,
+    x86LoadSpill,
+    x86LoadImmediate,
+    x86LoadFloatImmediate,
+    x86MoveRegister,
+    x86ConvertIntToFloat,
+};
@@ -0,0 +1,13 @@
+// x86Generator.h
+
+#ifndef X86_GENERATOR_H
+#define X86_GENERATOR_H
+
+#include "codeGenerator.h"
+
+// x86-64 backend: GNU assembler (AT&T syntax) for Linux, linked against
+// libc, whose printf the small runtime for write and write_float calls.
+// Build the output with "cc -o program output.s".
+extern const CodeGenTarget x86Target;
+
+#endif // X86_GENERATOR_H